@@ -0,0 +1,98 @@
+// Dual-clock FIFO with first-word fall-through on the read side.
+//
+// Write and read pointers are kept in Gray code and cross to the other clock
+// through two-flop synchronizers, so only one bit of a crossing pointer
+// changes per increment. Full and empty are computed from the synchronized
+// (late) copy of the other side's pointer: both are pessimistic, never
+// wrong. wr_used is the write side's count of entries not yet known to be
+// read, so wr_used <= DEPTH - n guarantees room for n more pushes.
+//
+// Each side is reset by its own synchronous, active-low reset; both must be
+// asserted together (gemma_accelerator derives them from ap_rst_n).
+module async_fifo #(
+    parameter DATA_WIDTH = 128,
+    parameter DEPTH = 16,                   // Power of two, 4 or more
+    parameter ADDR_WIDTH = $clog2(DEPTH)
+)(
+    // Write side
+    input  wire                     wr_clk,
+    input  wire                     wr_rst_n,
+    input  wire                     wr_en,
+    input  wire [DATA_WIDTH-1:0]    wr_data,
+    output wire                     wr_full,
+    output wire [ADDR_WIDTH:0]      wr_used,
+
+    // Read side
+    input  wire                     rd_clk,
+    input  wire                     rd_rst_n,
+    input  wire                     rd_en,
+    output wire [DATA_WIDTH-1:0]    rd_data,
+    output wire                     rd_empty
+);
+
+    reg [DATA_WIDTH-1:0] memory [0:DEPTH-1];
+
+    reg [ADDR_WIDTH:0] wr_bin, wr_gray;
+    reg [ADDR_WIDTH:0] rd_bin, rd_gray;
+    (* ASYNC_REG = "TRUE" *) reg [ADDR_WIDTH:0] rd_gray_w1, rd_gray_w2;  // rd_gray in wr_clk
+    (* ASYNC_REG = "TRUE" *) reg [ADDR_WIDTH:0] wr_gray_r1, wr_gray_r2;  // wr_gray in rd_clk
+
+    function [ADDR_WIDTH:0] gray_to_bin;
+        input [ADDR_WIDTH:0] g;
+        integer b;
+        begin
+            gray_to_bin[ADDR_WIDTH] = g[ADDR_WIDTH];
+            for (b = ADDR_WIDTH - 1; b >= 0; b = b - 1)
+                gray_to_bin[b] = gray_to_bin[b + 1] ^ g[b];
+        end
+    endfunction
+
+    wire [ADDR_WIDTH:0] wr_bin_next = wr_bin + 1'b1;
+    wire [ADDR_WIDTH:0] rd_bin_next = rd_bin + 1'b1;
+
+    // Full: the write pointer is one lap ahead of the read pointer
+    assign wr_full  = (wr_gray == {~rd_gray_w2[ADDR_WIDTH:ADDR_WIDTH-1], rd_gray_w2[ADDR_WIDTH-2:0]});
+    assign wr_used  = wr_bin - gray_to_bin(rd_gray_w2);
+    assign rd_empty = (rd_gray == wr_gray_r2);
+    assign rd_data  = memory[rd_bin[ADDR_WIDTH-1:0]];
+
+    // Write side
+    always @(posedge wr_clk) begin
+        if (wr_en && !wr_full)
+            memory[wr_bin[ADDR_WIDTH-1:0]] <= wr_data;
+    end
+
+    always @(posedge wr_clk) begin
+        if (!wr_rst_n) begin
+            wr_bin     <= 0;
+            wr_gray    <= 0;
+            rd_gray_w1 <= 0;
+            rd_gray_w2 <= 0;
+        end else begin
+            rd_gray_w1 <= rd_gray;
+            rd_gray_w2 <= rd_gray_w1;
+            if (wr_en && !wr_full) begin
+                wr_bin  <= wr_bin_next;
+                wr_gray <= wr_bin_next ^ (wr_bin_next >> 1);
+            end
+        end
+    end
+
+    // Read side
+    always @(posedge rd_clk) begin
+        if (!rd_rst_n) begin
+            rd_bin     <= 0;
+            rd_gray    <= 0;
+            wr_gray_r1 <= 0;
+            wr_gray_r2 <= 0;
+        end else begin
+            wr_gray_r1 <= wr_gray;
+            wr_gray_r2 <= wr_gray_r1;
+            if (rd_en && !rd_empty) begin
+                rd_bin  <= rd_bin_next;
+                rd_gray <= rd_bin_next ^ (rd_bin_next >> 1);
+            end
+        end
+    end
+
+endmodule
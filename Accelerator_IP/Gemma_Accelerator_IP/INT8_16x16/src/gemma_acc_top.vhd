@@ -4,8 +4,11 @@ use IEEE.NUMERIC_STD.ALL;
 
 
 entity Accelerator_Top is
+    Generic ( ARRAY_SIZE    : integer := 16;    -- PE grid: 8, 16, 32 or 64 (reported in ACC_ID)
+              ASYNC_COMPUTE : integer := 0 );   -- 1: array runs on compute_aclk
     Port (  s_axi_aclk 			: 	in 	  STD_LOGIC;                                    
 			s_axi_aresetn 		: 	in 	  STD_LOGIC;                                                      
+			compute_aclk 		: 	in 	  STD_LOGIC := '0';  -- Array clock, used when ASYNC_COMPUTE = 1
 		      
 			----- Master Write Address Channel ------  	                
     		m_axi_awvalid		: out std_logic;
@@ -103,12 +106,15 @@ architecture Accelerator_Top_a of Accelerator_Top is
    
     COMPONENT gemma_accelerator
       GENERIC (
-        ID_WIDTH : integer := 12
+        ID_WIDTH   : integer := 12;
+        ARRAY_SIZE : integer := 16;
+        ASYNC_COMPUTE : integer := 0
       );
       PORT (
         -- Clock / Reset
         ap_clk   : IN  std_logic;
         ap_rst_n : IN  std_logic;
+        compute_clk : IN  std_logic;
         -- AXI-Lite control
         s_axi_control_awvalid : IN  std_logic;
         s_axi_control_awready : OUT std_logic;
@@ -231,12 +237,15 @@ begin
     ------------------------------------------------------------------------
     inst_gemma_accel : gemma_accelerator
       GENERIC MAP (
-        ID_WIDTH => 12
+        ID_WIDTH   => 12,
+        ARRAY_SIZE => ARRAY_SIZE,
+        ASYNC_COMPUTE => ASYNC_COMPUTE
       )
       PORT MAP (
         -- Clock / Reset
         ap_clk   => s_axi_aclk,
         ap_rst_n => s_axi_aresetn,
+        compute_clk => compute_aclk,
 
         -- AXI-Lite control (width converted)
         s_axi_control_awvalid => s_axi_awvalid,
@@ -1,14 +1,30 @@
 
+// One top for every array size: ARRAY_SIZE (8, 16, 32 or 64) sets the PE
+// grid, and burst lengths, buffer depths and writeback beat counts are
+// derived from it. The 128-bit AXI beat carries 16 operands or 4 results.
+// Read ACC_ID for the build configuration.
+//
+// The PE grid, its operand tiles and the result packing (gemma_compute_core)
+// run on compute_clk when ASYNC_COMPUTE = 1, so the array can be clocked
+// above the AXI interconnect. Operand beats go in and result beats come out
+// through async FIFOs; the AXI engines, registers and weight cache stay on
+// ap_clk. With ASYNC_COMPUTE = 0 the core runs on ap_clk and compute_clk is
+// unused.
 module gemma_accelerator #(
   parameter integer ID_WIDTH = 12,
-  parameter integer BUFFER_DEPTH = 20,
+  parameter integer ARRAY_SIZE = 16,       // PE grid is ARRAY_SIZE x ARRAY_SIZE: 8, 16, 32 or 64
+  parameter integer BUFFER_DEPTH = ARRAY_SIZE * ((ARRAY_SIZE + 15) / 16) + 4,
   parameter integer BUFFER_ADDR_WIDTH = $clog2(BUFFER_DEPTH),
-  parameter integer SYSTOLIC_SIZE = 16,
+  parameter integer WGT_CACHE_TILES = 8,   // Weight cache slots in weight_buffer (power of two, 2..64)
   parameter integer DATA_WIDTH = 8,
-  parameter integer ACCUM_WIDTH = 32
+  parameter integer ACCUM_WIDTH = 32,
+  parameter integer DUAL_MAC = 0,          // 1: pe_int8x2 pairs (experimental, DSP saving not synthesized)
+  parameter integer ASYNC_COMPUTE = 0      // 1: array on compute_clk, any ratio to ap_clk
 )(
   input  wire                  ap_clk,
   input  wire                  ap_rst_n,
+  input  wire                  compute_clk,  // Array clock (ASYNC_COMPUTE = 1)
+  output reg                   interrupt,    // Level: INT_GIE on and an enabled INT_STATUS bit set
   // AXI-Lite Control Interface
   input  wire                  s_axi_control_awvalid,
   output wire                  s_axi_control_awready,
@@ -75,11 +91,23 @@ module gemma_accelerator #(
     S_WRITE_OUT_ADDR   = 4'd6,
     S_WRITE_OUT_DATA   = 4'd7,
     S_WAIT_WRITE_END   = 4'd8,
-    S_DONE             = 4'd9;
+    S_DONE             = 4'd9,
+    S_LOAD_WGT_CACHE   = 4'd10,  // Copy a cached weight tile from weight_buffer into the array feed
+    S_DESC_ADDR        = 4'd11,  // Ring: request the descriptor at RING_HEAD
+    S_DESC_DATA        = 4'd12,  // Ring: load it into the run registers
+    S_HEAD_WB_ADDR     = 4'd13,  // Ring: write the new head to RING_WB
+    S_HEAD_WB_DATA     = 4'd14,
+    S_HEAD_WB_RESP     = 4'd15;
 
 localparam [7:0]
   // existing control/status + pointers
   ADDR_CTRL   = 8'h00,  ADDR_STATUS = 8'h00,
+
+  // Completion interrupt (ID_VERSION 3), at the Vitis HLS ap_ctrl offsets.
+  // Written at any time, like the RING_TAIL doorbell.
+  INT_GIE     = 8'h04,  // bit0: global enable of the interrupt output
+  INT_ENABLE  = 8'h08,  // Per-source enables, bits as in INT_STATUS
+  INT_STATUS  = 8'h0C,  // bit0 run done, bit1 ring drained, bit2 error; write 1 to clear
   A_LSB       = 8'h10,  A_MSB       = 8'h14,
   B_LSB       = 8'h1C,  B_MSB       = 8'h20,
   C_LSB       = 8'h28,  C_MSB       = 8'h2C,
@@ -93,20 +121,134 @@ localparam [7:0]
   DBG_AXI_RDATA2  = 8'h44,  // read:  debug_last_rdata[95:64]
   DBG_AXI_RDATA3  = 8'h48,  // read:  debug_last_rdata[127:96]
   DBG_AXI_ADDR    = 8'h4C,  // read:  debug_last_addr
-  DBG_AXI_BEAT    = 8'h50;  // read:  {24'd0, debug_beat_count}
+  DBG_AXI_BEAT    = 8'h50,  // read:  {24'd0, debug_beat_count}
+
+  // Row pitch in bytes (0 = dense). Multiples of 16; keep C rows inside a 4KB page.
+  LDA             = 8'h54,  // A row pitch (dense: ARRAY_SIZE)
+  LDB             = 8'h58,  // B row pitch (dense: ARRAY_SIZE)
+  LDC             = 8'h5C,  // C row pitch (dense: 4 * ARRAY_SIZE)
+  ROWS            = 8'h60,  // Valid A/C rows (0 = all ARRAY_SIZE); short tiles for GEMV/decode
+
+  // Free-running AXI beat counters (read-only, wrap; host takes deltas)
+  PERF_ACT_BEATS  = 8'h64,  // A read beats
+  PERF_WGT_BEATS  = 8'h68,  // B read beats
+  PERF_OUT_BEATS  = 8'h6C,  // C write beats
+  PERF_WGT_REUSE  = 8'h70,  // Runs that skipped the weight fetch
+
+  // Weight cache
+  WCACHE_CTRL     = 8'h74,  // W: bit0 invalidate all, bit1 unpin all, bit2 invalidate unpinned / R: number of slots
+  WCACHE_HITS     = 8'h78,  // Reuse runs whose weight tile was on chip
+  WCACHE_MISSES   = 8'h7C,  // Reuse runs that fetched the weight tile from memory
+
+  // Build configuration (read-only)
+  ACC_ID          = 8'h80,  // {8'h47, ARRAY_SIZE, WGT_CACHE_TILES, ID_VERSION, 2'd0, ASYNC_COMPUTE, DUAL_MAC}
+
+  // Descriptor ring in DDR (ID_VERSION 2). Each entry is 64 bytes, see below.
+  RING_BASE_LO    = 8'h84,  // Ring base address (64-byte aligned)
+  RING_BASE_HI    = 8'h88,
+  RING_SIZE       = 8'h8C,  // Entries (0 = no ring); a write also clears HEAD, TAIL and the ring error
+  RING_TAIL       = 8'h90,  // Doorbell: index of the next entry the host will fill (accepted while busy)
+  RING_HEAD       = 8'h94,  // R: index of the next entry to complete
+  RING_WB_LO      = 8'h98,  // Address HEAD is written to after every entry (0 = not written)
+  RING_WB_HI      = 8'h9C;
+
+  // Descriptor, 64 bytes little endian (only the first 48 are read):
+  //   0x00 A address   0x08 B address   0x10 C address
+  //   0x18 LDA  0x1C LDB  0x20 LDC  0x24 ROWS
+  //   0x28 CTRL mode bits (1, 4-7 as in the CTRL register; bit 0 is ignored)
+  // An entry runs exactly as if its fields had been written to the registers
+  // and CTRL started. The ring is empty when HEAD == TAIL; entries are
+  // consumed in order and HEAD wraps to 0 at RING_SIZE.
+  localparam integer DESC_BEATS = 3;
+
+  // Older builds read 0xDEADBEEF at ACC_ID, so the signature byte tells them apart
+  localparam [7:0]  ID_SIGNATURE = 8'h47;  // 'G'
+  localparam [3:0]  ID_VERSION   = 4'd3;  // 2: descriptor ring, 3: completion interrupt
+  localparam [7:0]  ID_SIZE      = ARRAY_SIZE;
+  localparam [7:0]  ID_WC_SLOTS  = WGT_CACHE_TILES;
+  localparam [31:0] ACC_ID_VALUE = {ID_SIGNATURE, ID_SIZE, ID_WC_SLOTS, ID_VERSION, 2'd0,
+                                   ASYNC_COMPUTE != 0, DUAL_MAC != 0};
+
+  // Tile geometry on the 128-bit bus. A dense operand tile is one burst; a
+  // strided operand row is IN_ROW_BEATS beats (rows narrower than a beat use
+  // its low lanes). A dense C tile is split into bursts of at most 256 beats
+  // (the AXI4 INCR limit, 4 KB).
+  localparam integer BUS_BYTES      = 16;
+  localparam integer SIZE_W         = $clog2(ARRAY_SIZE + 1);
+  localparam integer IN_ROW_BEATS   = (ARRAY_SIZE + BUS_BYTES - 1) / BUS_BYTES;
+  localparam integer IN_TILE_BEATS  = ARRAY_SIZE * ARRAY_SIZE / BUS_BYTES;
+  localparam integer OUT_ROW_BEATS  = ARRAY_SIZE * 4 / BUS_BYTES;
+  localparam integer OUT_TILE_BEATS = ARRAY_SIZE * OUT_ROW_BEATS;
+  localparam integer OUT_BURST_ROWS = (OUT_TILE_BEATS > 256) ? 256 / OUT_ROW_BEATS : ARRAY_SIZE;
+  localparam integer BEAT_W         = (OUT_TILE_BEATS > 128) ? $clog2(OUT_TILE_BEATS) + 1 : 8;
 
 
   reg [3:0]   current_state, next_state;
-  reg [7:0]   beat_counter;
+  reg [BEAT_W-1:0] beat_counter;
   reg [63:0]  addr_a_reg, addr_b_reg, addr_c_reg;
+  reg [31:0]  lda_reg, ldb_reg, ldc_reg;
+  reg [SIZE_W-1:0] rows_reg;
+  reg [SIZE_W-1:0] burst_row;    // First row of the current burst (per-row bursts, split C writes)
+  reg [SIZE_W-1:0] ar_row_a;     // Read requests issued for A / B this run (one for a dense operand)
+  reg [SIZE_W-1:0] ar_row_b;
+  reg [SIZE_W-1:0] c_bresp_pending;  // C bursts whose write response is still outstanding
   reg         start_pulse;
   reg         accelerator_done;  // FIXED: Add done signal
+  reg         axi_error;         // Sticky: any non-OKAY RRESP/BRESP during this run
+  reg         trans_a, trans_b;  // CTRL[4]/CTRL[5]: operand is stored transposed
+  reg         reuse_b;           // CTRL[6]: keep the resident weight tile if it still matches
+
+  // Weight-stationary reuse: the unpacked weight tile is tagged with the
+  // address and pitch it was fetched from
+  reg         wgt_valid, wgt_fetch_err, wgt_hit;
+  reg [63:0]  wgt_tag_addr;
+  reg [31:0]  wgt_tag_ldb;
+
+  reg [31:0]  perf_act_beats, perf_wgt_beats, perf_out_beats, perf_wgt_reuse;
+
+  // Multi-tile weight cache: weight_buffer holds WGT_CACHE_TILES tiles, each
+  // tagged with the B address and pitch it was fetched from. A miss fills the
+  // next unpinned slot (round robin); a hit is replayed from BRAM to
+  // the compute core instead of being fetched over AXI.
+  localparam integer WGT_TILE_BEATS = ARRAY_SIZE * IN_ROW_BEATS;  // Slot size: a dense or a strided tile
+  localparam integer WC_DEPTH       = WGT_CACHE_TILES * WGT_TILE_BEATS;
+  localparam integer WC_AW          = $clog2(WC_DEPTH);
+  localparam integer WC_SLOT_W      = $clog2(WGT_CACHE_TILES);
+
+  reg         preload_b;         // CTRL[1]: fetch B into the cache only (no A, compute or C)
+  reg         pin_b;             // CTRL[7]: pin this run's weight tile in the cache
+  reg         wc_inval_pulse, wc_unpin_pulse, wc_drop_pulse;
+  reg [63:0]  wc_tag_addr [0:WGT_CACHE_TILES-1];
+  reg [31:0]  wc_tag_ldb  [0:WGT_CACHE_TILES-1];
+  reg [WGT_CACHE_TILES-1:0] wc_valid, wc_pinned;
+  reg [WC_SLOT_W-1:0] wc_next;   // Replacement pointer
+  reg [WC_SLOT_W-1:0] wc_slot;   // Slot hit, or slot filled on a miss
+  reg         wc_hit;            // This run's weight tile is cached (reuse runs only)
+  reg         wc_fill;           // This run's weight fetch is written into wc_slot
+  reg [BEAT_W-1:0] wc_beat;      // S_LOAD_WGT_CACHE: beats read from weight_buffer
+  reg         wc_rd_v1, wc_rd_v2;          // Read pipeline (BRAM data follows two cycles later)
+  reg [BEAT_W-1:0] wc_rd_beat1, wc_rd_beat2;
+  reg [31:0]  perf_wc_hits, perf_wc_misses;
 
   // AXI-Lite write buffer
   reg         awvalid_seen, wvalid_seen;
   reg [7:0]   awaddr_latched;
   reg [31:0]  wdata_latched;
 
+  // Descriptor ring
+  reg [63:0]  ring_base, ring_wb_addr;
+  reg [15:0]  ring_size, ring_tail, ring_head;
+  reg         ring_reset_pulse;
+  reg         ring_run;          // The run in progress was started from a descriptor
+  reg         ring_error;        // Sticky: an entry saw a non-OKAY response since RING_SIZE was written
+  reg [1:0]   desc_beat;
+  reg         desc_err;          // This descriptor fetch returned an error; the entry is skipped
+
+  // Completion interrupt: sources latch into int_status until written back as 1
+  localparam integer INT_SOURCES = 3;
+  reg                    int_gie;
+  reg [INT_SOURCES-1:0]  int_enable, int_status;
+
   // Buffer control signals for activation buffer (INT8, 128-bit width = 16 values)
   reg                           act_buf_wr_en;
   reg [BUFFER_ADDR_WIDTH-1:0]   act_buf_wr_addr;
@@ -116,36 +258,36 @@ localparam [7:0]
 
   // Buffer control signals for weight buffer (INT8, 128-bit width = 16 values)
   reg                           wgt_buf_wr_en;
-  reg [BUFFER_ADDR_WIDTH-1:0]   wgt_buf_wr_addr;
+  reg [WC_AW-1:0]               wgt_buf_wr_addr;
   reg [127:0]                   wgt_buf_wr_data;
-  reg [BUFFER_ADDR_WIDTH-1:0]   wgt_buf_rd_addr;
+  reg [WC_AW-1:0]               wgt_buf_rd_addr;
   wire [127:0]                  wgt_buf_rd_data;
 
-  // Matrix data storage - unpacked from buffers for easier indexing
-  reg signed [DATA_WIDTH-1:0]   activation_matrix [0:SYSTOLIC_SIZE-1][0:SYSTOLIC_SIZE-1];
-  reg signed [DATA_WIDTH-1:0]   weight_matrix [0:SYSTOLIC_SIZE-1][0:SYSTOLIC_SIZE-1];
-
-  // Systolic Array signals
-  reg                           systolic_accum_reset;
-  reg signed [DATA_WIDTH-1:0]   systolic_north_inputs [0:SYSTOLIC_SIZE-1];
-  reg signed [DATA_WIDTH-1:0]   systolic_west_inputs [0:SYSTOLIC_SIZE-1];
-  reg [SYSTOLIC_SIZE-1:0]       systolic_north_valid;
-  reg [SYSTOLIC_SIZE-1:0]       systolic_west_valid;
-  wire signed [SYSTOLIC_SIZE*SYSTOLIC_SIZE*ACCUM_WIDTH-1:0] systolic_results;
-
-  // FIXED: Separate counters for proper timing control
-  reg [7:0]                     systolic_cycle_count;
-  reg [7:0]                     input_cycle_count;
-  reg                           systolic_computing;
-  reg                           matrices_loaded;
-  reg                           activation_loaded;
-  reg                           weight_loaded;
-
-  // Result management
-  reg signed [ACCUM_WIDTH-1:0]  result_matrix [0:SYSTOLIC_SIZE-1][0:SYSTOLIC_SIZE-1];
-  reg [127:0]                   output_data_buffer [0:63];
-  reg [4:0]                     output_buffer_idx;
-  reg                           capture_results;
+  // Clock-domain crossing to gemma_compute_core. Operand entries are
+  // {kind, beat, 128-bit payload}; the core drains them at least as fast as
+  // the bus fills them, so a few entries of depth cover the sync latency.
+  localparam integer OP_W           = 2 + BEAT_W + 128;
+  localparam integer OP_FIFO_DEPTH  = 16;
+  localparam integer RES_FIFO_DEPTH = 16;
+  localparam [1:0]   OP_A = 2'd0, OP_B = 2'd1, OP_START = 2'd2, OP_RUN = 2'd3;
+
+  wire                          core_clk;
+  (* ASYNC_REG = "TRUE" *)
+  reg   [1:0]                   core_rst_sync;        // ap_rst_n, released on core_clk
+  wire                          core_rst_n = core_rst_sync[1];
+
+  reg                           op_push;
+  reg   [OP_W-1:0]              op_wdata;
+  wire                          op_full;
+  wire  [$clog2(OP_FIFO_DEPTH):0] op_used;
+  wire  [OP_W-1:0]              op_rdata;
+  wire                          op_empty, op_pop;
+  wire                          op_room3 = (op_used <= OP_FIFO_DEPTH - 3);  // Cache replay: 2 reads in flight
+  reg                           op_start_pending;     // OP_START not yet pushed for this run
+  reg                           op_run_sent;          // OP_RUN pushed for this run
+
+  wire  [127:0]                 res_wdata, res_rdata;
+  wire                          res_push, res_full, res_empty, res_pop;
 
   // Debug registers for AXI transaction analysis
   reg [127:0] debug_last_rdata;
@@ -165,6 +307,81 @@ reg [15:0]  wstrb_reg;
 wire [7:0] awaddr_word = {awaddr_latched[7:2], 2'b00};
 wire [7:0] araddr_word = {s_axi_control_araddr[7:2], 2'b00};
 
+  // Dense operands are fetched in one burst and C is written in bursts of
+  // OUT_BURST_ROWS rows. A strided operand is moved as one burst per row
+  // (IN_ROW_BEATS beats for A/B, OUT_ROW_BEATS for C) at base + row * pitch.
+  localparam [31:0] DENSE_IN_PITCH  = ARRAY_SIZE,
+                    DENSE_OUT_PITCH = ARRAY_SIZE * 4;
+
+  wire [31:0] lda_eff   = (lda_reg == 32'd0) ? DENSE_IN_PITCH  : lda_reg;
+  wire [31:0] ldb_eff   = (ldb_reg == 32'd0) ? DENSE_IN_PITCH  : ldb_reg;
+  wire [31:0] ldc_eff   = (ldc_reg == 32'd0) ? DENSE_OUT_PITCH : ldc_reg;
+  wire        a_strided = (lda_eff != DENSE_IN_PITCH);
+  wire        b_strided = (ldb_eff != DENSE_IN_PITCH);
+  wire        c_strided = (ldc_eff != DENSE_OUT_PITCH);
+
+  // Operand bytes per beat: lane l of beat n is element n * bytes + l of the
+  // row-major tile (a strided row narrower than a beat fills one beat)
+  wire [4:0]  a_beat_bytes = (a_strided && ARRAY_SIZE < BUS_BYTES) ? ARRAY_SIZE : BUS_BYTES;
+  wire [4:0]  b_beat_bytes = (b_strided && ARRAY_SIZE < BUS_BYTES) ? ARRAY_SIZE : BUS_BYTES;
+  wire [BEAT_W-1:0] b_tile_beats = b_strided ? WGT_TILE_BEATS : IN_TILE_BEATS;
+
+  // ROWS < ARRAY_SIZE: only the first ROWS rows of A are fetched (the rest
+  // read as zero) and only the first ROWS rows of C are written. A transposed
+  // A is stored by K, so it is always fetched whole.
+  wire [SIZE_W-1:0] c_rows = (rows_reg == 0 || rows_reg > ARRAY_SIZE) ? ARRAY_SIZE : rows_reg;
+  wire [SIZE_W-1:0] a_rows = trans_a ? ARRAY_SIZE : c_rows;
+  wire        last_row_a = (burst_row == a_rows - 1);
+  wire        last_row_b = (burst_row == ARRAY_SIZE - 1);
+  wire [7:0]  a_dense_len = (a_rows * ARRAY_SIZE + BUS_BYTES - 1) / BUS_BYTES - 1;
+
+  // Read requests run ahead of the data: later rows of a strided operand, and
+  // then B's requests, are issued while earlier bursts are still returning,
+  // so the memory latency is paid once per run rather than once per burst.
+  // Every request uses the same ID, so data returns in request order and
+  // burst_row/beat_counter keep tracking it as before.
+  wire [SIZE_W-1:0] a_reqs     = a_strided ? a_rows : 1;
+  wire [SIZE_W-1:0] b_reqs     = b_strided ? ARRAY_SIZE : 1;
+  wire        ar_more_a  = (ar_row_a != a_reqs);
+  wire        ar_more_b  = (ar_row_b != b_reqs);
+  wire        fetch_b    = !wgt_hit && !wc_hit;  // This run reads B from memory after A
+  wire        ar_for_b   = (current_state == S_FETCH_WGT_ADDR) || (current_state == S_FETCH_WGT_DATA) ||
+                           (current_state == S_FETCH_ACT_DATA && !ar_more_a);
+  wire        ar_fire    = m_axi_gmem_arvalid && m_axi_gmem_arready;
+  wire        wgt_fetch_start = ar_fire && ar_for_b && (ar_row_b == 0);  // First B request of the run
+
+  // Operand beats are accepted only while op_fifo can take them
+  wire        op_ready    = !op_full && !op_start_pending;
+  wire        wc_rd_issue = (current_state == S_LOAD_WGT_CACHE) && (wc_beat < b_tile_beats) && op_room3;
+
+  // C bursts: rows [burst_row, burst_row + c_burst_rows), clipped to ROWS.
+  // Beat indices run over the C rows sent, in the order res_fifo returns them.
+  wire [SIZE_W-1:0] c_burst_rows = c_strided ? 1 : OUT_BURST_ROWS;
+  wire        last_burst_c  = (burst_row + c_burst_rows >= c_rows);
+  wire [SIZE_W:0]   c_burst_end_row = last_burst_c ? c_rows : burst_row + c_burst_rows;
+  wire [BEAT_W-1:0] c_burst_first_beat = burst_row * OUT_ROW_BEATS;
+  wire [BEAT_W-1:0] c_burst_last_beat  = c_burst_end_row * OUT_ROW_BEATS - 1;
+
+  // The ring is only entered from S_IDLE with no register write in progress,
+  // so a host write is never half applied under a descriptor's fields
+  wire        ring_pending   = (ring_size != 0) && (ring_head != ring_tail);
+  wire        lite_wr_busy   = s_axi_control_awvalid || awvalid_seen || wvalid_seen || ring_reset_pulse;
+  wire [15:0] ring_head_next = (ring_head == ring_size - 1) ? 16'd0 : ring_head + 1'b1;
+  wire        desc_beat_fire = (current_state == S_DESC_DATA) && m_axi_gmem_rvalid && m_axi_gmem_rready;
+  wire        desc_ok        = !desc_err && (m_axi_gmem_rresp == 2'b00);
+
+  // Interrupt sources, one cycle each. A run is done in S_DONE (a register
+  // launch, a ring entry or a bad descriptor); the ring is drained when the
+  // FSM is back in S_IDLE after an entry with HEAD at TAIL (after the HEAD
+  // write-back); an error is a run that saw a non-OKAY response or a failed
+  // HEAD write-back.
+  wire        int_ev_done    = (current_state == S_DONE);
+  wire        int_ev_ring    = (current_state == S_IDLE) && ring_run && !start_pulse && !ring_pending;
+  wire        int_ev_error   = (current_state == S_DONE && axi_error) ||
+                               ((current_state == S_HEAD_WB_DATA || current_state == S_HEAD_WB_RESP) &&
+                                m_axi_gmem_bvalid && m_axi_gmem_bready && m_axi_gmem_bresp != 2'b00);
+  wire [INT_SOURCES-1:0] int_events = {int_ev_error, int_ev_ring, int_ev_done};
+
   // Merge function to handle byte-wise writes
   function [31:0] merge_by_wstrb;
     input [31:0] oldw;
@@ -183,14 +400,10 @@ wire state_enter_write_data = (current_state == S_WRITE_OUT_ADDR) && m_axi_gmem_
 reg [7:0]   wbeats_sent;     // Debug counter for AXI write beats
 reg [7:0]   debug_wbeats_sent; // Snapshot for debug reading
 
-// Replace the existing write engine registers and logic:
-// Remove the old write engine regs (wvalid_reg, wlast_reg, wr_idx, wdata_reg, wstrb_reg)
-// Replace with this improved version:
+// Write engine: result beats come straight off the result FIFO
 
 reg         write_active;
-reg [7:0]   write_beat_count;
-reg [127:0] write_data_reg;
-reg         write_last_reg;
+reg [BEAT_W-1:0] write_beat_count;
 
   // Instantiate activation buffer (INT8, 128-bit width)
   accelerator_buffer #(
@@ -206,11 +419,11 @@ reg         write_last_reg;
     .rd_data(act_buf_rd_data)
   );
 
-  // Weight buffer for INT8 weights (128-bit width for 16 values)
+  // Weight cache: WGT_CACHE_TILES weight tiles of WGT_TILE_BEATS 128-bit beats
   accelerator_buffer #(
     .DATA_WIDTH(128),
-    .DEPTH(BUFFER_DEPTH),
-    .ADDR_WIDTH(BUFFER_ADDR_WIDTH)
+    .DEPTH(WC_DEPTH),
+    .ADDR_WIDTH(WC_AW)
   ) weight_buffer (
     .clk(ap_clk),
     .wr_en(wgt_buf_wr_en),
@@ -220,173 +433,348 @@ reg         write_last_reg;
     .rd_data(wgt_buf_rd_data)
   );
 
-  // Pack systolic inputs for module interface
-  wire signed [SYSTOLIC_SIZE*DATA_WIDTH-1:0] systolic_north_packed;
-  wire signed [SYSTOLIC_SIZE*DATA_WIDTH-1:0] systolic_west_packed;
-  
-  genvar g;
+  // Compute clock domain
   generate
-    for (g = 0; g < SYSTOLIC_SIZE; g = g + 1) begin : pack_inputs
-      assign systolic_north_packed[(g+1)*DATA_WIDTH-1:g*DATA_WIDTH] = systolic_north_inputs[g];
-      assign systolic_west_packed[(g+1)*DATA_WIDTH-1:g*DATA_WIDTH] = systolic_west_inputs[g];
+    if (ASYNC_COMPUTE) begin : g_core_clk
+      assign core_clk = compute_clk;
+    end else begin : g_core_clk
+      assign core_clk = ap_clk;
     end
   endgenerate
 
-  // Systolic Array instantiation with valid signals
-  systolic_array_16x16 #(
-    .SIZE(SYSTOLIC_SIZE),
+  always @(posedge core_clk or negedge ap_rst_n) begin
+    if (!ap_rst_n)
+      core_rst_sync <= 2'b00;
+    else
+      core_rst_sync <= {core_rst_sync[0], 1'b1};
+  end
+
+  // Operand entries: ap_clk -> core_clk
+  async_fifo #(
+    .DATA_WIDTH(OP_W),
+    .DEPTH(OP_FIFO_DEPTH)
+  ) op_fifo (
+    .wr_clk(ap_clk),
+    .wr_rst_n(ap_rst_n),
+    .wr_en(op_push),
+    .wr_data(op_wdata),
+    .wr_full(op_full),
+    .wr_used(op_used),
+    .rd_clk(core_clk),
+    .rd_rst_n(core_rst_n),
+    .rd_en(op_pop),
+    .rd_data(op_rdata),
+    .rd_empty(op_empty)
+  );
+
+  gemma_compute_core #(
+    .ARRAY_SIZE(ARRAY_SIZE),
     .DATA_WIDTH(DATA_WIDTH),
-    .ACCUM_WIDTH(ACCUM_WIDTH)
-  ) systolic_array_inst (
-    .clk(ap_clk),
-    .rst(~ap_rst_n),
-    .accum_reset(systolic_accum_reset),
-    .north_inputs(systolic_north_packed),
-    .west_inputs(systolic_west_packed),
-    .north_valid(systolic_north_valid),
-    .west_valid(systolic_west_valid),
-    .result_matrix(systolic_results)
+    .ACCUM_WIDTH(ACCUM_WIDTH),
+    .DUAL_MAC(DUAL_MAC),
+    .BEAT_W(BEAT_W),
+    .OP_W(OP_W)
+  ) compute_core (
+    .clk(core_clk),
+    .rst_n(core_rst_n),
+    .op_data(op_rdata),
+    .op_empty(op_empty),
+    .op_pop(op_pop),
+    .res_data(res_wdata),
+    .res_push(res_push),
+    .res_full(res_full)
+  );
+
+  // Result beats: core_clk -> ap_clk
+  async_fifo #(
+    .DATA_WIDTH(128),
+    .DEPTH(RES_FIFO_DEPTH)
+  ) res_fifo (
+    .wr_clk(core_clk),
+    .wr_rst_n(core_rst_n),
+    .wr_en(res_push),
+    .wr_data(res_wdata),
+    .wr_full(res_full),
+    .wr_used(),
+    .rd_clk(ap_clk),
+    .rd_rst_n(ap_rst_n),
+    .rd_en(res_pop),
+    .rd_data(res_rdata),
+    .rd_empty(res_empty)
   );
 
+  // Weight cache lookup on the programmed B address/pitch, and the next
+  // unpinned slot at or after wc_next for a fill
+  reg                 wc_lookup_hit, wc_victim_ok;
+  reg [WC_SLOT_W-1:0] wc_lookup_slot, wc_victim, wc_probe;
+  integer wc_i;
+  always @(*) begin
+    wc_lookup_hit  = 1'b0;
+    wc_lookup_slot = {WC_SLOT_W{1'b0}};
+    wc_victim_ok   = 1'b0;
+    wc_victim      = wc_next;
+    for (wc_i = WGT_CACHE_TILES - 1; wc_i >= 0; wc_i = wc_i - 1) begin
+      if (wc_valid[wc_i] && wc_tag_addr[wc_i] == addr_b_reg && wc_tag_ldb[wc_i] == ldb_eff) begin
+        wc_lookup_hit  = 1'b1;
+        wc_lookup_slot = wc_i;
+      end
+      wc_probe = wc_next + wc_i;
+      if (!wc_pinned[wc_probe]) begin
+        wc_victim_ok = 1'b1;
+        wc_victim    = wc_probe;
+      end
+    end
+  end
+
   // FIXED: State machine and counters with proper timing
   always @(posedge ap_clk) begin
     if (!ap_rst_n) begin
       current_state <= S_IDLE;
-      beat_counter <= 8'd0;
-      systolic_cycle_count <= 8'd0;
-      input_cycle_count <= 8'd0;
-      output_buffer_idx <= 5'd0;
-      systolic_computing <= 1'b0;
-      capture_results <= 1'b0;
-      matrices_loaded <= 1'b0;
-      activation_loaded <= 1'b0;
-      weight_loaded <= 1'b0;
+      beat_counter <= {BEAT_W{1'b0}};
+      burst_row <= {SIZE_W{1'b0}};
+      ar_row_a <= {SIZE_W{1'b0}};
+      ar_row_b <= {SIZE_W{1'b0}};
+      c_bresp_pending <= {SIZE_W{1'b0}};
+      op_start_pending <= 1'b0;
+      op_run_sent <= 1'b0;
+      wgt_valid <= 1'b0;
+      wgt_fetch_err <= 1'b0;
+      wgt_hit <= 1'b0;
+      wgt_tag_addr <= 64'd0;
+      wgt_tag_ldb <= 32'd0;
+      perf_act_beats <= 32'd0;
+      perf_wgt_beats <= 32'd0;
+      perf_out_beats <= 32'd0;
+      perf_wgt_reuse <= 32'd0;
+      perf_wc_hits <= 32'd0;
+      perf_wc_misses <= 32'd0;
+      wc_valid <= {WGT_CACHE_TILES{1'b0}};
+      wc_pinned <= {WGT_CACHE_TILES{1'b0}};
+      wc_next <= {WC_SLOT_W{1'b0}};
+      wc_slot <= {WC_SLOT_W{1'b0}};
+      wc_hit <= 1'b0;
+      wc_fill <= 1'b0;
+      wc_beat <= {BEAT_W{1'b0}};
+      wc_rd_v1 <= 1'b0;
+      wc_rd_v2 <= 1'b0;
+      wc_rd_beat1 <= {BEAT_W{1'b0}};
+      wc_rd_beat2 <= {BEAT_W{1'b0}};
+      for (wc_i = 0; wc_i < WGT_CACHE_TILES; wc_i = wc_i + 1) begin
+        wc_tag_addr[wc_i] <= 64'd0;
+        wc_tag_ldb[wc_i]  <= 32'd0;
+      end
       accelerator_done <= 1'b0;  // FIXED: Initialize done flag
-      
-      // Initialize debug registers
-      debug_last_rdata <= 128'd0;
-      debug_beat_count <= 8'd0;
-      debug_last_addr <= 32'd0;
+      axi_error <= 1'b0;
+      ring_head <= 16'd0;
+      ring_run <= 1'b0;
+      ring_error <= 1'b0;
     end else begin
       current_state <= next_state;
       
-      // Beat counter management
-      if ((current_state == S_FETCH_ACT_ADDR && m_axi_gmem_arready) ||
-          (current_state == S_FETCH_WGT_ADDR && m_axi_gmem_arready) ||
-          (current_state == S_WRITE_OUT_ADDR && m_axi_gmem_awready))
-        beat_counter <= 8'd0;
+      // Beat counter management (per-row bursts keep counting from the first row)
+      if ((burst_row == 0 &&
+           ((current_state == S_FETCH_ACT_ADDR && m_axi_gmem_arready) ||
+            (current_state == S_FETCH_WGT_ADDR && m_axi_gmem_arready) ||
+            (current_state == S_WRITE_OUT_ADDR && m_axi_gmem_awready))) ||
+          (current_state == S_FETCH_ACT_DATA && next_state == S_FETCH_WGT_DATA))  // B requested early
+        beat_counter <= {BEAT_W{1'b0}};
       else if ((current_state == S_FETCH_ACT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) ||
                (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) ||
                (current_state == S_WRITE_OUT_DATA && m_axi_gmem_wvalid && m_axi_gmem_wready))
         beat_counter <= beat_counter + 1'b1;
 
-      // FIXED: Matrix loading status tracking
-      if (current_state == S_FETCH_ACT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast)
-        activation_loaded <= 1'b1;
-      else if (current_state == S_IDLE)
-        activation_loaded <= 1'b0;
+      // Strided operands advance one row per burst, C one burst of rows;
+      // both wrap after the last burst
+      if (start_pulse)
+        burst_row <= {SIZE_W{1'b0}};
+      else if (current_state == S_FETCH_ACT_DATA && a_strided &&
+               m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast)
+        burst_row <= last_row_a ? {SIZE_W{1'b0}} : burst_row + 1'b1;
+      else if (current_state == S_FETCH_WGT_DATA && b_strided &&
+               m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast)
+        burst_row <= last_row_b ? {SIZE_W{1'b0}} : burst_row + 1'b1;
+      else if (current_state == S_WRITE_OUT_DATA &&
+               m_axi_gmem_wvalid && m_axi_gmem_wready && m_axi_gmem_wlast)
+        burst_row <= last_burst_c ? {SIZE_W{1'b0}} : burst_row + c_burst_rows;
+
+      if (start_pulse) begin
+        ar_row_a <= {SIZE_W{1'b0}};
+        ar_row_b <= {SIZE_W{1'b0}};
+      end else if (ar_fire) begin
+        if (ar_for_b)
+          ar_row_b <= ar_row_b + 1'b1;
+        else
+          ar_row_a <= ar_row_a + 1'b1;
+      end
+
+      // Write responses are collected while later C bursts go out
+      if (start_pulse)
+        c_bresp_pending <= {SIZE_W{1'b0}};
+      else if ((m_axi_gmem_awvalid && m_axi_gmem_awready) && !(m_axi_gmem_bvalid && m_axi_gmem_bready))
+        c_bresp_pending <= c_bresp_pending + 1'b1;
+      else if (!(m_axi_gmem_awvalid && m_axi_gmem_awready) && (m_axi_gmem_bvalid && m_axi_gmem_bready))
+        c_bresp_pending <= c_bresp_pending - 1'b1;
+
+      // Every run opens with OP_START and computes on OP_RUN (see op_fifo)
+      if (start_pulse)
+        op_start_pending <= 1'b1;
+      else if (op_push && op_wdata[OP_W-1 -: 2] == OP_START)
+        op_start_pending <= 1'b0;
+
+      if (start_pulse)
+        op_run_sent <= 1'b0;
+      else if (op_push && op_wdata[OP_W-1 -: 2] == OP_RUN)
+        op_run_sent <= 1'b1;
+
+      // Reuse is decided once per run; the tile is valid again only after a
+      // complete, error-free weight fetch
+      if (start_pulse)
+        wgt_hit <= reuse_b && wgt_valid && (addr_b_reg == wgt_tag_addr) && (ldb_eff == wgt_tag_ldb);
+
+      if (wgt_fetch_start) begin
+        wgt_valid     <= 1'b0;
+        wgt_fetch_err <= 1'b0;
+        wgt_tag_addr  <= addr_b_reg;
+        wgt_tag_ldb   <= ldb_eff;
+      end else if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+        if (m_axi_gmem_rresp != 2'b00)
+          wgt_fetch_err <= 1'b1;
+        if (next_state != S_FETCH_WGT_DATA && next_state != S_FETCH_WGT_ADDR)
+          wgt_valid <= !wgt_fetch_err && (m_axi_gmem_rresp == 2'b00);
+      end else if (current_state == S_LOAD_WGT_CACHE) begin
+        wgt_valid     <= (next_state == S_SYSTOLIC_COMPUTE);
+        wgt_tag_addr  <= addr_b_reg;
+        wgt_tag_ldb   <= ldb_eff;
+      end
+
+      // Weight cache. Without the reuse bit a tile already cached at this
+      // address is refetched into its own slot, so a stale copy never survives.
+      if (start_pulse) begin
+        wc_hit  <= reuse_b && wc_lookup_hit;
+        wc_slot <= wc_lookup_hit ? wc_lookup_slot : wc_victim;
+        wc_fill <= wc_lookup_hit ? !reuse_b : wc_victim_ok;
+        if (reuse_b && (wc_lookup_hit || (wgt_valid && addr_b_reg == wgt_tag_addr && ldb_eff == wgt_tag_ldb)))
+          perf_wc_hits <= perf_wc_hits + 1'b1;
+        else if (reuse_b)
+          perf_wc_misses <= perf_wc_misses + 1'b1;
+      end
 
-      if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast)
-        weight_loaded <= 1'b1;
-      else if (current_state == S_IDLE)
-        weight_loaded <= 1'b0;
+      if (wc_inval_pulse) begin
+        wc_valid  <= {WGT_CACHE_TILES{1'b0}};
+        wc_pinned <= {WGT_CACHE_TILES{1'b0}};
+        wgt_valid <= 1'b0;
+      end else if (wc_drop_pulse) begin
+        wc_valid  <= wc_valid & wc_pinned;
+        wgt_valid <= 1'b0;
+      end else begin
+        if (wc_unpin_pulse)
+          wc_pinned <= {WGT_CACHE_TILES{1'b0}};
+
+        if (wgt_fetch_start && wc_fill) begin
+          wc_valid[wc_slot]    <= 1'b0;
+          wc_tag_addr[wc_slot] <= addr_b_reg;
+          wc_tag_ldb[wc_slot]  <= ldb_eff;
+        end else if (current_state == S_FETCH_WGT_DATA && wc_fill && m_axi_gmem_rvalid && m_axi_gmem_rready &&
+                     next_state != S_FETCH_WGT_DATA && next_state != S_FETCH_WGT_ADDR) begin
+          wc_valid[wc_slot] <= !wgt_fetch_err && (m_axi_gmem_rresp == 2'b00);
+          wc_next           <= wc_slot + 1'b1;
+        end
 
-      // Both matrices loaded - give one extra cycle for stabilization
-      matrices_loaded <= activation_loaded && weight_loaded;
+        if (current_state == S_DONE && pin_b && wc_valid[wc_slot] && (wc_hit || wc_fill))
+          wc_pinned[wc_slot] <= 1'b1;
+      end
 
-      // FIXED: Done flag management
+      // Cached beats are read only while op_fifo has room for them
+      if (current_state != S_LOAD_WGT_CACHE)
+        wc_beat <= {BEAT_W{1'b0}};
+      else if (wc_rd_issue)
+        wc_beat <= wc_beat + 1'b1;
+      wc_rd_v1    <= wc_rd_issue;
+      wc_rd_beat1 <= wc_beat;
+      wc_rd_v2    <= wc_rd_v1;
+      wc_rd_beat2 <= wc_rd_beat1;
+
+      if (current_state == S_FETCH_ACT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready)
+        perf_act_beats <= perf_act_beats + 1'b1;
+      if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready)
+        perf_wgt_beats <= perf_wgt_beats + 1'b1;
+      if (current_state == S_WRITE_OUT_DATA && m_axi_gmem_wvalid && m_axi_gmem_wready)
+        perf_out_beats <= perf_out_beats + 1'b1;
+      if ((current_state == S_FETCH_ACT_DATA || current_state == S_LOAD_WGT_CACHE) &&
+          next_state == S_SYSTOLIC_COMPUTE)
+        perf_wgt_reuse <= perf_wgt_reuse + 1'b1;
+
+      // Completion contract: DONE is only raised from S_DONE, which is entered
+      // from S_WAIT_WRITE_END once every output burst's B response is in.
+      // BRESP is returned by the memory slave after the last W beat is accepted,
+      // so every result word is observable in memory before STATUS reads back
+      // done=1/busy=0. The host needs no delay loop, only a barrier ordering
+      // the STATUS load before its result loads.
       if (current_state == S_DONE)
         accelerator_done <= 1'b1;
       else if (start_pulse)  // Clear done when starting new computation
         accelerator_done <= 1'b0;
 
-if (current_state == S_SYSTOLIC_COMPUTE) begin
-  systolic_cycle_count <= systolic_cycle_count + 1'b1;
-
-  if (matrices_loaded) begin
-    systolic_computing <= 1'b1;
-    input_cycle_count  <= input_cycle_count + 1'b1;
-
-    // give the systolic pipeline a bit more time before capture
-    if (systolic_cycle_count >= 8'd35) begin
-      capture_results <= 1'b1;
+      // A failed beat still completes the FSM; report it instead of hanging
+      if (start_pulse)
+        axi_error <= 1'b0;
+      else if ((m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rresp != 2'b00) ||
+               (m_axi_gmem_bvalid && m_axi_gmem_bready && m_axi_gmem_bresp != 2'b00))
+        axi_error <= 1'b1;
+
+      // Ring: an entry completes in S_DONE (also when its descriptor could not
+      // be read); HEAD then moves on and is written back before the next fetch
+      if (current_state == S_DESC_ADDR)
+        ring_run <= 1'b1;
+      else if (current_state == S_IDLE && !start_pulse)
+        ring_run <= 1'b0;
+
+      if (ring_reset_pulse)
+        ring_head <= 16'd0;
+      else if (current_state == S_DONE && ring_run)
+        ring_head <= ring_head_next;
+
+      if (ring_reset_pulse)
+        ring_error <= 1'b0;
+      else if (ring_run && ((m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rresp != 2'b00) ||
+                            (m_axi_gmem_bvalid && m_axi_gmem_bready && m_axi_gmem_bresp != 2'b00)))
+        ring_error <= 1'b1;
     end
-  end else begin
-    systolic_computing <= 1'b0;
-    input_cycle_count  <= 8'd0;
   end
-end else begin
-  systolic_computing     <= 1'b0;
-  systolic_cycle_count   <= 8'd0;
-  input_cycle_count      <= 8'd0;
-  capture_results        <= 1'b0;
-end
 
-      // Output buffer management
-      if (current_state == S_WRITE_OUT_DATA && m_axi_gmem_wvalid && m_axi_gmem_wready) begin
-        if (output_buffer_idx < 5'd63)
-          output_buffer_idx <= output_buffer_idx + 1'b1;
-      end else if (current_state == S_IDLE) begin
-        output_buffer_idx <= 5'd0;
-      end
+  // Last operand beat seen on the bus, for the debug window
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      debug_last_rdata <= 128'd0;
+      debug_beat_count <= 8'd0;
+      debug_last_addr <= 32'd0;
+    end else if (current_state == S_FETCH_ACT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+      debug_last_rdata <= m_axi_gmem_rdata;
+      debug_beat_count <= beat_counter[7:0];
+      debug_last_addr <= addr_a_reg + (beat_counter * a_beat_bytes / ARRAY_SIZE) * lda_eff; // row of this beat
     end
   end
 
-  // Matrix unpacking from buffers
-  integer unpack_i, unpack_j;
-  always @(posedge ap_clk) begin
-    if (!ap_rst_n) begin
-      for (unpack_i = 0; unpack_i < SYSTOLIC_SIZE; unpack_i = unpack_i + 1) begin
-        for (unpack_j = 0; unpack_j < SYSTOLIC_SIZE; unpack_j = unpack_j + 1) begin
-          activation_matrix[unpack_i][unpack_j] <= 8'd0;
-          weight_matrix[unpack_i][unpack_j] <= 8'd0;
-        end
-      end
-    end else begin
-      // Unpack activation matrix when loading completes
-      if (current_state == S_FETCH_ACT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) begin
-        // Debug: Capture last AXI transaction details
-        debug_last_rdata <= m_axi_gmem_rdata;
-        debug_beat_count <= beat_counter;
-        debug_last_addr <= addr_a_reg + (beat_counter << 4); // beat_counter * 16 bytes
-        
-        activation_matrix[beat_counter][0]  <= $signed(m_axi_gmem_rdata[7:0]);
-        activation_matrix[beat_counter][1]  <= $signed(m_axi_gmem_rdata[15:8]);
-        activation_matrix[beat_counter][2]  <= $signed(m_axi_gmem_rdata[23:16]);
-        activation_matrix[beat_counter][3]  <= $signed(m_axi_gmem_rdata[31:24]);
-        activation_matrix[beat_counter][4]  <= $signed(m_axi_gmem_rdata[39:32]);
-        activation_matrix[beat_counter][5]  <= $signed(m_axi_gmem_rdata[47:40]);
-        activation_matrix[beat_counter][6]  <= $signed(m_axi_gmem_rdata[55:48]);
-        activation_matrix[beat_counter][7]  <= $signed(m_axi_gmem_rdata[63:56]);
-        activation_matrix[beat_counter][8]  <= $signed(m_axi_gmem_rdata[71:64]);
-        activation_matrix[beat_counter][9]  <= $signed(m_axi_gmem_rdata[79:72]);
-        activation_matrix[beat_counter][10] <= $signed(m_axi_gmem_rdata[87:80]);
-        activation_matrix[beat_counter][11] <= $signed(m_axi_gmem_rdata[95:88]);
-        activation_matrix[beat_counter][12] <= $signed(m_axi_gmem_rdata[103:96]);
-        activation_matrix[beat_counter][13] <= $signed(m_axi_gmem_rdata[111:104]);
-        activation_matrix[beat_counter][14] <= $signed(m_axi_gmem_rdata[119:112]);
-        activation_matrix[beat_counter][15] <= $signed(m_axi_gmem_rdata[127:120]);
-      end
-      
-      // Unpack weight matrix when loading completes
-      if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) begin
-        weight_matrix[beat_counter][0]  <= $signed(m_axi_gmem_rdata[7:0]);
-        weight_matrix[beat_counter][1]  <= $signed(m_axi_gmem_rdata[15:8]);
-        weight_matrix[beat_counter][2]  <= $signed(m_axi_gmem_rdata[23:16]);
-        weight_matrix[beat_counter][3]  <= $signed(m_axi_gmem_rdata[31:24]);
-        weight_matrix[beat_counter][4]  <= $signed(m_axi_gmem_rdata[39:32]);
-        weight_matrix[beat_counter][5]  <= $signed(m_axi_gmem_rdata[47:40]);
-        weight_matrix[beat_counter][6]  <= $signed(m_axi_gmem_rdata[55:48]);
-        weight_matrix[beat_counter][7]  <= $signed(m_axi_gmem_rdata[63:56]);
-        weight_matrix[beat_counter][8]  <= $signed(m_axi_gmem_rdata[71:64]);
-        weight_matrix[beat_counter][9]  <= $signed(m_axi_gmem_rdata[79:72]);
-        weight_matrix[beat_counter][10] <= $signed(m_axi_gmem_rdata[87:80]);
-        weight_matrix[beat_counter][11] <= $signed(m_axi_gmem_rdata[95:88]);
-        weight_matrix[beat_counter][12] <= $signed(m_axi_gmem_rdata[103:96]);
-        weight_matrix[beat_counter][13] <= $signed(m_axi_gmem_rdata[111:104]);
-        weight_matrix[beat_counter][14] <= $signed(m_axi_gmem_rdata[119:112]);
-        weight_matrix[beat_counter][15] <= $signed(m_axi_gmem_rdata[127:120]);
-      end
+  // Operand entries for the compute core, one per cycle: OP_START first,
+  // then every A and B beat as it is accepted (R is held while op_fifo is
+  // full) or replayed from the weight cache, then OP_RUN once the tiles are
+  // complete. Payload layouts are documented in gemma_compute_core.
+  always @(*) begin
+    op_push  = 1'b0;
+    op_wdata = {OP_W{1'b0}};
+    if (op_start_pending && !op_full) begin
+      op_push  = 1'b1;
+      op_wdata = {OP_START, {BEAT_W{1'b0}}, {(128-16-SIZE_W){1'b0}}, a_rows, 3'd0, b_beat_bytes, 3'd0, a_beat_bytes};
+    end else if ((current_state == S_FETCH_ACT_DATA || current_state == S_FETCH_WGT_DATA) &&
+                 m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+      op_push  = 1'b1;
+      op_wdata = {(current_state == S_FETCH_ACT_DATA) ? OP_A : OP_B, beat_counter, m_axi_gmem_rdata};
+    end else if (wc_rd_v2) begin
+      op_push  = 1'b1;
+      op_wdata = {OP_B, wc_rd_beat2, wgt_buf_rd_data};
+    end else if (current_state == S_SYSTOLIC_COMPUTE && !op_run_sent && !op_full) begin
+      op_push  = 1'b1;
+      op_wdata = {OP_RUN, {BEAT_W{1'b0}}, {(128-16-SIZE_W){1'b0}}, c_rows, 14'd0, trans_b, trans_a};
     end
   end
 
@@ -397,9 +785,9 @@ end
       act_buf_wr_addr       <= {BUFFER_ADDR_WIDTH{1'b0}};
       act_buf_wr_data       <= 128'd0;
       wgt_buf_wr_en         <= 1'b0;
-      wgt_buf_wr_addr       <= {BUFFER_ADDR_WIDTH{1'b0}};
+      wgt_buf_wr_addr       <= {WC_AW{1'b0}};
       wgt_buf_wr_data       <= 128'd0;
-      wgt_buf_rd_addr       <= {BUFFER_ADDR_WIDTH{1'b0}};
+      wgt_buf_rd_addr       <= {WC_AW{1'b0}};
     end else begin
       // Default values
       act_buf_wr_en         <= 1'b0;
@@ -412,145 +800,28 @@ end
         act_buf_wr_data <= m_axi_gmem_rdata;
       end
 
-      // Load weight data
-      if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+      // Load weight data into the slot being filled
+      if (current_state == S_FETCH_WGT_DATA && m_axi_gmem_rvalid && m_axi_gmem_rready && wc_fill) begin
         wgt_buf_wr_en   <= 1'b1;
-        wgt_buf_wr_addr <= beat_counter[BUFFER_ADDR_WIDTH-1:0];
+        wgt_buf_wr_addr <= wc_slot * WGT_TILE_BEATS + beat_counter;
         wgt_buf_wr_data <= m_axi_gmem_rdata;
       end
-    end
-  end
-
-  // Synchronous clear of all PE accumulators at the start of SYSTOLIC
-  always @(posedge ap_clk) begin
-    if (!ap_rst_n) begin
-      systolic_accum_reset <= 1'b1;
-    end else begin
-      if (current_state == S_SYSTOLIC_COMPUTE && systolic_cycle_count == 8'd0)
-        systolic_accum_reset <= 1'b1;
-      else
-        systolic_accum_reset <= 1'b0;
-    end
-  end
-
-  // FIXED: Systolic array input generation with VALID SIGNAL CONTROL
-  integer skew_i;
-  integer buf_idx;
-  always @(posedge ap_clk) begin
-    if (!ap_rst_n) begin
-      for (skew_i = 0; skew_i < SYSTOLIC_SIZE; skew_i = skew_i + 1) begin
-        systolic_north_inputs[skew_i] <= 8'd0;
-        systolic_west_inputs[skew_i] <= 8'd0;
-      end
-      systolic_north_valid <= {SYSTOLIC_SIZE{1'b0}};
-      systolic_west_valid <= {SYSTOLIC_SIZE{1'b0}};
-    end else if (current_state == S_SYSTOLIC_COMPUTE && matrices_loaded && systolic_computing) begin
-      for (skew_i = 0; skew_i < SYSTOLIC_SIZE; skew_i = skew_i + 1) begin
-        if (input_cycle_count >= (skew_i + 1) && (input_cycle_count - skew_i - 1) < SYSTOLIC_SIZE) begin
-          systolic_north_inputs[skew_i] <= weight_matrix[input_cycle_count - skew_i - 1][skew_i];
-          systolic_west_inputs[skew_i] <= activation_matrix[skew_i][input_cycle_count - skew_i - 1];
-          systolic_north_valid[skew_i] <= 1'b1;
-          systolic_west_valid[skew_i] <= 1'b1;
-        end else begin
-          systolic_north_inputs[skew_i] <= 8'd0;
-          systolic_west_inputs[skew_i] <= 8'd0;
-          systolic_north_valid[skew_i] <= 1'b0;
-          systolic_west_valid[skew_i] <= 1'b0;
-        end
-      end
-    end else begin
-      for (skew_i = 0; skew_i < SYSTOLIC_SIZE; skew_i = skew_i + 1) begin
-        systolic_north_inputs[skew_i] <= 8'd0;
-        systolic_west_inputs[skew_i] <= 8'd0;
-      end
-      systolic_north_valid <= {SYSTOLIC_SIZE{1'b0}};
-      systolic_west_valid <= {SYSTOLIC_SIZE{1'b0}};
-    end
-  end
 
-  // // Result capture and output buffer preparation
-  // integer i, j;
-  // always @(posedge ap_clk) begin
-  //   if (!ap_rst_n) begin
-  //     for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-  //       for (j = 0; j < SYSTOLIC_SIZE; j = j + 1) begin
-  //         result_matrix[i][j] <= {ACCUM_WIDTH{1'b0}};
-  //       end
-  //     end
-  //     for (i = 0; i < 64; i = i + 1) begin
-  //       output_data_buffer[i] <= 128'd0;
-  //     end
-  //   end else begin
-  //     // Capture results when computation is complete
-  //     if (capture_results && systolic_cycle_count == 8'd49) begin
-  //       for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-  //         for (j = 0; j < SYSTOLIC_SIZE; j = j + 1) begin
-  //           result_matrix[i][j] <= systolic_results[(i*SYSTOLIC_SIZE + j + 1)*ACCUM_WIDTH - 1 -: ACCUM_WIDTH];
-  //         end
-  //       end
-  //     end
-
-  //     // Prepare output data buffer - pack 4×32-bit values per 128-bit word
-  //     if (current_state == S_SYSTOLIC_COMPUTE && systolic_cycle_count == 8'd50) begin
-  //       for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-  //         for (j = 0; j < SYSTOLIC_SIZE; j = j + 4) begin
-  //           buf_idx = i * 4 + j/4;
-  //           output_data_buffer[buf_idx] <= {
-  //             result_matrix[i][j+3],
-  //             result_matrix[i][j+2],
-  //             result_matrix[i][j+1],
-  //             result_matrix[i][j+0]
-  //           };
-  //         end
-  //       end
-  //     end
-  //   end
-  // end
-
-  // Result capture and output buffer preparation
-integer i, j, buf_idx;
-always @(posedge ap_clk) begin
-  if (!ap_rst_n) begin
-    for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-      for (j = 0; j < SYSTOLIC_SIZE; j = j + 1) begin
-        result_matrix[i][j] <= {ACCUM_WIDTH{1'b0}};
-      end
-    end
-    for (i = 0; i < 64; i = i + 1) begin
-      output_data_buffer[i] <= 128'd0;
-    end
-  end else begin
-    // 1) CAPTURE: wait an extra couple of cycles for pipeline to settle
-    if (capture_results && systolic_cycle_count == 8'd60) begin
-      for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-        for (j = 0; j < SYSTOLIC_SIZE; j = j + 1) begin
-          // keep your original +1 slice convention
-          result_matrix[i][j] <= systolic_results[(i*SYSTOLIC_SIZE + j + 1)*ACCUM_WIDTH - 1 -: ACCUM_WIDTH];
-        end
-      end
-    end
-
-    // 2) PACK: do packing one cycle *after* capture
-    if (capture_results && systolic_cycle_count == 8'd65) begin
-      // pack 4×32-bit per 128-bit, row by row, big-endian within the word
-      for (i = 0; i < SYSTOLIC_SIZE; i = i + 1) begin
-        for (j = 0; j < SYSTOLIC_SIZE; j = j + 4) begin
-          buf_idx = i * 4 + j/4;
-          output_data_buffer[buf_idx] <= {
-            result_matrix[i][j+3],
-            result_matrix[i][j+2],
-            result_matrix[i][j+1],
-            result_matrix[i][j+0]
-          };
-        end
-      end
+      // Read a cached tile back (data follows two cycles after the issue)
+      if (wc_rd_issue)
+        wgt_buf_rd_addr <= wc_slot * WGT_TILE_BEATS + wc_beat;
     end
   end
-end
 
-  // AXI-Lite interface
-  assign s_axi_control_awready = (current_state == S_IDLE);
-  assign s_axi_control_wready  = (current_state == S_IDLE);
+  // AXI-Lite interface. Registers are written only in S_IDLE (a write
+  // otherwise waits), except the RING_TAIL doorbell and the interrupt
+  // registers, which are taken any time.
+  wire [7:0] awaddr_in         = {s_axi_control_awaddr[7:2], 2'b00};
+  wire   lite_wr_open          = (current_state == S_IDLE) && !start_pulse;
+  wire   lite_wr_any_time      = (awaddr_in == RING_TAIL) || (awaddr_in == INT_GIE) ||
+                                 (awaddr_in == INT_ENABLE) || (awaddr_in == INT_STATUS);
+  assign s_axi_control_awready = lite_wr_open || lite_wr_any_time;
+  assign s_axi_control_wready  = lite_wr_open || awvalid_seen;
   // assign s_axi_control_arready = (current_state == S_IDLE) || (s_axi_control_araddr == ADDR_STATUS);
   assign s_axi_control_arready = 1'b1;
 
@@ -573,11 +844,78 @@ end
     addr_a_reg           <= 64'd0;
     addr_b_reg           <= 64'd0;
     addr_c_reg           <= 64'd0;
+    lda_reg              <= 32'd0;
+    ldb_reg              <= 32'd0;
+    ldc_reg              <= 32'd0;
+    rows_reg             <= {SIZE_W{1'b0}};
+    trans_a              <= 1'b0;
+    trans_b              <= 1'b0;
+    reuse_b              <= 1'b0;
+    preload_b            <= 1'b0;
+    pin_b                <= 1'b0;
+    wc_inval_pulse       <= 1'b0;
+    wc_unpin_pulse       <= 1'b0;
+    wc_drop_pulse        <= 1'b0;
+    ring_base            <= 64'd0;
+    ring_wb_addr         <= 64'd0;
+    ring_size            <= 16'd0;
+    ring_tail            <= 16'd0;
+    ring_reset_pulse     <= 1'b0;
+    desc_beat            <= 2'd0;
+    desc_err             <= 1'b0;
+    int_gie              <= 1'b0;
+    int_enable           <= {INT_SOURCES{1'b0}};
+    int_status           <= {INT_SOURCES{1'b0}};
+    interrupt            <= 1'b0;
     debug_buffer_index   <= 32'd0;
     wstrb_latched        <= 4'b0000;
   end else begin
     // one-shot start pulse
     if (start_pulse) start_pulse <= 1'b0;
+    wc_inval_pulse <= 1'b0;
+    wc_unpin_pulse <= 1'b0;
+    wc_drop_pulse  <= 1'b0;
+    ring_reset_pulse <= 1'b0;
+
+    // A source firing in the cycle its bit is cleared stays set
+    if (awvalid_seen && wvalid_seen && awaddr_word == INT_STATUS && wstrb_latched[0])
+      int_status <= (int_status & ~wdata_latched[INT_SOURCES-1:0]) | int_events;
+    else
+      int_status <= int_status | int_events;
+    interrupt <= int_gie && |(int_status & int_enable);
+
+    // Descriptor beats load the run registers; a clean last beat starts the
+    // run from S_IDLE exactly like a CTRL write
+    if (current_state == S_DESC_ADDR) begin
+      desc_beat <= 2'd0;
+      desc_err  <= 1'b0;
+    end else if (desc_beat_fire) begin
+      desc_beat <= desc_beat + 1'b1;
+      if (m_axi_gmem_rresp != 2'b00)
+        desc_err <= 1'b1;
+      case (desc_beat)
+        2'd0: begin
+          addr_a_reg <= m_axi_gmem_rdata[63:0];
+          addr_b_reg <= m_axi_gmem_rdata[127:64];
+        end
+        2'd1: begin
+          addr_c_reg <= m_axi_gmem_rdata[63:0];
+          lda_reg    <= m_axi_gmem_rdata[95:64];
+          ldb_reg    <= m_axi_gmem_rdata[127:96];
+        end
+        default: begin
+          ldc_reg    <= m_axi_gmem_rdata[31:0];
+          rows_reg   <= m_axi_gmem_rdata[32 +: SIZE_W];
+          preload_b  <= m_axi_gmem_rdata[65];
+          trans_a    <= m_axi_gmem_rdata[68];
+          trans_b    <= m_axi_gmem_rdata[69];
+          reuse_b    <= m_axi_gmem_rdata[70];
+          pin_b      <= m_axi_gmem_rdata[71] && desc_ok;  // S_DONE pins nothing for a bad entry
+        end
+      endcase
+      if (m_axi_gmem_rlast && desc_ok)
+        start_pulse <= 1'b1;
+    end
 
     // complete write response
     if (s_axi_control_bvalid && s_axi_control_bready)
@@ -603,7 +941,15 @@ end
       s_axi_control_bvalid <= 1'b1;
 
       // robust START: trigger if any written byte's LSB is 1
+      // Mode bits are taken from every CTRL write, so a plain start (0x1) runs A*B
       if (awaddr_word == ADDR_CTRL) begin
+        if (wstrb_latched[0]) begin
+          trans_a <= wdata_latched[4];
+          trans_b <= wdata_latched[5];
+          reuse_b   <= wdata_latched[6];
+          preload_b <= wdata_latched[1];
+          pin_b     <= wdata_latched[7];
+        end
         if ( (wstrb_latched[0] && wdata_latched[0])  ||
              (wstrb_latched[1] && wdata_latched[8])  ||
              (wstrb_latched[2] && wdata_latched[16]) ||
@@ -619,7 +965,28 @@ end
         B_MSB:          addr_b_reg[63:32]  <= merge_by_wstrb(addr_b_reg[63:32],  wdata_latched, wstrb_latched);
         C_LSB:          addr_c_reg[31:0]   <= merge_by_wstrb(addr_c_reg[31:0],   wdata_latched, wstrb_latched);
         C_MSB:          addr_c_reg[63:32]  <= merge_by_wstrb(addr_c_reg[63:32],  wdata_latched, wstrb_latched);
+        LDA:            lda_reg            <= merge_by_wstrb(lda_reg,            wdata_latched, wstrb_latched);
+        LDB:            ldb_reg            <= merge_by_wstrb(ldb_reg,            wdata_latched, wstrb_latched);
+        LDC:            ldc_reg            <= merge_by_wstrb(ldc_reg,            wdata_latched, wstrb_latched);
+        ROWS:           if (wstrb_latched[0]) rows_reg <= wdata_latched[SIZE_W-1:0];
+        WCACHE_CTRL:    if (wstrb_latched[0]) begin
+                          wc_inval_pulse <= wdata_latched[0];
+                          wc_unpin_pulse <= wdata_latched[1];
+                          wc_drop_pulse  <= wdata_latched[2];
+                        end
         DBG_BUF_INDEX:  debug_buffer_index <= merge_by_wstrb(debug_buffer_index, wdata_latched, wstrb_latched);
+        RING_BASE_LO:   ring_base[31:0]    <= merge_by_wstrb(ring_base[31:0],    wdata_latched, wstrb_latched);
+        RING_BASE_HI:   ring_base[63:32]   <= merge_by_wstrb(ring_base[63:32],   wdata_latched, wstrb_latched);
+        RING_WB_LO:     ring_wb_addr[31:0] <= merge_by_wstrb(ring_wb_addr[31:0], wdata_latched, wstrb_latched);
+        RING_WB_HI:     ring_wb_addr[63:32] <= merge_by_wstrb(ring_wb_addr[63:32], wdata_latched, wstrb_latched);
+        RING_SIZE:      begin
+                          ring_size        <= wdata_latched[15:0];
+                          ring_tail        <= 16'd0;
+                          ring_reset_pulse <= 1'b1;
+                        end
+        RING_TAIL:      ring_tail <= wdata_latched[15:0];
+        INT_GIE:        if (wstrb_latched[0]) int_gie <= wdata_latched[0];
+        INT_ENABLE:     if (wstrb_latched[0]) int_enable <= wdata_latched[INT_SOURCES-1:0];
         default: ;
       endcase
     end
@@ -628,24 +995,6 @@ end
 
 
 
-reg packed_ready;
-
-always @(posedge ap_clk) begin
-  if (!ap_rst_n) begin
-    packed_ready <= 1'b0;
-  end else begin
-    if (current_state == S_SYSTOLIC_COMPUTE) begin
-      // raise when packing is done
-      if (capture_results && systolic_cycle_count == 8'd65)
-        packed_ready <= 1'b1;
-    end else if (current_state == S_IDLE && start_pulse) begin
-      // clear for next op
-      packed_ready <= 1'b0;
-    end
-  end
-end
-
-
   // Add buffer read address control for debug access
   always @(posedge ap_clk) begin
     if (!ap_rst_n) begin
@@ -655,19 +1004,6 @@ end
     end
   end
 
-reg [127:0] write_staging_buffer [0:63];
-
-integer k;
-always @(posedge ap_clk) begin
-  if (!ap_rst_n) begin
-    for (k=0;k<64;k=k+1) write_staging_buffer[k] <= 128'd0;
-  end else if (current_state == S_SYSTOLIC_COMPUTE && packed_ready && systolic_cycle_count == 8'd66) begin
-    for (k=0;k<64;k=k+1) write_staging_buffer[k] <= output_data_buffer[k];
-  end
-end
-
-
-
   // FIXED: AXI-Lite read logic with proper status reporting
   always @(posedge ap_clk) begin
     if (!ap_rst_n) begin
@@ -682,8 +1018,9 @@ end
 
         // assume araddr_word = {s_axi_control_araddr[5:2],2'b00}
         case (araddr_word)
-          // status: bit0=done, bit1=busy
-          ADDR_STATUS:      s_axi_control_rdata <= {30'd0, (current_state != S_IDLE), accelerator_done};
+          // status: bit0=done, bit1=busy, bit2=axi_error (valid once done), bit3=ring_error,
+          //         bit4/5=trans_a/b, bit6=weight fetch skipped in the last run, bit7=ring not empty
+          ADDR_STATUS:      s_axi_control_rdata <= {24'd0, ring_pending, wgt_hit, trans_b, trans_a, ring_error, axi_error, (current_state != S_IDLE), accelerator_done};
 
           // existing pointers (great for readback debugging)
           A_LSB:            s_axi_control_rdata <= addr_a_reg[31:0];
@@ -692,6 +1029,28 @@ end
           B_MSB:            s_axi_control_rdata <= addr_b_reg[63:32];
           C_LSB:            s_axi_control_rdata <= addr_c_reg[31:0];
           C_MSB:            s_axi_control_rdata <= addr_c_reg[63:32];
+          LDA:              s_axi_control_rdata <= lda_reg;
+          LDB:              s_axi_control_rdata <= ldb_reg;
+          LDC:              s_axi_control_rdata <= ldc_reg;
+          ROWS:             s_axi_control_rdata <= {{(32-SIZE_W){1'b0}}, rows_reg};
+          PERF_ACT_BEATS:   s_axi_control_rdata <= perf_act_beats;
+          PERF_WGT_BEATS:   s_axi_control_rdata <= perf_wgt_beats;
+          PERF_OUT_BEATS:   s_axi_control_rdata <= perf_out_beats;
+          PERF_WGT_REUSE:   s_axi_control_rdata <= perf_wgt_reuse;
+          WCACHE_CTRL:      s_axi_control_rdata <= WGT_CACHE_TILES;
+          WCACHE_HITS:      s_axi_control_rdata <= perf_wc_hits;
+          WCACHE_MISSES:    s_axi_control_rdata <= perf_wc_misses;
+          ACC_ID:           s_axi_control_rdata <= ACC_ID_VALUE;
+          INT_GIE:          s_axi_control_rdata <= {31'd0, int_gie};
+          INT_ENABLE:       s_axi_control_rdata <= {{(32-INT_SOURCES){1'b0}}, int_enable};
+          INT_STATUS:       s_axi_control_rdata <= {{(32-INT_SOURCES){1'b0}}, int_status};
+          RING_BASE_LO:     s_axi_control_rdata <= ring_base[31:0];
+          RING_BASE_HI:     s_axi_control_rdata <= ring_base[63:32];
+          RING_SIZE:        s_axi_control_rdata <= {16'd0, ring_size};
+          RING_TAIL:        s_axi_control_rdata <= {16'd0, ring_tail};
+          RING_HEAD:        s_axi_control_rdata <= {16'd0, ring_head};
+          RING_WB_LO:       s_axi_control_rdata <= ring_wb_addr[31:0];
+          RING_WB_HI:       s_axi_control_rdata <= ring_wb_addr[63:32];
 
           // tiny buffer peek window
           DBG_BUF_INDEX:    s_axi_control_rdata <= debug_buffer_index;
@@ -771,42 +1130,34 @@ end
 always @(posedge ap_clk) begin
   if (!ap_rst_n) begin
     write_active      <= 1'b0;
-    write_beat_count  <= 8'd0;
-    write_data_reg    <= 128'd0;
-    write_last_reg    <= 1'b0;
+    write_beat_count  <= {BEAT_W{1'b0}};
     wbeats_sent       <= 8'd0;
     debug_wbeats_sent <= 8'd0;
   end else begin
-    // arm when AW handshakes
+    // arm when AW handshakes (later bursts continue at the next beat)
     if (current_state == S_WRITE_OUT_ADDR && m_axi_gmem_awready) begin
-      write_active     <= 1'b1;
-      write_beat_count <= 8'd0;
-      write_data_reg   <= write_staging_buffer[8'd0]; // NOTE: from the staging copy
-      write_last_reg   <= (8'd0 == 8'd63);
-      wbeats_sent      <= 8'd0;
-    end
-
-    // advance strictly on WREADY handshake
-    if (current_state == S_WRITE_OUT_DATA && write_active && m_axi_gmem_wready) begin
-      wbeats_sent <= wbeats_sent + 1'b1;
-      if (write_beat_count == 8'd63) begin
-        write_active      <= 1'b0;    // this beat completes the burst
-        write_last_reg    <= 1'b0;    // drop on next cycle
-        debug_wbeats_sent <= wbeats_sent + 1'b1;
-      end else begin
-        write_beat_count <= write_beat_count + 1'b1;
-        write_data_reg   <= write_staging_buffer[write_beat_count + 1'b1];
-        write_last_reg   <= (write_beat_count + 1'b1 == 8'd63);
+      write_active <= 1'b1;
+      if (burst_row == 0) begin
+        write_beat_count <= {BEAT_W{1'b0}};
+        wbeats_sent      <= 8'd0;
       end
     end
 
-    // clean up once we leave DATA
-    if (current_state != S_WRITE_OUT_DATA) begin
-      write_last_reg <= 1'b0;
+    // advance strictly on the W handshake (one res_fifo entry per beat)
+    if (current_state == S_WRITE_OUT_DATA && m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+      wbeats_sent      <= wbeats_sent + 1'b1;
+      write_beat_count <= write_beat_count + 1'b1;
+      if (write_beat_count == c_burst_last_beat) begin
+        write_active <= 1'b0;        // this beat completes the burst
+        if (last_burst_c)
+          debug_wbeats_sent <= wbeats_sent + 1'b1;
+      end
     end
   end
 end
 
+assign res_pop = (current_state == S_WRITE_OUT_DATA) && m_axi_gmem_wvalid && m_axi_gmem_wready;
+
 
   // FIXED: FSM and AXI Master interface
   always @(*) begin
@@ -832,72 +1183,139 @@ end
 
     case (current_state)
       S_IDLE: 
-        if (start_pulse) next_state = S_FETCH_ACT_ADDR;
+        if (start_pulse) next_state = preload_b ? S_FETCH_WGT_ADDR : S_FETCH_ACT_ADDR;
+        else if (ring_pending && !lite_wr_busy) next_state = S_DESC_ADDR;
+
+      S_DESC_ADDR: begin
+        m_axi_gmem_arvalid = 1'b1;
+        m_axi_gmem_araddr  = ring_base + {ring_head, 6'd0};
+        m_axi_gmem_arlen   = DESC_BEATS - 1;
+        if (m_axi_gmem_arready) next_state = S_DESC_DATA;
+      end
+
+      S_DESC_DATA: begin
+        m_axi_gmem_rready = 1'b1;
+        // start_pulse is raised with the last beat; a bad entry only completes
+        if (m_axi_gmem_rvalid && m_axi_gmem_rlast)
+          next_state = desc_ok ? S_IDLE : S_DONE;
+      end
 
       S_FETCH_ACT_ADDR: begin
         m_axi_gmem_arvalid = 1'b1;
-        m_axi_gmem_araddr  = addr_a_reg;
-        m_axi_gmem_arlen   = 8'd15; // 16 beats for 16x16 INT8 activation matrix
+        m_axi_gmem_araddr  = addr_a_reg + ar_row_a * lda_eff;
+        m_axi_gmem_arlen   = a_strided ? IN_ROW_BEATS - 1 : a_dense_len; // one row, or the first ROWS rows
         m_axi_gmem_arsize  = 3'b100; // 16 bytes per beat (128-bit)
         m_axi_gmem_arburst = 2'b01; // INCR burst type
         if (m_axi_gmem_arready) next_state = S_FETCH_ACT_DATA;
       end
 
       S_FETCH_ACT_DATA: begin
-        m_axi_gmem_rready = 1'b1;
+        m_axi_gmem_rready = op_ready;
+        // Remaining rows of a strided A, then B, while A streams in
+        if (ar_more_a) begin
+          m_axi_gmem_arvalid = 1'b1;
+          m_axi_gmem_araddr  = addr_a_reg + ar_row_a * lda_eff;
+          m_axi_gmem_arlen   = IN_ROW_BEATS - 1;
+        end else if (fetch_b && ar_more_b) begin
+          m_axi_gmem_arvalid = 1'b1;
+          m_axi_gmem_araddr  = addr_b_reg + ar_row_b * ldb_eff;
+          m_axi_gmem_arlen   = b_strided ? IN_ROW_BEATS - 1 : IN_TILE_BEATS - 1;
+        end
         if (m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast) 
-          next_state = S_FETCH_WGT_ADDR;
+          next_state = (a_strided && !last_row_a)               ? S_FETCH_ACT_DATA   :
+                       wgt_hit                                  ? S_SYSTOLIC_COMPUTE :
+                       wc_hit                                   ? S_LOAD_WGT_CACHE   :
+                       (ar_row_b != 0 || m_axi_gmem_arready)    ? S_FETCH_WGT_DATA   : S_FETCH_WGT_ADDR;
       end
 
-      S_FETCH_WGT_ADDR: begin
+      S_FETCH_WGT_ADDR: if (preload_b && wc_hit) begin
+        next_state = S_DONE;  // Preload of a cached tile: only the pin applies
+      end else begin
         m_axi_gmem_arvalid = 1'b1;
-        m_axi_gmem_araddr  = addr_b_reg;
-        m_axi_gmem_arlen   = 8'd15; // 16 beats for 16x16 INT8 weight matrix
+        m_axi_gmem_araddr  = addr_b_reg + ar_row_b * ldb_eff;
+        m_axi_gmem_arlen   = b_strided ? IN_ROW_BEATS - 1 : IN_TILE_BEATS - 1; // one row, or the whole tile
         m_axi_gmem_arsize  = 3'b100; // 16 bytes per beat (128-bit)
         m_axi_gmem_arburst = 2'b01; // INCR burst type
         if (m_axi_gmem_arready) next_state = S_FETCH_WGT_DATA;
       end
 
       S_FETCH_WGT_DATA: begin
-        m_axi_gmem_rready = 1'b1;
+        m_axi_gmem_rready = op_ready;
+        if (ar_more_b) begin  // Remaining rows of a strided B
+          m_axi_gmem_arvalid = 1'b1;
+          m_axi_gmem_araddr  = addr_b_reg + ar_row_b * ldb_eff;
+          m_axi_gmem_arlen   = IN_ROW_BEATS - 1;
+        end
         if (m_axi_gmem_rvalid && m_axi_gmem_rready && m_axi_gmem_rlast)
-          next_state = S_SYSTOLIC_COMPUTE;
+          next_state = (b_strided && !last_row_b) ? S_FETCH_WGT_DATA :
+                       preload_b                ? S_DONE             : S_SYSTOLIC_COMPUTE;
       end
 
+      S_LOAD_WGT_CACHE:  // Every cached beat read and pushed
+        if (wc_beat == b_tile_beats && !wc_rd_v1 && !wc_rd_v2) next_state = S_SYSTOLIC_COMPUTE;
+
       // ---- combinational FSM (only control the bus signals here)
 S_SYSTOLIC_COMPUTE: begin
-  if (systolic_cycle_count >= 8'd70 && packed_ready)
+  // OP_RUN goes out here; the first result beat back means the tile is done
+  if (!res_empty)
     next_state = S_WRITE_OUT_ADDR;
 end
 
 S_WRITE_OUT_ADDR: begin
   // DRIVE AW
   m_axi_gmem_awvalid = 1'b1;
-  m_axi_gmem_awaddr  = addr_c_reg;
-  m_axi_gmem_awlen   = 8'd63;     // 64 beats
+  m_axi_gmem_bready  = 1'b1;  // Responses of earlier bursts
+  m_axi_gmem_awaddr  = addr_c_reg + burst_row * ldc_eff;
+  m_axi_gmem_awlen   = c_burst_last_beat - c_burst_first_beat;  // OUT_ROW_BEATS per C row in the burst
   if (m_axi_gmem_awready)
     next_state = S_WRITE_OUT_DATA;
 end
 
 S_WRITE_OUT_DATA: begin
-  // DRIVE W from the regs (do not compute next here)
-  m_axi_gmem_wvalid = write_active;
-  m_axi_gmem_wdata  = write_data_reg;
+  // DRIVE W from the head of res_fifo (do not compute next here)
+  m_axi_gmem_wvalid = write_active && !res_empty;
+  m_axi_gmem_wdata  = res_rdata;
   m_axi_gmem_wstrb  = 16'hFFFF;
-  m_axi_gmem_wlast  = write_last_reg;
+  m_axi_gmem_wlast  = (write_beat_count == c_burst_last_beat);
+  m_axi_gmem_bready = 1'b1;
 
+  // The next burst does not wait for this one's write response
   if (m_axi_gmem_wvalid && m_axi_gmem_wready && m_axi_gmem_wlast)
-    next_state = S_WAIT_WRITE_END;
+    next_state = last_burst_c ? S_WAIT_WRITE_END : S_WRITE_OUT_ADDR;
 end
 
 S_WAIT_WRITE_END: begin
   m_axi_gmem_bready = 1'b1;
-  if (m_axi_gmem_bvalid && m_axi_gmem_bready)
+  if (c_bresp_pending == 0 || (c_bresp_pending == 1 && m_axi_gmem_bvalid))
     next_state = S_DONE;
 end
 
       S_DONE: 
-        next_state = S_IDLE;
+        next_state = (ring_run && ring_wb_addr != 64'd0) ? S_HEAD_WB_ADDR : S_IDLE;
+
+      // One beat carrying the new HEAD in the addressed 32-bit lane
+      S_HEAD_WB_ADDR: begin
+        m_axi_gmem_awvalid = 1'b1;
+        m_axi_gmem_bready  = 1'b1;
+        m_axi_gmem_awaddr  = {ring_wb_addr[63:4], 4'd0};
+        m_axi_gmem_awlen   = 8'd0;
+        if (m_axi_gmem_awready) next_state = S_HEAD_WB_DATA;
+      end
+
+      S_HEAD_WB_DATA: begin
+        m_axi_gmem_wvalid = 1'b1;
+        m_axi_gmem_wlast  = 1'b1;
+        m_axi_gmem_wdata  = {4{16'd0, ring_head}};
+        m_axi_gmem_wstrb  = 16'h000F << {ring_wb_addr[3:2], 2'b00};
+        m_axi_gmem_bready = 1'b1;
+        if (m_axi_gmem_wready) next_state = S_HEAD_WB_RESP;
+      end
+
+      S_HEAD_WB_RESP: begin
+        m_axi_gmem_bready = 1'b1;
+        if (c_bresp_pending == 0 || (c_bresp_pending == 1 && m_axi_gmem_bvalid))
+          next_state = S_IDLE;
+      end
 
       default:
         next_state = S_IDLE;
@@ -0,0 +1,305 @@
+// Compute side of gemma_accelerator, in its own clock domain: the unpacked
+// operand tiles, the skewed array feed, the PE grid and the result packing.
+//
+// Everything arrives through one FIFO of operand entries written by the AXI
+// side, in order:
+//   OP_START  clear A, take this run's unpack geometry
+//   OP_A      one 128-bit A beat at tile beat index `beat`
+//   OP_B      one 128-bit B beat (fetched, or replayed from the weight cache)
+//   OP_RUN    compute with the tiles as they stand, then send C
+// A run without B beats reuses the weight tile left by the previous one.
+// C leaves as c_rows * OUT_ROW_BEATS packed beats through the result FIFO,
+// in the order the AXI write engine sends them.
+//
+// Tiles stream through the array back to back (west_last closes each tile,
+// there is no accumulator clear between runs). The feed and the result side
+// run independently: once a tile's last K element is fed, the next run's
+// entries are taken while the array and the result packing still finish the
+// previous tile. At most two tiles are open, and a new OP_RUN waits while a
+// tile is being sent, so the captured rows are packed before the next tile
+// can overwrite them. The result beats (four results per cycle) then bound a
+// tile to OUT_TILE_BEATS cycles.
+//
+// Scope: this removes the fill/drain bubble inside the array, not the gaps
+// between launches. A tile feeds for ARRAY_SIZE cycles but takes
+// OUT_TILE_BEATS cycles to leave, so even queued tiles keep the PEs busy at
+// most ARRAY_SIZE / OUT_TILE_BEATS of the time (25% at 16x16). And
+// gemma_accelerator runs fetch, compute and write-out of a launch in
+// sequence, so successive launches never overlap here. Full occupancy on
+// long GEMMs would need K accumulated on chip across launches, the next
+// launch's fetch overlapped with write-out, and a wider or double-buffered
+// result path; none of these is implemented.
+module gemma_compute_core #(
+  parameter integer ARRAY_SIZE = 16,
+  parameter integer DATA_WIDTH = 8,
+  parameter integer ACCUM_WIDTH = 32,
+  parameter integer DUAL_MAC = 0,
+  parameter integer BEAT_W = 8,             // Tile beat index width (gemma_accelerator's BEAT_W)
+  parameter integer OP_W = 2 + BEAT_W + 128
+)(
+  input  wire                  clk,
+  input  wire                  rst_n,       // Synchronous to clk
+
+  // Operand entries (first-word fall-through)
+  input  wire [OP_W-1:0]       op_data,
+  input  wire                  op_empty,
+  output wire                  op_pop,
+
+  // Packed result beats
+  output wire [127:0]          res_data,
+  output wire                  res_push,
+  input  wire                  res_full
+);
+
+  // Entry layout: {kind, beat, payload}
+  localparam [1:0]
+    OP_A     = 2'd0,
+    OP_B     = 2'd1,
+    OP_START = 2'd2,  // payload: [4:0] A bytes/beat, [12:8] B bytes/beat, [16 +: SIZE_W] A rows
+    OP_RUN   = 2'd3;  // payload: [0] trans_a, [1] trans_b, [16 +: SIZE_W] C rows
+
+  localparam integer BUS_BYTES      = 16;
+  localparam integer SIZE_W         = $clog2(ARRAY_SIZE + 1);
+  localparam integer OUT_ROW_BEATS  = ARRAY_SIZE * 4 / BUS_BYTES;
+  localparam integer OUT_TILE_BEATS = ARRAY_SIZE * OUT_ROW_BEATS;
+  localparam integer CYCLE_W        = $clog2(2 * ARRAY_SIZE) + 1;
+
+  wire [1:0]        op_kind    = op_data[OP_W-1 -: 2];
+  wire [BEAT_W-1:0] op_beat    = op_data[128 +: BEAT_W];
+  wire [127:0]      op_payload = op_data[127:0];
+
+  reg               feeding;                 // Skewed feed of the current tile in progress
+  reg  [1:0]        tiles_open;              // Tiles fed whose rows are not yet packed
+  reg               tile_ready;              // Oldest open tile has all its rows captured
+  reg               out_draining;            // Packed tile being sent
+  reg  [4:0]        a_beat_bytes, b_beat_bytes;
+  reg  [SIZE_W-1:0] a_rows;
+  reg  [SIZE_W-1:0] open_rows, next_rows;    // C rows of the open tiles, oldest first
+  reg  [SIZE_W-1:0] out_rows;                // C rows of the tile being sent
+  reg               trans_a, trans_b;
+
+  reg signed [DATA_WIDTH-1:0]  activation_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+  reg signed [DATA_WIDTH-1:0]  weight_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+
+  reg signed [DATA_WIDTH-1:0]  systolic_north_inputs [0:ARRAY_SIZE-1];
+  reg signed [DATA_WIDTH-1:0]  systolic_west_inputs [0:ARRAY_SIZE-1];
+  reg [ARRAY_SIZE-1:0]         systolic_north_valid;
+  reg [ARRAY_SIZE-1:0]         systolic_west_valid;
+  reg [ARRAY_SIZE-1:0]         systolic_west_last;
+  wire signed [ARRAY_SIZE*ARRAY_SIZE*ACCUM_WIDTH-1:0] systolic_results;
+  wire [ARRAY_SIZE-1:0]        systolic_row_done;
+  reg [CYCLE_W-1:0]            input_cycle_count;   // Lane i starts at i
+
+  reg signed [ACCUM_WIDTH-1:0] result_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+  reg [127:0]                  output_data_buffer [0:OUT_TILE_BEATS-1];
+  reg [BEAT_W-1:0]             out_beat;
+  wire [BEAT_W-1:0]            out_last_beat = out_rows * OUT_ROW_BEATS - 1;
+
+  // A new tile may enter the array once the previous tile's rows can no
+  // longer be overwritten before they are packed
+  wire run_ok   = (tiles_open == 2'd0) || (tiles_open == 2'd1 && !out_draining);
+  wire pack_now = tile_ready && !out_draining;
+
+  assign op_pop   = !feeding && !op_empty && (op_kind != OP_RUN || run_ok);
+  assign res_push = out_draining && !res_full;
+  assign res_data = output_data_buffer[out_beat];
+
+  wire run_pop  = op_pop && (op_kind == OP_RUN);
+  wire feed_end = feeding && (input_cycle_count == 2 * ARRAY_SIZE - 2);
+
+  // Sequencing
+  always @(posedge clk) begin
+    if (!rst_n) begin
+      feeding           <= 1'b0;
+      tiles_open        <= 2'd0;
+      tile_ready        <= 1'b0;
+      out_draining      <= 1'b0;
+      a_beat_bytes      <= BUS_BYTES;
+      b_beat_bytes      <= BUS_BYTES;
+      a_rows            <= ARRAY_SIZE;
+      open_rows         <= ARRAY_SIZE;
+      next_rows         <= ARRAY_SIZE;
+      out_rows          <= ARRAY_SIZE;
+      trans_a           <= 1'b0;
+      trans_b           <= 1'b0;
+      input_cycle_count <= {CYCLE_W{1'b0}};
+      out_beat          <= {BEAT_W{1'b0}};
+    end else begin
+      // Feed side: operand entries between tiles, then 2 * ARRAY_SIZE - 1
+      // cycles of skewed feed per tile
+      if (op_pop && op_kind == OP_START) begin
+        a_beat_bytes <= op_payload[4:0];
+        b_beat_bytes <= op_payload[12:8];
+        a_rows       <= op_payload[16 +: SIZE_W];
+      end
+
+      if (run_pop) begin
+        trans_a           <= op_payload[0];
+        trans_b           <= op_payload[1];
+        feeding           <= 1'b1;
+        input_cycle_count <= {CYCLE_W{1'b0}};
+      end else if (feeding) begin
+        input_cycle_count <= input_cycle_count + 1'b1;
+        if (feed_end)
+          feeding <= 1'b0;
+      end
+
+      // Result side: rows land in result_matrix as the array finishes them
+      // (the last row finishes last), the tile is packed once the previous
+      // one is sent
+      if (systolic_row_done[ARRAY_SIZE-1])
+        tile_ready <= 1'b1;
+      else if (pack_now)
+        tile_ready <= 1'b0;
+
+      tiles_open <= tiles_open + run_pop - pack_now;
+
+      if (pack_now) begin
+        out_rows     <= open_rows;
+        open_rows    <= next_rows;
+        out_beat     <= {BEAT_W{1'b0}};
+        out_draining <= 1'b1;
+      end else if (res_push) begin
+        out_beat <= out_beat + 1'b1;
+        if (out_beat == out_last_beat)
+          out_draining <= 1'b0;
+      end
+
+      if (run_pop) begin
+        if (tiles_open == 2'd0 || pack_now)
+          open_rows <= op_payload[16 +: SIZE_W];
+        else
+          next_rows <= op_payload[16 +: SIZE_W];
+      end
+    end
+  end
+
+  // Operand unpacking: lane l of beat n is element n * bytes + l of the
+  // row-major tile. Rows past ROWS are not sent, so A is cleared first.
+  integer unpack_i, unpack_j, unpack_e;
+  always @(posedge clk) begin
+    if (!rst_n) begin
+      for (unpack_i = 0; unpack_i < ARRAY_SIZE; unpack_i = unpack_i + 1)
+        for (unpack_j = 0; unpack_j < ARRAY_SIZE; unpack_j = unpack_j + 1) begin
+          activation_matrix[unpack_i][unpack_j] <= 8'd0;
+          weight_matrix[unpack_i][unpack_j] <= 8'd0;
+        end
+    end else if (op_pop) begin
+      case (op_kind)
+        OP_START:
+          for (unpack_i = 0; unpack_i < ARRAY_SIZE; unpack_i = unpack_i + 1)
+            for (unpack_j = 0; unpack_j < ARRAY_SIZE; unpack_j = unpack_j + 1)
+              activation_matrix[unpack_i][unpack_j] <= 8'd0;
+
+        OP_A:
+          for (unpack_j = 0; unpack_j < BUS_BYTES; unpack_j = unpack_j + 1) begin
+            unpack_e = op_beat * a_beat_bytes + unpack_j;
+            if (unpack_j < a_beat_bytes && unpack_e < a_rows * ARRAY_SIZE)
+              activation_matrix[unpack_e / ARRAY_SIZE][unpack_e % ARRAY_SIZE] <= $signed(op_payload[unpack_j*8 +: 8]);
+          end
+
+        OP_B:
+          for (unpack_j = 0; unpack_j < BUS_BYTES; unpack_j = unpack_j + 1) begin
+            unpack_e = op_beat * b_beat_bytes + unpack_j;
+            if (unpack_j < b_beat_bytes && unpack_e < ARRAY_SIZE * ARRAY_SIZE)
+              weight_matrix[unpack_e / ARRAY_SIZE][unpack_e % ARRAY_SIZE] <= $signed(op_payload[unpack_j*8 +: 8]);
+          end
+
+        default: ;
+      endcase
+    end
+  end
+
+  // Skewed feed: lane i carries K element input_cycle_count - i
+  integer skew_i;
+  always @(posedge clk) begin
+    if (!rst_n) begin
+      for (skew_i = 0; skew_i < ARRAY_SIZE; skew_i = skew_i + 1) begin
+        systolic_north_inputs[skew_i] <= 8'd0;
+        systolic_west_inputs[skew_i] <= 8'd0;
+      end
+      systolic_north_valid <= {ARRAY_SIZE{1'b0}};
+      systolic_west_valid <= {ARRAY_SIZE{1'b0}};
+      systolic_west_last <= {ARRAY_SIZE{1'b0}};
+    end else begin
+      for (skew_i = 0; skew_i < ARRAY_SIZE; skew_i = skew_i + 1) begin
+        if (feeding &&
+            input_cycle_count >= skew_i && (input_cycle_count - skew_i) < ARRAY_SIZE) begin
+          // Transposed operands are read column-wise from the unpacked tile
+          systolic_north_inputs[skew_i] <= trans_b ? weight_matrix[skew_i][input_cycle_count - skew_i]
+                                                   : weight_matrix[input_cycle_count - skew_i][skew_i];
+          systolic_west_inputs[skew_i] <= trans_a ? activation_matrix[input_cycle_count - skew_i][skew_i]
+                                                  : activation_matrix[skew_i][input_cycle_count - skew_i];
+          systolic_north_valid[skew_i] <= 1'b1;
+          systolic_west_valid[skew_i] <= 1'b1;
+          systolic_west_last[skew_i] <= (input_cycle_count - skew_i) == ARRAY_SIZE - 1;
+        end else begin
+          systolic_north_inputs[skew_i] <= 8'd0;
+          systolic_west_inputs[skew_i] <= 8'd0;
+          systolic_north_valid[skew_i] <= 1'b0;
+          systolic_west_valid[skew_i] <= 1'b0;
+          systolic_west_last[skew_i] <= 1'b0;
+        end
+      end
+    end
+  end
+
+  wire signed [ARRAY_SIZE*DATA_WIDTH-1:0] systolic_north_packed;
+  wire signed [ARRAY_SIZE*DATA_WIDTH-1:0] systolic_west_packed;
+
+  genvar g;
+  generate
+    for (g = 0; g < ARRAY_SIZE; g = g + 1) begin : pack_inputs
+      assign systolic_north_packed[(g+1)*DATA_WIDTH-1:g*DATA_WIDTH] = systolic_north_inputs[g];
+      assign systolic_west_packed[(g+1)*DATA_WIDTH-1:g*DATA_WIDTH] = systolic_west_inputs[g];
+    end
+  endgenerate
+
+  systolic_array_16x16 #(
+    .SIZE(ARRAY_SIZE),
+    .DATA_WIDTH(DATA_WIDTH),
+    .ACCUM_WIDTH(ACCUM_WIDTH),
+    .DUAL_MAC(DUAL_MAC)
+  ) systolic_array_inst (
+    .clk(clk),
+    .rst(~rst_n),
+    .accum_reset(1'b0),  // Each tile restarts on its west_last element
+    .north_inputs(systolic_north_packed),
+    .west_inputs(systolic_west_packed),
+    .north_valid(systolic_north_valid),
+    .west_valid(systolic_west_valid),
+    .west_last(systolic_west_last),
+    .result_matrix(systolic_results),
+    .row_done(systolic_row_done)
+  );
+
+  // Capture each row in the cycle the array reports it finished, whatever
+  // the feed is doing, then pack 4 x 32-bit results per beat, row by row
+  integer i, j;
+  always @(posedge clk) begin
+    if (!rst_n) begin
+      for (i = 0; i < ARRAY_SIZE; i = i + 1)
+        for (j = 0; j < ARRAY_SIZE; j = j + 1)
+          result_matrix[i][j] <= {ACCUM_WIDTH{1'b0}};
+      for (i = 0; i < OUT_TILE_BEATS; i = i + 1)
+        output_data_buffer[i] <= 128'd0;
+    end else begin
+      for (i = 0; i < ARRAY_SIZE; i = i + 1)
+        if (systolic_row_done[i])
+          for (j = 0; j < ARRAY_SIZE; j = j + 1)
+            result_matrix[i][j] <= systolic_results[(i*ARRAY_SIZE + j + 1)*ACCUM_WIDTH - 1 -: ACCUM_WIDTH];
+
+      if (pack_now) begin
+        for (i = 0; i < ARRAY_SIZE; i = i + 1)
+          for (j = 0; j < ARRAY_SIZE; j = j + 4)
+            output_data_buffer[i * OUT_ROW_BEATS + j/4] <= {
+              result_matrix[i][j+3],
+              result_matrix[i][j+2],
+              result_matrix[i][j+1],
+              result_matrix[i][j+0]
+            };
+      end
+    end
+  end
+
+endmodule
@@ -1,3 +1,8 @@
+// Tiles stream back to back: inp_last marks the final K element of a tile
+// (it travels east with the west operand). On that element the finished sum
+// moves to `result` and the accumulator restarts, so the next tile's first
+// element can follow on the very next cycle. `result` holds a tile until
+// the next one finishes; result_valid pulses when it changes.
 module pe_int8 #(
     parameter DATA_WIDTH = 8,
     parameter ACCUM_WIDTH = 32
@@ -8,27 +13,35 @@ module pe_int8 #(
     input valid,
     input  [DATA_WIDTH-1:0] inp_north,
     input  [DATA_WIDTH-1:0] inp_west,
+    input  inp_last,
     output reg  [DATA_WIDTH-1:0] outp_south,
     output reg  [DATA_WIDTH-1:0] outp_east,
+    output reg outp_last,
     output reg valid_out,
-    // output reg signed [ACCUM_WIDTH-1:0] result
-    (* use_dsp = "yes" *) output reg signed [ACCUM_WIDTH-1:0] result
+    output reg result_valid,
+    output reg signed [ACCUM_WIDTH-1:0] result
 );
     
-    // FIXED: Pipeline the valid signal to match data timing
-    reg valid_reg;
+    (* use_dsp = "yes" *) reg signed [ACCUM_WIDTH-1:0] accum;
+    wire signed [ACCUM_WIDTH-1:0] sum = accum + ($signed(inp_north) * $signed(inp_west));
     
     // FIXED: Accumulation logic - use the current cycle's valid signal
     always @(posedge clk) begin
         if (rst || accum_reset) begin
+            accum <= 0;
             result <= 0;
-        end else if (valid) begin  // Use current valid signal
-            // Accumulate whenever valid is high (including zero values)
-            // result <= result + (inp_north * inp_west);
-            result <= result + ($signed(inp_north) * $signed(inp_west));
-
+            result_valid <= 0;
+        end else begin
+            result_valid <= valid && inp_last;
+            if (valid) begin  // Use current valid signal
+                // Accumulate whenever valid is high (including zero values);
+                // the last element closes the tile and restarts the sum
+                accum <= inp_last ? {ACCUM_WIDTH{1'b0}} : sum;
+                if (inp_last)
+                    result <= sum;
+            end
         end
-        // If valid is 0, result holds its previous value
+        // If valid is 0, accum and result hold their previous values
     end
     
     // Data flow pipeline with pipelined valid signal
@@ -36,10 +49,12 @@ module pe_int8 #(
         if (rst) begin
             outp_south <= 0;
             outp_east <= 0;
+            outp_last <= 0;
             valid_out <= 0;
         end else begin
             outp_south <= inp_north;
             outp_east <= inp_west;
+            outp_last <= inp_last;
             valid_out <= valid;  // Pipeline the valid signal to match data timing
         end
     end
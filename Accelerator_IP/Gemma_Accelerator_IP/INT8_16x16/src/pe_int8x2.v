@@ -0,0 +1,114 @@
+// Dual-MAC processing element: two INT8 multiplies sharing the west
+// operand in one DSP multiplier (INT8 packing with sign correction).
+//
+// The two north operands are packed as w1 * 2^16 + w0 (25 bits signed, fits
+// the DSP48 A port) and multiplied by the shared activation in one 25x8
+// multiply:
+//   prod = a*w1 * 2^16 + a*w0
+// |a*w0| <= 2^14, so prod[15:0] is a*w0 exactly. The upper field is a*w1
+// minus the borrow of a negative low product, which is prod[15]:
+//   a*w1 = (prod >>> 16) + prod[15]
+// Both products are split every cycle and summed in their own accumulator,
+// so the results match two pe_int8 instances for any K (tb_systolic_dual_mac
+// compares 200 random tiles against DUAL_MAC = 0).
+//
+// Incomplete: the point of this PE is area, and the synthesis comparison
+// against pe_int8 (DSP48 and LUT count, Fmax) has not been run. Whether the
+// tools map a pair onto one DSP48 is unconfirmed, so DUAL_MAC = 1 stays
+// experimental until that report exists.
+//
+// Timing: replaces two adjacent pe_int8 columns, so the west operand has to
+// reach the next pair two cycles later (outp_east is registered twice) while
+// north operands move down one row per cycle, as in pe_int8. Tiles stream
+// back to back with inp_last, as in pe_int8.
+module pe_int8x2 #(
+    parameter DATA_WIDTH = 8,
+    parameter ACCUM_WIDTH = 32
+)(
+    input clk,
+    input rst,
+    input accum_reset,
+    input valid,
+    input  [DATA_WIDTH-1:0] inp_north0,
+    input  [DATA_WIDTH-1:0] inp_north1,
+    input  [DATA_WIDTH-1:0] inp_west,
+    input  inp_last,
+    output reg  [DATA_WIDTH-1:0] outp_south0,
+    output reg  [DATA_WIDTH-1:0] outp_south1,
+    output reg  [DATA_WIDTH-1:0] outp_east,
+    output reg outp_last,
+    output reg valid_south,
+    output reg valid_east,
+    output reg result_valid,
+    output reg signed [ACCUM_WIDTH-1:0] result0,
+    output reg signed [ACCUM_WIDTH-1:0] result1
+);
+
+    localparam PACK_SHIFT = 2 * DATA_WIDTH;                 // Low product field width
+    localparam PACK_WIDTH = PACK_SHIFT + DATA_WIDTH + 1;    // 25 bits for INT8
+    localparam PROD_WIDTH = PACK_WIDTH + DATA_WIDTH;
+
+    // w1 * 2^16 + w0, with w0 sign-extended into the upper field
+    wire signed [PACK_WIDTH-1:0] packed_w =
+        ($signed(inp_north1) <<< PACK_SHIFT) + $signed(inp_north0);
+
+    (* use_dsp = "yes" *) wire signed [PROD_WIDTH-1:0] prod = packed_w * $signed(inp_west);
+
+    wire signed [PACK_SHIFT-1:0]            prod_lo = prod[PACK_SHIFT-1:0];
+    wire signed [PROD_WIDTH-PACK_SHIFT-1:0] prod_hi = prod[PROD_WIDTH-1:PACK_SHIFT];
+
+    reg [DATA_WIDTH-1:0] west_d;
+    reg                  last_d;
+    reg                  valid_d;
+
+    reg signed [ACCUM_WIDTH-1:0] accum0, accum1;
+    wire signed [ACCUM_WIDTH-1:0] sum0 = accum0 + prod_lo;
+    // Correction enters as the carry-in of the accumulator add
+    // (zero-extended as signed so prod_hi keeps its sign)
+    wire signed [ACCUM_WIDTH-1:0] sum1 = accum1 + prod_hi + $signed({1'b0, prod[PACK_SHIFT-1]});
+
+    always @(posedge clk) begin
+        if (rst || accum_reset) begin
+            accum0 <= 0;
+            accum1 <= 0;
+            result0 <= 0;
+            result1 <= 0;
+            result_valid <= 0;
+        end else begin
+            result_valid <= valid && inp_last;
+            if (valid) begin
+                accum0 <= inp_last ? {ACCUM_WIDTH{1'b0}} : sum0;
+                accum1 <= inp_last ? {ACCUM_WIDTH{1'b0}} : sum1;
+                if (inp_last) begin
+                    result0 <= sum0;
+                    result1 <= sum1;
+                end
+            end
+        end
+    end
+
+    // North lanes advance one row per cycle; west takes two stages per pair
+    always @(posedge clk) begin
+        if (rst) begin
+            outp_south0 <= 0;
+            outp_south1 <= 0;
+            west_d <= 0;
+            outp_east <= 0;
+            last_d <= 0;
+            outp_last <= 0;
+            valid_d <= 0;
+            valid_south <= 0;
+            valid_east <= 0;
+        end else begin
+            outp_south0 <= inp_north0;
+            outp_south1 <= inp_north1;
+            west_d <= inp_west;
+            outp_east <= west_d;
+            last_d <= inp_last;
+            outp_last <= last_d;
+            valid_d <= valid;
+            valid_south <= valid;
+            valid_east <= valid_d;
+        end
+    end
+endmodule
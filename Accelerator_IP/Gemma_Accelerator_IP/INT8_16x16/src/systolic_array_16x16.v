@@ -11,7 +11,14 @@ module systolic_array_16x16 #(
 
     // Parameter: ACCUM_WIDTH
     // The bit width of the accumulator result (must match the PE).
-    parameter integer ACCUM_WIDTH = 32  // Must match the PE internals
+    parameter integer ACCUM_WIDTH = 32, // Must match the PE internals
+
+    // Parameter: DUAL_MAC
+    // 1 builds each pair of columns from one pe_int8x2, which packs both
+    // multiplies into one 25x8 multiply so a pair can map onto one DSP48.
+    // Experimental: no synthesis report yet (see pe_int8x2.v).
+    // Requires an even SIZE; same interface, latency and results as 0.
+    parameter integer DUAL_MAC = 0
 ) (
     // System-level signals
     input  wire                               clk,
@@ -26,13 +33,22 @@ module systolic_array_16x16 #(
     input  wire [SIZE-1:0]                    north_valid,
     input  wire [SIZE-1:0]                    west_valid,
 
-    // Packed 1D output result vector: SIZE*SIZE*ACCUM_WIDTH bits
-    output wire signed [SIZE*SIZE*ACCUM_WIDTH-1:0] result_matrix
+    // Marks each west lane's final K element of a tile. The next tile's
+    // skewed inputs may follow immediately: no accum_reset or drain between
+    // tiles is needed.
+    input  wire [SIZE-1:0]                    west_last,
+
+    // Packed 1D output result vector: SIZE*SIZE*ACCUM_WIDTH bits. Row r of
+    // the last finished tile is stable in the cycle row_done[r] is high
+    // (rows finish one per cycle, row 0 first).
+    output wire signed [SIZE*SIZE*ACCUM_WIDTH-1:0] result_matrix,
+    output wire [SIZE-1:0]                    row_done
 );
 
     // Internal 2D nets for data and valids
     wire signed [DATA_WIDTH-1:0] north_to_south  [0:SIZE][0:SIZE-1];
     wire signed [DATA_WIDTH-1:0] west_to_east    [0:SIZE-1][0:SIZE];
+    wire                         last_to_east    [0:SIZE-1][0:SIZE];
     wire signed [ACCUM_WIDTH-1:0] pe_results     [0:SIZE-1][0:SIZE-1];
 
     // FIXED: Pipelined valid signals - these will be driven by PE valid_out
@@ -54,43 +70,129 @@ module systolic_array_16x16 #(
       for (r = 0; r < SIZE; r = r + 1) begin : UNPACK_WEST
         assign west_to_east[r][0] = west_inputs[r*DATA_WIDTH +: DATA_WIDTH];
         assign west_valid_to_east[r][0] = west_valid[r];
+        assign last_to_east[r][0] = west_last[r];
       end
     endgenerate
 
     // Instantiate the PE grid
     generate
-      for (r = 0; r < SIZE; r = r + 1) begin : ROW
-        for (c = 0; c < SIZE; c = c + 1) begin : COL
+      if (DUAL_MAC == 0) begin : SINGLE
+        for (r = 0; r < SIZE; r = r + 1) begin : ROW
+          for (c = 0; c < SIZE; c = c + 1) begin : COL
+          
+            // Create wires for the valid outputs of this PE
+            wire pe_valid_out;
+            wire pe_result_valid;
           
-          // Create wires for the valid outputs of this PE
-          wire pe_valid_out;
+            pe_int8 #(
+              .DATA_WIDTH  (DATA_WIDTH),
+              .ACCUM_WIDTH (ACCUM_WIDTH)
+            ) pe_inst (
+              .clk         (clk),
+              .rst         (rst),
+              .accum_reset (accum_reset),
+              // FIXED: Use properly synchronized valid signals
+              .valid       (north_valid_to_south[r][c] & west_valid_to_east[r][c]),
+              .inp_north   (north_to_south[r][c]),
+              .inp_west    (west_to_east[r][c]),
+              .inp_last    (last_to_east[r][c]),
+              .outp_south  (north_to_south[r+1][c]),
+              .outp_east   (west_to_east[r][c+1]),
+              .outp_last   (last_to_east[r][c+1]),
+              .valid_out   (pe_valid_out),
+              .result_valid(pe_result_valid),
+              .result      (pe_results[r][c])
+            );
           
-          pe_int8 #(
-            .DATA_WIDTH  (DATA_WIDTH),
-            .ACCUM_WIDTH (ACCUM_WIDTH)
-          ) pe_inst (
-            .clk         (clk),
-            .rst         (rst),
-            .accum_reset (accum_reset),
-            // FIXED: Use properly synchronized valid signals
-            .valid       (north_valid_to_south[r][c] & west_valid_to_east[r][c]),
-            .inp_north   (north_to_south[r][c]),
-            .inp_west    (west_to_east[r][c]),
-            .outp_south  (north_to_south[r+1][c]),
-            .outp_east   (west_to_east[r][c+1]),
-            .valid_out   (pe_valid_out),
-            .result      (pe_results[r][c])
-          );
+            // FIXED: Connect the pipelined valid signal to both directions
+            // This ensures the valid signal follows the same timing as the data
+            if (r < SIZE-1) begin : CONNECT_SOUTH_VALID
+              assign north_valid_to_south[r+1][c] = pe_valid_out;
+            end
+            if (c < SIZE-1) begin : CONNECT_EAST_VALID  
+              assign west_valid_to_east[r][c+1] = pe_valid_out;
+            end
+            // The row's last PE finishes last
+            if (c == SIZE-1) begin : CONNECT_ROW_DONE
+              assign row_done[r] = pe_result_valid;
+            end
           
-          // FIXED: Connect the pipelined valid signal to both directions
-          // This ensures the valid signal follows the same timing as the data
-          if (r < SIZE-1) begin : CONNECT_SOUTH_VALID
-            assign north_valid_to_south[r+1][c] = pe_valid_out;
           end
-          if (c < SIZE-1) begin : CONNECT_EAST_VALID  
-            assign west_valid_to_east[r][c+1] = pe_valid_out;
+        end
+      end else begin : DUAL
+        // Column pair p = (2p, 2p+1) shares one west operand. The west operand
+        // spends two cycles per pair, so it enters one cycle late and column
+        // 2p is held one cycle to meet column 2p+1: every product then meets
+        // at the same time as in the single-MAC grid (column 2p+1's valid
+        // covers both lanes).
+        reg signed [DATA_WIDTH-1:0] west_d  [0:SIZE-1];
+        reg                         west_vd [0:SIZE-1];
+        reg                         west_ld [0:SIZE-1];
+        reg signed [DATA_WIDTH-1:0] north_d  [0:SIZE/2-1];
+        wire signed [DATA_WIDTH-1:0] pair_west  [0:SIZE-1][0:SIZE/2];
+        wire                         pair_west_v [0:SIZE-1][0:SIZE/2];
+        wire                         pair_last   [0:SIZE-1][0:SIZE/2];
+        wire                         pair_done   [0:SIZE-1][0:SIZE/2-1];
+        wire signed [DATA_WIDTH-1:0] pair_north0 [0:SIZE][0:SIZE/2-1];
+        wire signed [DATA_WIDTH-1:0] pair_north1 [0:SIZE][0:SIZE/2-1];
+        wire                         pair_north_v [0:SIZE][0:SIZE/2-1];
+
+        for (r = 0; r < SIZE; r = r + 1) begin : WEST_ALIGN
+          always @(posedge clk) begin
+            if (rst) begin
+              west_d[r]  <= 0;
+              west_vd[r] <= 1'b0;
+              west_ld[r] <= 1'b0;
+            end else begin
+              west_d[r]  <= west_to_east[r][0];
+              west_vd[r] <= west_valid_to_east[r][0];
+              west_ld[r] <= last_to_east[r][0];
+            end
+          end
+          assign pair_west[r][0]   = west_d[r];
+          assign pair_west_v[r][0] = west_vd[r];
+          assign pair_last[r][0]   = west_ld[r];
+          assign row_done[r]       = pair_done[r][SIZE/2-1];
+        end
+
+        for (c = 0; c < SIZE/2; c = c + 1) begin : NORTH_ALIGN
+          always @(posedge clk) begin
+            if (rst) begin
+              north_d[c] <= 0;
+            end else begin
+              north_d[c] <= north_to_south[0][2*c];
+            end
+          end
+          assign pair_north0[0][c]  = north_d[c];
+          assign pair_north1[0][c]  = north_to_south[0][2*c+1];
+          assign pair_north_v[0][c] = north_valid_to_south[0][2*c+1];
+        end
+
+        for (r = 0; r < SIZE; r = r + 1) begin : ROW
+          for (c = 0; c < SIZE/2; c = c + 1) begin : PAIR
+            pe_int8x2 #(
+              .DATA_WIDTH  (DATA_WIDTH),
+              .ACCUM_WIDTH (ACCUM_WIDTH)
+            ) pe_inst (
+              .clk         (clk),
+              .rst         (rst),
+              .accum_reset (accum_reset),
+              .valid       (pair_north_v[r][c] & pair_west_v[r][c]),
+              .inp_north0  (pair_north0[r][c]),
+              .inp_north1  (pair_north1[r][c]),
+              .inp_west    (pair_west[r][c]),
+              .inp_last    (pair_last[r][c]),
+              .outp_south0 (pair_north0[r+1][c]),
+              .outp_south1 (pair_north1[r+1][c]),
+              .outp_east   (pair_west[r][c+1]),
+              .outp_last   (pair_last[r][c+1]),
+              .valid_south (pair_north_v[r+1][c]),
+              .valid_east  (pair_west_v[r][c+1]),
+              .result_valid(pair_done[r][c]),
+              .result0     (pe_results[r][2*c]),
+              .result1     (pe_results[r][2*c+1])
+            );
           end
-          
         end
       end
     endgenerate
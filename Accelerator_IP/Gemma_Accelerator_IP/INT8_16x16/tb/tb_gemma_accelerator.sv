@@ -583,20 +583,24 @@ module gemma_accelerator_tb;
   localparam [63:0] ADDR_C      = 64'h00023000;
 
   localparam [5:0]  ADDR_CTRL   = 6'h00;
-  localparam [5:0]  ADDR_STATUS = 6'h04;
+  localparam [5:0]  ADDR_STATUS = 6'h00;
   localparam [5:0]  A_LSB       = 6'h10;
   localparam [5:0]  A_MSB       = 6'h14;
-  localparam [5:0]  B_LSB       = 6'h18;
-  localparam [5:0]  B_MSB       = 6'h1C;
-  localparam [5:0]  C_LSB       = 6'h20;
-  localparam [5:0]  C_MSB       = 6'h24;
+  localparam [5:0]  B_LSB       = 6'h1C;
+  localparam [5:0]  B_MSB       = 6'h20;
+  localparam [5:0]  C_LSB       = 6'h28;
+  localparam [5:0]  C_MSB       = 6'h2C;
 
   //-------------------------------------------------------------------------
   // TB state
   //-------------------------------------------------------------------------
   reg  [7:0] read_count, write_count;
   reg        rd_a, rd_b;
+  reg  [7:0] rd_len;
+  integer    rd_off, wr_off;
   integer    errors;
+  integer    bad_addr;   // Bursts outside the A/B/C regions
+  integer    init_i;
 
   //-------------------------------------------------------------------------
   // DUT instantiation
@@ -605,7 +609,7 @@ module gemma_accelerator_tb;
     .ID_WIDTH           (ID_WIDTH),
     .BUFFER_DEPTH       (BUFFER_DEPTH),
     .BUFFER_ADDR_WIDTH  (BUFFER_ADDR_WIDTH),
-    .SYSTOLIC_SIZE      (SYSTOLIC_SIZE),
+    .ARRAY_SIZE         (SYSTOLIC_SIZE),
     .DATA_WIDTH         (DATA_WIDTH),
     .ACCUM_WIDTH        (ACCUM_WIDTH)
   ) dut (
@@ -849,16 +853,16 @@ module gemma_accelerator_tb;
       mat_b[248]= 8'd165; mat_b[249]= 8'd10;  mat_b[250]= 8'd32;  mat_b[251]= 8'd119;
       mat_b[252]= 8'd123; mat_b[253]= 8'd159; mat_b[254]= 8'd81;  mat_b[255]= 8'd209;
 
-//      //------ Compute golden C = A×B ------//
-//      for (r = 0; r < MATRIX_SIZE; r = r + 1) begin
-//        for (c = 0; c < MATRIX_SIZE; c = c + 1) begin
-//          sum = 0;
-//          for (k = 0; k < MATRIX_SIZE; k = k + 1) begin
-//            sum = sum + mat_a[r*MATRIX_SIZE + k] * mat_b[k*MATRIX_SIZE + c];
-//          end
-//          mat_c_exp[r*MATRIX_SIZE + c] = sum;
-//        end
-//      end
+      //------ Compute golden C = A×B ------//
+      for (r = 0; r < MATRIX_SIZE; r = r + 1) begin
+        for (c = 0; c < MATRIX_SIZE; c = c + 1) begin
+          sum = 0;
+          for (k = 0; k < MATRIX_SIZE; k = k + 1) begin
+            sum = sum + mat_a[r*MATRIX_SIZE + k] * mat_b[k*MATRIX_SIZE + c];
+          end
+          mat_c_exp[r*MATRIX_SIZE + c] = sum;
+        end
+      end
     end
   endtask
 
@@ -907,7 +911,8 @@ module gemma_accelerator_tb;
 
 
   //-------------------------------------------------------------------------
-// AXI read-response model
+// AXI read-response model: decodes araddr into the A or B region, so a base
+// programmed at the wrong offset reads as an error instead of as mat_b
 //-------------------------------------------------------------------------
  integer next_base, j;
  integer base, i;
@@ -923,23 +928,40 @@ always @(posedge ap_clk) begin
     read_count         <= 0;
     rd_a               <= 0;
     rd_b               <= 0;
+    rd_len             <= 0;
+    rd_off             <= 0;
   end else begin
-    // AR handshake + start R burst
-    if (m_axi_gmem_arvalid && !m_axi_gmem_arready) begin
+    // AR handshake + start R burst (one burst at a time: the weight request
+    // issued during the activation burst waits for its last beat)
+    if (m_axi_gmem_arvalid && !m_axi_gmem_arready && !m_axi_gmem_rvalid) begin
       m_axi_gmem_arready <= 1;
       m_axi_gmem_rid     <= m_axi_gmem_arid;
       read_count         <= 0;
-      rd_a               <= (m_axi_gmem_araddr == ADDR_A);
-      rd_b               <= (m_axi_gmem_araddr == ADDR_B);
+      rd_len             <= m_axi_gmem_arlen;
+      rd_a               <= (m_axi_gmem_araddr >= ADDR_A && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_A + NUM_ELEMENTS);
+      rd_b               <= (m_axi_gmem_araddr >= ADDR_B && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_B + NUM_ELEMENTS);
       m_axi_gmem_rvalid  <= 1;
-      
-      // Load first beat data immediately
 
-      base = 0;
-      for (i = 0; i < 16; i = i + 1) begin
-        m_axi_gmem_rdata[i*8 +: 8] <= (m_axi_gmem_araddr == ADDR_A) ? mat_a[i] : mat_b[i];
+      // Load first beat data immediately
+      if (m_axi_gmem_araddr >= ADDR_A && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_A + NUM_ELEMENTS) begin
+        base = m_axi_gmem_araddr - ADDR_A;
+        for (i = 0; i < 16; i = i + 1)
+          m_axi_gmem_rdata[i*8 +: 8] <= mat_a[base + i];
+        m_axi_gmem_rresp <= 2'b00;
+      end else if (m_axi_gmem_araddr >= ADDR_B && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_B + NUM_ELEMENTS) begin
+        base = m_axi_gmem_araddr - ADDR_B;
+        for (i = 0; i < 16; i = i + 1)
+          m_axi_gmem_rdata[i*8 +: 8] <= mat_b[base + i];
+        m_axi_gmem_rresp <= 2'b00;
+      end else begin
+        $display("ERR: read burst at 0x%0h (len %0d) outside A and B", m_axi_gmem_araddr, m_axi_gmem_arlen + 1);
+        bad_addr = bad_addr + 1;
+        base = 0;
+        m_axi_gmem_rdata <= 128'd0;
+        m_axi_gmem_rresp <= 2'b10;
       end
-      m_axi_gmem_rlast <= (8'd0 == 8'd15);  // Check if single beat transfer
+      rd_off           <= base;
+      m_axi_gmem_rlast <= (m_axi_gmem_arlen == 8'd0);  // Single beat transfer
     end else begin
       m_axi_gmem_arready <= 0;
     end
@@ -953,21 +975,21 @@ always @(posedge ap_clk) begin
       end else begin
         // Advance to next beat
         read_count <= read_count + 1;
-        
-        // Prepare next beat data
 
-        next_base = (read_count + 1) * 16;
+        // Prepare next beat data
+        next_base = rd_off + (read_count + 1) * 16;
         for (j = 0; j < 16; j = j + 1) begin
-          m_axi_gmem_rdata[j*8 +: 8] <= rd_a ? mat_a[next_base + j] : mat_b[next_base + j];
+          m_axi_gmem_rdata[j*8 +: 8] <= rd_a ? mat_a[next_base + j] : rd_b ? mat_b[next_base + j] : 8'd0;
         end
-        m_axi_gmem_rlast <= ((read_count + 1) == 8'd15);  // Check if next beat is last
+        m_axi_gmem_rlast <= ((read_count + 1) == rd_len);  // Check if next beat is last
       end
     end
   end
 end
 
   //-------------------------------------------------------------------------
-  // AXI write-response model (unchanged)
+  // AXI write-response model: results land at (awaddr - ADDR_C) / 4, so C
+  // written anywhere else is caught
   //-------------------------------------------------------------------------
   always @(posedge ap_clk) begin
     if (!ap_rst_n) begin
@@ -977,11 +999,21 @@ end
       m_axi_gmem_bresp   <= 2'b00;
       m_axi_gmem_bid     <= 0;
       write_count        <= 0;
+      wr_off             <= 0;
     end else begin
       if (m_axi_gmem_awvalid && !m_axi_gmem_awready) begin
         m_axi_gmem_awready <= 1;
         m_axi_gmem_bid     <= m_axi_gmem_awid;
         write_count        <= 0;
+        if (m_axi_gmem_awaddr >= ADDR_C && m_axi_gmem_awaddr + (m_axi_gmem_awlen + 1) * 16 <= ADDR_C + 4 * NUM_ELEMENTS) begin
+          wr_off          <= (m_axi_gmem_awaddr - ADDR_C) / 4;
+          m_axi_gmem_bresp <= 2'b00;
+        end else begin
+          $display("ERR: write burst at 0x%0h (len %0d) outside C", m_axi_gmem_awaddr, m_axi_gmem_awlen + 1);
+          bad_addr = bad_addr + 1;
+          wr_off          <= -1;
+          m_axi_gmem_bresp <= 2'b10;
+        end
       end else begin
         m_axi_gmem_awready <= 0;
       end
@@ -991,11 +1023,11 @@ end
 
       if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
         integer base, i;
-        base = write_count * 8;
-        for (i = 0; i < 8; i = i + 1) begin
-          mat_c_act[base + i] = {{16{m_axi_gmem_wdata[i*16+15]}},
-                                 m_axi_gmem_wdata[i*16 +:16]};
-        end
+        base = wr_off + write_count * 4;
+        if (wr_off >= 0)
+          for (i = 0; i < 4; i = i + 1)
+            if (m_axi_gmem_wstrb[i*4])
+              mat_c_act[base + i] = m_axi_gmem_wdata[i*32 +: 32];
         if (m_axi_gmem_wlast) begin
           m_axi_gmem_wready <= 0;
           m_axi_gmem_bvalid <= 1;
@@ -1046,6 +1078,10 @@ end
           errors = errors + 1;
         end
       end
+      if (bad_addr != 0) begin
+        $display("ERR: %0d bursts outside the programmed A/B/C regions", bad_addr);
+        errors = errors + bad_addr;
+      end
       if (errors == 0)
         $display("+++ PASS: all outputs match");
       else
@@ -1063,10 +1099,13 @@ end
     s_axi_control_bready  = 0;
     s_axi_control_arvalid = 0;
     s_axi_control_rready  = 0;
+    bad_addr             = 0;
     #100;
     ap_rst_n = 1;
 
     init_matrices();
+    for (init_i = 0; init_i < NUM_ELEMENTS; init_i = init_i + 1)
+      mat_c_act[init_i] = 32'hDEADBEEF;  // Unwritten results fail the compare
 
     // Program A, B, C bases
     axi_lite_wr(A_LSB, ADDR_A[31:0]);
@@ -0,0 +1,341 @@
+`timescale 1ns / 1ps
+
+// gemma_accelerator against a DDR-like AXI slave: every read burst returns
+// its first beat RD_LATENCY cycles after its AR handshake, every write
+// response comes WR_LATENCY cycles after the burst's last W beat, and
+// requests are accepted while earlier ones are still in flight (returned in
+// order). Dense, strided, short (ROWS) and weight-reuse launches are checked
+// against a reference product and timed from start to DONE twice: with one
+// request in flight at a time (the slave holds AR/AW until the previous
+// burst has completed, as the engine used to run) and with up to
+// MAX_OUTSTANDING.
+module tb_gemma_axi_latency;
+
+  localparam integer SIZE            = 16;
+  localparam integer ID_WIDTH        = 12;
+  localparam integer RD_LATENCY      = 40;
+  localparam integer WR_LATENCY      = 30;
+  localparam integer MAX_OUTSTANDING = 32;
+  localparam integer MEM_BYTES       = 64 * 1024;
+
+  reg ap_clk = 0;
+  reg ap_rst_n = 0;
+  always #5 ap_clk = ~ap_clk;
+
+  integer cycle = 0;
+  always @(posedge ap_clk) cycle <= cycle + 1;
+
+  // AXI-Lite control port
+  reg         s_axi_control_awvalid = 0;
+  wire        s_axi_control_awready;
+  reg  [7:0]  s_axi_control_awaddr = 0;
+  reg         s_axi_control_wvalid = 0;
+  wire        s_axi_control_wready;
+  reg  [31:0] s_axi_control_wdata = 0;
+  wire        s_axi_control_bvalid;
+  reg         s_axi_control_bready = 0;
+  wire [1:0]  s_axi_control_bresp;
+  wire [0:0]  s_axi_control_bid;
+  reg         s_axi_control_arvalid = 0;
+  wire        s_axi_control_arready;
+  reg  [7:0]  s_axi_control_araddr = 0;
+  wire        s_axi_control_rvalid;
+  reg         s_axi_control_rready = 0;
+  wire [31:0] s_axi_control_rdata;
+  wire [1:0]  s_axi_control_rresp;
+  wire [0:0]  s_axi_control_rid;
+
+  // AXI4 master port
+  wire [ID_WIDTH-1:0] m_axi_gmem_awid, m_axi_gmem_arid;
+  wire                m_axi_gmem_awvalid, m_axi_gmem_wvalid, m_axi_gmem_wlast, m_axi_gmem_bready;
+  wire                m_axi_gmem_arvalid, m_axi_gmem_rready;
+  wire [63:0]         m_axi_gmem_awaddr, m_axi_gmem_araddr;
+  wire [7:0]          m_axi_gmem_awlen, m_axi_gmem_arlen;
+  wire [2:0]          m_axi_gmem_awsize, m_axi_gmem_arsize;
+  wire [1:0]          m_axi_gmem_awburst, m_axi_gmem_arburst;
+  wire [127:0]        m_axi_gmem_wdata;
+  wire [15:0]         m_axi_gmem_wstrb;
+  reg                 m_axi_gmem_awready = 0, m_axi_gmem_wready = 0, m_axi_gmem_bvalid = 0;
+  reg                 m_axi_gmem_arready = 0, m_axi_gmem_rvalid = 0, m_axi_gmem_rlast = 0;
+  reg  [127:0]        m_axi_gmem_rdata = 0;
+
+  gemma_accelerator #(.ID_WIDTH(ID_WIDTH), .ARRAY_SIZE(SIZE)) dut (
+    .ap_clk(ap_clk), .ap_rst_n(ap_rst_n),
+    .s_axi_control_awvalid(s_axi_control_awvalid), .s_axi_control_awready(s_axi_control_awready),
+    .s_axi_control_awaddr(s_axi_control_awaddr),
+    .s_axi_control_wvalid(s_axi_control_wvalid), .s_axi_control_wready(s_axi_control_wready),
+    .s_axi_control_wdata(s_axi_control_wdata), .s_axi_control_wstrb(4'hF),
+    .s_axi_control_bvalid(s_axi_control_bvalid), .s_axi_control_bready(s_axi_control_bready),
+    .s_axi_control_bresp(s_axi_control_bresp), .s_axi_control_awid(1'b0), .s_axi_control_bid(s_axi_control_bid),
+    .s_axi_control_arvalid(s_axi_control_arvalid), .s_axi_control_arready(s_axi_control_arready),
+    .s_axi_control_araddr(s_axi_control_araddr),
+    .s_axi_control_rvalid(s_axi_control_rvalid), .s_axi_control_rready(s_axi_control_rready),
+    .s_axi_control_rdata(s_axi_control_rdata), .s_axi_control_rresp(s_axi_control_rresp),
+    .s_axi_control_arid(1'b0), .s_axi_control_rid(s_axi_control_rid),
+    .m_axi_gmem_awid(m_axi_gmem_awid), .m_axi_gmem_bid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_awvalid(m_axi_gmem_awvalid), .m_axi_gmem_awready(m_axi_gmem_awready),
+    .m_axi_gmem_awaddr(m_axi_gmem_awaddr), .m_axi_gmem_awlen(m_axi_gmem_awlen),
+    .m_axi_gmem_awsize(m_axi_gmem_awsize), .m_axi_gmem_awburst(m_axi_gmem_awburst),
+    .m_axi_gmem_wvalid(m_axi_gmem_wvalid), .m_axi_gmem_wready(m_axi_gmem_wready),
+    .m_axi_gmem_wdata(m_axi_gmem_wdata), .m_axi_gmem_wstrb(m_axi_gmem_wstrb), .m_axi_gmem_wlast(m_axi_gmem_wlast),
+    .m_axi_gmem_bvalid(m_axi_gmem_bvalid), .m_axi_gmem_bready(m_axi_gmem_bready), .m_axi_gmem_bresp(2'b00),
+    .m_axi_gmem_arid(m_axi_gmem_arid), .m_axi_gmem_rid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_arvalid(m_axi_gmem_arvalid), .m_axi_gmem_arready(m_axi_gmem_arready),
+    .m_axi_gmem_araddr(m_axi_gmem_araddr), .m_axi_gmem_arlen(m_axi_gmem_arlen),
+    .m_axi_gmem_arsize(m_axi_gmem_arsize), .m_axi_gmem_arburst(m_axi_gmem_arburst),
+    .m_axi_gmem_rvalid(m_axi_gmem_rvalid), .m_axi_gmem_rready(m_axi_gmem_rready),
+    .m_axi_gmem_rdata(m_axi_gmem_rdata), .m_axi_gmem_rlast(m_axi_gmem_rlast), .m_axi_gmem_rresp(2'b00)
+  );
+
+  // ---------------------------------------------------------------------
+  // Memory slave: byte array behind in-order AR/AW queues
+  // ---------------------------------------------------------------------
+  reg [7:0] mem [0:MEM_BYTES-1];
+
+  reg [63:0] ar_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  ar_len   [0:MAX_OUTSTANDING-1];
+  integer    ar_ready_at [0:MAX_OUTSTANDING-1];
+  integer    ar_head = 0, ar_tail = 0, ar_count = 0;
+  integer    r_beat = 0;
+
+  reg [63:0] aw_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  aw_len   [0:MAX_OUTSTANDING-1];
+  integer    aw_head = 0, aw_tail = 0, aw_count = 0;
+  integer    w_beat = 0;
+  integer    b_due   [0:MAX_OUTSTANDING-1];
+  integer    b_head = 0, b_tail = 0, b_count = 0;
+
+  integer    outstanding = MAX_OUTSTANDING;  // Requests the slave accepts in flight
+
+  // Per-launch statistics
+  integer    rd_bursts, rd_beats, wr_bursts, wr_beats, peak_reads;
+  integer    errors = 0;
+
+  integer l;
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      m_axi_gmem_arready <= 0; m_axi_gmem_rvalid <= 0; m_axi_gmem_rlast <= 0;
+      m_axi_gmem_awready <= 0; m_axi_gmem_wready <= 0; m_axi_gmem_bvalid <= 0;
+    end else begin
+      // AR: one request per cycle while the queue has room
+      m_axi_gmem_arready <= (ar_count + (m_axi_gmem_arvalid && m_axi_gmem_arready) < outstanding);
+      if (m_axi_gmem_arvalid && m_axi_gmem_arready) begin
+        if (m_axi_gmem_arsize != 3'b100 || m_axi_gmem_arburst != 2'b01 ||
+            (m_axi_gmem_araddr[11:0] + (m_axi_gmem_arlen + 1) * 16 > 4096)) begin
+          $display("ERROR: bad read burst addr %h len %0d", m_axi_gmem_araddr, m_axi_gmem_arlen);
+          errors = errors + 1;
+        end
+        ar_addr[ar_tail] = m_axi_gmem_araddr;
+        ar_len[ar_tail] = m_axi_gmem_arlen;
+        ar_ready_at[ar_tail] = cycle + RD_LATENCY;
+        ar_tail = (ar_tail + 1) % MAX_OUTSTANDING;
+        ar_count = ar_count + 1;
+        rd_bursts = rd_bursts + 1;
+        if (ar_count > peak_reads) peak_reads = ar_count;
+      end
+
+      // R: the head burst streams once its latency has elapsed
+      if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+        rd_beats = rd_beats + 1;
+        if (m_axi_gmem_rlast) begin
+          r_beat = 0;
+          ar_head = (ar_head + 1) % MAX_OUTSTANDING;
+          ar_count = ar_count - 1;
+        end else
+          r_beat = r_beat + 1;
+      end
+      if (ar_count > 0 && cycle >= ar_ready_at[ar_head] && (!m_axi_gmem_rvalid || m_axi_gmem_rready)) begin
+        for (l = 0; l < 16; l = l + 1)
+          m_axi_gmem_rdata[l*8 +: 8] <= mem[ar_addr[ar_head] + r_beat * 16 + l];
+        m_axi_gmem_rvalid <= 1;
+        m_axi_gmem_rlast  <= (r_beat == ar_len[ar_head]);
+      end else if (m_axi_gmem_rready) begin
+        m_axi_gmem_rvalid <= 0;
+        m_axi_gmem_rlast  <= 0;
+      end
+
+      // AW/W: data goes to the oldest open burst; B is due WR_LATENCY later
+      m_axi_gmem_awready <= (aw_count + b_count + (m_axi_gmem_awvalid && m_axi_gmem_awready) < outstanding);
+      if (m_axi_gmem_awvalid && m_axi_gmem_awready) begin
+        if (m_axi_gmem_awaddr[11:0] + (m_axi_gmem_awlen + 1) * 16 > 4096) begin
+          $display("ERROR: write burst crosses 4KB: addr %h len %0d", m_axi_gmem_awaddr, m_axi_gmem_awlen);
+          errors = errors + 1;
+        end
+        aw_addr[aw_tail] = m_axi_gmem_awaddr;
+        aw_len[aw_tail] = m_axi_gmem_awlen;
+        aw_tail = (aw_tail + 1) % MAX_OUTSTANDING;
+        aw_count = aw_count + 1;
+        wr_bursts = wr_bursts + 1;
+      end
+      m_axi_gmem_wready <= 1;
+      if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+        if (aw_count == 0) begin
+          $display("ERROR: W beat without an open write burst");
+          errors = errors + 1;
+        end
+        for (l = 0; l < 16; l = l + 1)
+          if (m_axi_gmem_wstrb[l])
+            mem[aw_addr[aw_head] + w_beat * 16 + l] = m_axi_gmem_wdata[l*8 +: 8];
+        wr_beats = wr_beats + 1;
+        if (m_axi_gmem_wlast != (w_beat == aw_len[aw_head])) begin
+          $display("ERROR: WLAST at beat %0d of a %0d-beat burst", w_beat, aw_len[aw_head] + 1);
+          errors = errors + 1;
+        end
+        if (m_axi_gmem_wlast) begin
+          w_beat = 0;
+          aw_head = (aw_head + 1) % MAX_OUTSTANDING;
+          aw_count = aw_count - 1;
+          b_due[b_tail] = cycle + WR_LATENCY;
+          b_tail = (b_tail + 1) % MAX_OUTSTANDING;
+          b_count = b_count + 1;
+        end else
+          w_beat = w_beat + 1;
+      end
+
+      // B: in order
+      if (m_axi_gmem_bvalid && m_axi_gmem_bready) begin
+        b_head = (b_head + 1) % MAX_OUTSTANDING;
+        b_count = b_count - 1;
+      end
+      m_axi_gmem_bvalid <= (b_count > 0 && cycle >= b_due[b_head]);
+    end
+  end
+
+  // ---------------------------------------------------------------------
+  // AXI-Lite access
+  // ---------------------------------------------------------------------
+  task automatic lite_wr(input [7:0] addr, input [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_awvalid <= 1; s_axi_control_awaddr <= addr;
+      s_axi_control_wvalid  <= 1; s_axi_control_wdata  <= data;
+      s_axi_control_bready  <= 1;
+      @(posedge ap_clk);
+      while (!(s_axi_control_awready && s_axi_control_wready)) @(posedge ap_clk);
+      s_axi_control_awvalid <= 0; s_axi_control_wvalid <= 0;
+      while (!s_axi_control_bvalid) @(posedge ap_clk);
+      @(posedge ap_clk);
+      s_axi_control_bready <= 0;
+    end
+  endtask
+
+  task automatic lite_rd(input [7:0] addr, output [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_arvalid <= 1; s_axi_control_araddr <= addr; s_axi_control_rready <= 1;
+      @(posedge ap_clk);
+      while (!s_axi_control_arready) @(posedge ap_clk);
+      s_axi_control_arvalid <= 0;
+      while (!s_axi_control_rvalid) @(posedge ap_clk);
+      data = s_axi_control_rdata;
+      @(posedge ap_clk);
+      s_axi_control_rready <= 0;
+    end
+  endtask
+
+  // ---------------------------------------------------------------------
+  // One launch: program, run, check C and report
+  // ---------------------------------------------------------------------
+  localparam [31:0] A_BASE = 32'h0000_1000, B_BASE = 32'h0000_4000, C_BASE = 32'h0000_8000;
+
+  task automatic fill_operands;
+    integer i;
+    begin
+      for (i = 0; i < 16'h1000; i = i + 1) begin
+        mem[A_BASE + i] = (i == 0) ? 8'h80 : $random;
+        mem[B_BASE + i] = (i == 0) ? 8'h80 : $random;
+      end
+    end
+  endtask
+
+  task automatic run(input [8*16-1:0] name, input integer lda, input integer ldb, input integer ldc,
+                     input integer rows, input [31:0] ctrl, input integer cold, output integer cycles);
+    integer i, j, k, c_rows, ld_a, ld_b, ld_c, t0, bad;
+    reg signed [31:0] ref_c, got;
+    reg [31:0] status;
+    begin
+      ld_a = lda ? lda : SIZE;
+      ld_b = ldb ? ldb : SIZE;
+      ld_c = ldc ? ldc : SIZE * 4;
+      c_rows = rows ? rows : SIZE;
+      for (i = 0; i < SIZE * ld_c; i = i + 1) mem[C_BASE + i] = 8'hA5;
+
+      if (cold) lite_wr(8'h74, 32'h1);  // Weight cache and resident tile invalidated
+      lite_wr(8'h10, A_BASE); lite_wr(8'h1C, B_BASE); lite_wr(8'h28, C_BASE);
+      lite_wr(8'h54, lda); lite_wr(8'h58, ldb); lite_wr(8'h5C, ldc); lite_wr(8'h60, rows);
+
+      rd_bursts = 0; rd_beats = 0; wr_bursts = 0; wr_beats = 0; peak_reads = 0;
+      t0 = cycle;
+      lite_wr(8'h00, ctrl);
+      while (dut.accelerator_done) @(posedge ap_clk);
+      while (!dut.accelerator_done) @(posedge ap_clk);
+      cycles = cycle - t0;
+      lite_rd(8'h00, status);
+      if (status[2]) begin
+        $display("%0s: AXI error reported", name);
+        errors = errors + 1;
+      end
+
+      bad = 0;
+      for (i = 0; i < SIZE; i = i + 1)
+        for (j = 0; j < SIZE; j = j + 1) begin
+          ref_c = 0;
+          for (k = 0; k < SIZE; k = k + 1)
+            ref_c = ref_c + $signed(mem[A_BASE + i * ld_a + k]) * $signed(mem[B_BASE + k * ld_b + j]);
+          got = {mem[C_BASE + i * ld_c + j * 4 + 3], mem[C_BASE + i * ld_c + j * 4 + 2],
+                 mem[C_BASE + i * ld_c + j * 4 + 1], mem[C_BASE + i * ld_c + j * 4]};
+          if (i < c_rows ? got !== ref_c : got !== 32'hA5A5A5A5) begin
+            if (bad < 5)
+              $display("%0s C[%0d][%0d]: expected %0d, got %0d", name, i, j,
+                       i < c_rows ? ref_c : 32'hA5A5A5A5, got);
+            bad = bad + 1;
+          end
+        end
+      errors = errors + bad;
+    end
+  endtask
+
+  // The same launch with one request in flight, then with MAX_OUTSTANDING
+  task automatic compare(input [8*16-1:0] name, input integer lda, input integer ldb, input integer ldc,
+                         input integer rows, input [31:0] ctrl, input integer cold);
+    integer serial, pipelined;
+    begin
+      outstanding = 1;
+      run(name, lda, ldb, ldc, rows, ctrl, cold, serial);
+      outstanding = MAX_OUTSTANDING;
+      run(name, lda, ldb, ldc, rows, ctrl, cold, pipelined);
+      $display("%0s: %0d -> %0d cycles (%0d.%0dx)  reads %0d bursts/%0d beats, peak %0d in flight  writes %0d bursts/%0d beats",
+               name, serial, pipelined, serial / pipelined, (serial * 10 / pipelined) % 10,
+               rd_bursts, rd_beats, peak_reads, wr_bursts, wr_beats);
+    end
+  endtask
+
+  initial begin
+    repeat (8) @(posedge ap_clk);
+    ap_rst_n <= 1;
+    fill_operands();
+
+    $display("RD_LATENCY %0d, WR_LATENCY %0d: one request in flight -> up to %0d",
+             RD_LATENCY, WR_LATENCY, MAX_OUTSTANDING);
+    //       name             lda  ldb  ldc  rows ctrl    cold
+    compare("dense",          0,   0,   0,   0,   32'h01, 1);
+    compare("strided",        64,  48,  256, 0,   32'h01, 1);
+    compare("strided rows 5", 64,  0,   128, 5,   32'h01, 1);
+    compare("strided C",      0,   0,   128, 0,   32'h01, 1);
+    compare("strided B miss", 0,   32,  0,   0,   32'h41, 1);
+    compare("strided B hit",  0,   32,  0,   0,   32'h41, 0);
+
+    if (errors == 0)
+      $display("PASS");
+    else
+      $display("FAIL: %0d errors", errors);
+    $finish;
+  end
+
+  initial begin
+    #5_000_000;
+    $display("ERROR: simulation timed out");
+    $finish;
+  end
+
+endmodule
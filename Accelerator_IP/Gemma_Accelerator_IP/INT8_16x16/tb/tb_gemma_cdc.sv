@@ -0,0 +1,340 @@
+`timescale 1ns / 1ps
+
+// gemma_accelerator with ASYNC_COMPUTE = 1: the array runs on compute_clk
+// while the AXI side stays on a 100 MHz ap_clk. The same launches (dense,
+// strided with ROWS, transposed, resident weight tile, weight cache replay,
+// preload) run with compute_clk at 0.5x, 1x (unrelated phase), 2x and 3x the
+// bus clock. Every result is checked against a reference product, and each
+// launch is timed in ap_clk cycles from start to DONE.
+module tb_gemma_cdc;
+
+  localparam integer SIZE       = 16;
+  localparam integer ID_WIDTH   = 12;
+  localparam integer RD_LATENCY = 8;
+  localparam integer WR_LATENCY = 4;
+  localparam integer MAX_OUTSTANDING = 8;
+  localparam integer MEM_BYTES  = 64 * 1024;
+
+  reg ap_clk = 0;
+  reg ap_rst_n = 0;
+  always #5 ap_clk = ~ap_clk;
+
+  // compute_clk half period, changed between launches while the core is idle
+  reg  compute_clk = 0;
+  real compute_half = 2.5;
+  initial begin
+    #1.3;
+    forever #(compute_half) compute_clk = ~compute_clk;
+  end
+
+  integer cycle = 0;
+  always @(posedge ap_clk) cycle <= cycle + 1;
+
+  // AXI-Lite control port
+  reg         s_axi_control_awvalid = 0;
+  wire        s_axi_control_awready;
+  reg  [7:0]  s_axi_control_awaddr = 0;
+  reg         s_axi_control_wvalid = 0;
+  wire        s_axi_control_wready;
+  reg  [31:0] s_axi_control_wdata = 0;
+  wire        s_axi_control_bvalid;
+  reg         s_axi_control_bready = 0;
+  wire [1:0]  s_axi_control_bresp;
+  wire [0:0]  s_axi_control_bid;
+  reg         s_axi_control_arvalid = 0;
+  wire        s_axi_control_arready;
+  reg  [7:0]  s_axi_control_araddr = 0;
+  wire        s_axi_control_rvalid;
+  reg         s_axi_control_rready = 0;
+  wire [31:0] s_axi_control_rdata;
+  wire [1:0]  s_axi_control_rresp;
+  wire [0:0]  s_axi_control_rid;
+
+  // AXI4 master port
+  wire [ID_WIDTH-1:0] m_axi_gmem_awid, m_axi_gmem_arid;
+  wire                m_axi_gmem_awvalid, m_axi_gmem_wvalid, m_axi_gmem_wlast, m_axi_gmem_bready;
+  wire                m_axi_gmem_arvalid, m_axi_gmem_rready;
+  wire [63:0]         m_axi_gmem_awaddr, m_axi_gmem_araddr;
+  wire [7:0]          m_axi_gmem_awlen, m_axi_gmem_arlen;
+  wire [2:0]          m_axi_gmem_awsize, m_axi_gmem_arsize;
+  wire [1:0]          m_axi_gmem_awburst, m_axi_gmem_arburst;
+  wire [127:0]        m_axi_gmem_wdata;
+  wire [15:0]         m_axi_gmem_wstrb;
+  reg                 m_axi_gmem_awready = 0, m_axi_gmem_wready = 0, m_axi_gmem_bvalid = 0;
+  reg                 m_axi_gmem_arready = 0, m_axi_gmem_rvalid = 0, m_axi_gmem_rlast = 0;
+  reg  [127:0]        m_axi_gmem_rdata = 0;
+
+  gemma_accelerator #(.ID_WIDTH(ID_WIDTH), .ARRAY_SIZE(SIZE), .ASYNC_COMPUTE(1)) dut (
+    .ap_clk(ap_clk), .ap_rst_n(ap_rst_n), .compute_clk(compute_clk),
+    .s_axi_control_awvalid(s_axi_control_awvalid), .s_axi_control_awready(s_axi_control_awready),
+    .s_axi_control_awaddr(s_axi_control_awaddr),
+    .s_axi_control_wvalid(s_axi_control_wvalid), .s_axi_control_wready(s_axi_control_wready),
+    .s_axi_control_wdata(s_axi_control_wdata), .s_axi_control_wstrb(4'hF),
+    .s_axi_control_bvalid(s_axi_control_bvalid), .s_axi_control_bready(s_axi_control_bready),
+    .s_axi_control_bresp(s_axi_control_bresp), .s_axi_control_awid(1'b0), .s_axi_control_bid(s_axi_control_bid),
+    .s_axi_control_arvalid(s_axi_control_arvalid), .s_axi_control_arready(s_axi_control_arready),
+    .s_axi_control_araddr(s_axi_control_araddr),
+    .s_axi_control_rvalid(s_axi_control_rvalid), .s_axi_control_rready(s_axi_control_rready),
+    .s_axi_control_rdata(s_axi_control_rdata), .s_axi_control_rresp(s_axi_control_rresp),
+    .s_axi_control_arid(1'b0), .s_axi_control_rid(s_axi_control_rid),
+    .m_axi_gmem_awid(m_axi_gmem_awid), .m_axi_gmem_bid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_awvalid(m_axi_gmem_awvalid), .m_axi_gmem_awready(m_axi_gmem_awready),
+    .m_axi_gmem_awaddr(m_axi_gmem_awaddr), .m_axi_gmem_awlen(m_axi_gmem_awlen),
+    .m_axi_gmem_awsize(m_axi_gmem_awsize), .m_axi_gmem_awburst(m_axi_gmem_awburst),
+    .m_axi_gmem_wvalid(m_axi_gmem_wvalid), .m_axi_gmem_wready(m_axi_gmem_wready),
+    .m_axi_gmem_wdata(m_axi_gmem_wdata), .m_axi_gmem_wstrb(m_axi_gmem_wstrb), .m_axi_gmem_wlast(m_axi_gmem_wlast),
+    .m_axi_gmem_bvalid(m_axi_gmem_bvalid), .m_axi_gmem_bready(m_axi_gmem_bready), .m_axi_gmem_bresp(2'b00),
+    .m_axi_gmem_arid(m_axi_gmem_arid), .m_axi_gmem_rid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_arvalid(m_axi_gmem_arvalid), .m_axi_gmem_arready(m_axi_gmem_arready),
+    .m_axi_gmem_araddr(m_axi_gmem_araddr), .m_axi_gmem_arlen(m_axi_gmem_arlen),
+    .m_axi_gmem_arsize(m_axi_gmem_arsize), .m_axi_gmem_arburst(m_axi_gmem_arburst),
+    .m_axi_gmem_rvalid(m_axi_gmem_rvalid), .m_axi_gmem_rready(m_axi_gmem_rready),
+    .m_axi_gmem_rdata(m_axi_gmem_rdata), .m_axi_gmem_rlast(m_axi_gmem_rlast), .m_axi_gmem_rresp(2'b00)
+  );
+
+  // ---------------------------------------------------------------------
+  // Memory slave: byte array behind in-order AR/AW queues (as in
+  // tb_gemma_axi_latency). R stalls whenever the engine drops RREADY.
+  // ---------------------------------------------------------------------
+  reg [7:0] mem [0:MEM_BYTES-1];
+
+  reg [63:0] ar_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  ar_len   [0:MAX_OUTSTANDING-1];
+  integer    ar_ready_at [0:MAX_OUTSTANDING-1];
+  integer    ar_head = 0, ar_tail = 0, ar_count = 0;
+  integer    r_beat = 0;
+
+  reg [63:0] aw_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  aw_len   [0:MAX_OUTSTANDING-1];
+  integer    aw_head = 0, aw_tail = 0, aw_count = 0;
+  integer    w_beat = 0;
+  integer    b_due   [0:MAX_OUTSTANDING-1];
+  integer    b_head = 0, b_tail = 0, b_count = 0;
+
+  integer    errors = 0;
+  integer    rready_stalls;  // R beats offered while the engine held RREADY low
+
+  integer l;
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      m_axi_gmem_arready <= 0; m_axi_gmem_rvalid <= 0; m_axi_gmem_rlast <= 0;
+      m_axi_gmem_awready <= 0; m_axi_gmem_wready <= 0; m_axi_gmem_bvalid <= 0;
+    end else begin
+      m_axi_gmem_arready <= (ar_count + (m_axi_gmem_arvalid && m_axi_gmem_arready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_arvalid && m_axi_gmem_arready) begin
+        ar_addr[ar_tail] = m_axi_gmem_araddr;
+        ar_len[ar_tail] = m_axi_gmem_arlen;
+        ar_ready_at[ar_tail] = cycle + RD_LATENCY;
+        ar_tail = (ar_tail + 1) % MAX_OUTSTANDING;
+        ar_count = ar_count + 1;
+      end
+
+      if (m_axi_gmem_rvalid && !m_axi_gmem_rready)
+        rready_stalls = rready_stalls + 1;
+      if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+        if (m_axi_gmem_rlast) begin
+          r_beat = 0;
+          ar_head = (ar_head + 1) % MAX_OUTSTANDING;
+          ar_count = ar_count - 1;
+        end else
+          r_beat = r_beat + 1;
+      end
+      if (ar_count > 0 && cycle >= ar_ready_at[ar_head] && (!m_axi_gmem_rvalid || m_axi_gmem_rready)) begin
+        for (l = 0; l < 16; l = l + 1)
+          m_axi_gmem_rdata[l*8 +: 8] <= mem[ar_addr[ar_head] + r_beat * 16 + l];
+        m_axi_gmem_rvalid <= 1;
+        m_axi_gmem_rlast  <= (r_beat == ar_len[ar_head]);
+      end else if (m_axi_gmem_rready) begin
+        m_axi_gmem_rvalid <= 0;
+        m_axi_gmem_rlast  <= 0;
+      end
+
+      m_axi_gmem_awready <= (aw_count + b_count + (m_axi_gmem_awvalid && m_axi_gmem_awready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_awvalid && m_axi_gmem_awready) begin
+        aw_addr[aw_tail] = m_axi_gmem_awaddr;
+        aw_len[aw_tail] = m_axi_gmem_awlen;
+        aw_tail = (aw_tail + 1) % MAX_OUTSTANDING;
+        aw_count = aw_count + 1;
+      end
+      m_axi_gmem_wready <= 1;
+      if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+        if (aw_count == 0) begin
+          $display("ERROR: W beat without an open write burst");
+          errors = errors + 1;
+        end
+        for (l = 0; l < 16; l = l + 1)
+          if (m_axi_gmem_wstrb[l])
+            mem[aw_addr[aw_head] + w_beat * 16 + l] = m_axi_gmem_wdata[l*8 +: 8];
+        if (m_axi_gmem_wlast != (w_beat == aw_len[aw_head])) begin
+          $display("ERROR: WLAST at beat %0d of a %0d-beat burst", w_beat, aw_len[aw_head] + 1);
+          errors = errors + 1;
+        end
+        if (m_axi_gmem_wlast) begin
+          w_beat = 0;
+          aw_head = (aw_head + 1) % MAX_OUTSTANDING;
+          aw_count = aw_count - 1;
+          b_due[b_tail] = cycle + WR_LATENCY;
+          b_tail = (b_tail + 1) % MAX_OUTSTANDING;
+          b_count = b_count + 1;
+        end else
+          w_beat = w_beat + 1;
+      end
+
+      if (m_axi_gmem_bvalid && m_axi_gmem_bready) begin
+        b_head = (b_head + 1) % MAX_OUTSTANDING;
+        b_count = b_count - 1;
+      end
+      m_axi_gmem_bvalid <= (b_count > 0 && cycle >= b_due[b_head]);
+    end
+  end
+
+  // ---------------------------------------------------------------------
+  // AXI-Lite access
+  // ---------------------------------------------------------------------
+  task automatic lite_wr(input [7:0] addr, input [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_awvalid <= 1; s_axi_control_awaddr <= addr;
+      s_axi_control_wvalid  <= 1; s_axi_control_wdata  <= data;
+      s_axi_control_bready  <= 1;
+      @(posedge ap_clk);
+      while (!(s_axi_control_awready && s_axi_control_wready)) @(posedge ap_clk);
+      s_axi_control_awvalid <= 0; s_axi_control_wvalid <= 0;
+      while (!s_axi_control_bvalid) @(posedge ap_clk);
+      @(posedge ap_clk);
+      s_axi_control_bready <= 0;
+    end
+  endtask
+
+  task automatic lite_rd(input [7:0] addr, output [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_arvalid <= 1; s_axi_control_araddr <= addr; s_axi_control_rready <= 1;
+      @(posedge ap_clk);
+      while (!s_axi_control_arready) @(posedge ap_clk);
+      s_axi_control_arvalid <= 0;
+      while (!s_axi_control_rvalid) @(posedge ap_clk);
+      data = s_axi_control_rdata;
+      @(posedge ap_clk);
+      s_axi_control_rready <= 0;
+    end
+  endtask
+
+  // ---------------------------------------------------------------------
+  // One launch: program, run, check C
+  // ---------------------------------------------------------------------
+  localparam [31:0] A_BASE = 32'h0000_1000, B0_BASE = 32'h0000_3000, B1_BASE = 32'h0000_5000,
+                    C_BASE = 32'h0000_8000;
+
+  task automatic fill_operands;
+    integer i;
+    begin
+      for (i = 0; i < 16'h1000; i = i + 1) begin
+        mem[A_BASE + i]  = (i == 0) ? 8'h80 : $random;
+        mem[B0_BASE + i] = (i == 0) ? 8'h80 : $random;
+        mem[B1_BASE + i] = $random;
+      end
+    end
+  endtask
+
+  // ctrl: bit0 start, bit1 preload (no C), bit4/5 transposed A/B, bit6 reuse
+  task automatic run(input [8*16-1:0] name, input [31:0] b_base, input integer lda, input integer ldb,
+                     input integer ldc, input integer rows, input [31:0] ctrl, input integer cold,
+                     output integer cycles);
+    integer i, j, k, c_rows, ld_a, ld_b, ld_c, t0, bad;
+    reg signed [31:0] ref_c, got;
+    reg signed [7:0]  a_ik, b_kj;
+    reg [31:0] status;
+    begin
+      ld_a = lda ? lda : SIZE;
+      ld_b = ldb ? ldb : SIZE;
+      ld_c = ldc ? ldc : SIZE * 4;
+      c_rows = rows ? rows : SIZE;
+      for (i = 0; i < SIZE * ld_c; i = i + 1) mem[C_BASE + i] = 8'hA5;
+
+      if (cold) lite_wr(8'h74, 32'h1);  // Weight cache and resident tile invalidated
+      lite_wr(8'h10, A_BASE); lite_wr(8'h1C, b_base); lite_wr(8'h28, C_BASE);
+      lite_wr(8'h54, lda); lite_wr(8'h58, ldb); lite_wr(8'h5C, ldc); lite_wr(8'h60, rows);
+
+      t0 = cycle;
+      lite_wr(8'h00, ctrl);
+      while (dut.accelerator_done) @(posedge ap_clk);
+      while (!dut.accelerator_done) @(posedge ap_clk);
+      cycles = cycle - t0;
+      lite_rd(8'h00, status);
+      if (status[2]) begin
+        $display("%0s: AXI error reported", name);
+        errors = errors + 1;
+      end
+
+      bad = 0;
+      if (!ctrl[1])
+        for (i = 0; i < SIZE; i = i + 1)
+          for (j = 0; j < SIZE; j = j + 1) begin
+            ref_c = 0;
+            for (k = 0; k < SIZE; k = k + 1) begin
+              // Rows past ROWS multiply as zero (a transposed A is fetched whole)
+              a_ik = ctrl[4] ? mem[A_BASE + k * ld_a + i] : (i < c_rows) ? mem[A_BASE + i * ld_a + k] : 8'd0;
+              b_kj = ctrl[5] ? mem[b_base + j * ld_b + k] : mem[b_base + k * ld_b + j];
+              ref_c = ref_c + a_ik * b_kj;
+            end
+            got = {mem[C_BASE + i * ld_c + j * 4 + 3], mem[C_BASE + i * ld_c + j * 4 + 2],
+                   mem[C_BASE + i * ld_c + j * 4 + 1], mem[C_BASE + i * ld_c + j * 4]};
+            if (i < c_rows ? got !== ref_c : got !== 32'hA5A5A5A5) begin
+              if (bad < 5)
+                $display("%0s C[%0d][%0d]: expected %0d, got %0d", name, i, j,
+                         i < c_rows ? ref_c : 32'hA5A5A5A5, got);
+              bad = bad + 1;
+            end
+          end
+      errors = errors + bad;
+    end
+  endtask
+
+  // The whole launch set at one compute clock
+  task automatic run_all(input real half_ns);
+    integer t_dense, t_strided, t_trans, t_resident, t_cached, t_preload, t_after;
+    begin
+      @(posedge ap_clk);
+      compute_half = half_ns;
+      repeat (4) @(posedge ap_clk);
+      rready_stalls = 0;
+      //   name          B base   lda ldb ldc  rows ctrl   cold
+      run("dense",       B0_BASE, 0,  0,  0,   0,   32'h01, 1, t_dense);
+      run("strided",     B0_BASE, 64, 48, 128, 5,   32'h01, 1, t_strided);
+      run("transposed",  B0_BASE, 0,  0,  0,   0,   32'h31, 1, t_trans);
+      run("fill B1",     B1_BASE, 0,  0,  0,   0,   32'h41, 1, t_after);
+      run("resident B1", B1_BASE, 0,  0,  0,   0,   32'h41, 0, t_resident);
+      run("fill B0",     B0_BASE, 0,  0,  0,   0,   32'h41, 0, t_after);
+      run("cached B1",   B1_BASE, 0,  0,  0,   0,   32'h41, 0, t_cached);
+      run("preload B0",  B0_BASE, 0,  0,  0,   0,   32'h43, 1, t_preload);
+      run("after preload", B0_BASE, 0, 0, 0,   0,   32'h41, 0, t_after);
+      $display("compute_clk %0d MHz: dense %0d, strided %0d, transposed %0d, resident %0d, cached %0d, preload %0d cycles; %0d R stalls",
+               $rtoi(500.0 / half_ns), t_dense, t_strided, t_trans, t_resident, t_cached, t_preload, rready_stalls);
+    end
+  endtask
+
+  initial begin
+    repeat (8) @(posedge ap_clk);
+    ap_rst_n <= 1;
+    fill_operands();
+
+    run_all(10.0);   //  50 MHz: array slower than the bus
+    run_all(4.9);    // ~100 MHz, unrelated phase
+    run_all(2.5);    // 200 MHz
+    run_all(1.667);  // 300 MHz
+
+    if (errors == 0)
+      $display("PASS");
+    else
+      $display("FAIL: %0d errors", errors);
+    $finish;
+  end
+
+  initial begin
+    #5_000_000;
+    $display("ERROR: simulation timed out");
+    $finish;
+  end
+
+endmodule
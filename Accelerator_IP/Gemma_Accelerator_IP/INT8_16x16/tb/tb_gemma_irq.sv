@@ -0,0 +1,441 @@
+`timescale 1ns / 1ps
+
+// Completion interrupt: the interrupt output follows INT_GIE and the enabled
+// INT_STATUS bits. Checks that a register launch raises it only once its
+// results are in memory, that a masked source is latched and raises it when
+// enabled later, that a write of 1 clears a source, that a ring raises the
+// drained interrupt once per batch (after the HEAD write-back), that the
+// interrupt registers are written while a ring runs, and that a failed read
+// raises the error source.
+module tb_gemma_irq;
+
+  localparam integer SIZE            = 16;
+  localparam integer ID_WIDTH        = 12;
+  localparam integer RD_LATENCY      = 20;
+  localparam integer WR_LATENCY      = 10;
+  localparam integer MAX_OUTSTANDING = 16;
+  localparam integer MEM_BYTES       = 64 * 1024;
+  localparam integer RING_ENTRIES    = 8;
+
+  reg ap_clk = 0;
+  reg ap_rst_n = 0;
+  always #5 ap_clk = ~ap_clk;
+
+  integer cycle = 0;
+  always @(posedge ap_clk) cycle <= cycle + 1;
+
+  wire        interrupt;
+
+  // AXI-Lite control port
+  reg         s_axi_control_awvalid = 0;
+  wire        s_axi_control_awready;
+  reg  [7:0]  s_axi_control_awaddr = 0;
+  reg         s_axi_control_wvalid = 0;
+  wire        s_axi_control_wready;
+  reg  [31:0] s_axi_control_wdata = 0;
+  wire        s_axi_control_bvalid;
+  reg         s_axi_control_bready = 0;
+  wire [1:0]  s_axi_control_bresp;
+  wire [0:0]  s_axi_control_bid;
+  reg         s_axi_control_arvalid = 0;
+  wire        s_axi_control_arready;
+  reg  [7:0]  s_axi_control_araddr = 0;
+  wire        s_axi_control_rvalid;
+  reg         s_axi_control_rready = 0;
+  wire [31:0] s_axi_control_rdata;
+  wire [1:0]  s_axi_control_rresp;
+  wire [0:0]  s_axi_control_rid;
+
+  // AXI4 master port
+  wire [ID_WIDTH-1:0] m_axi_gmem_awid, m_axi_gmem_arid;
+  wire                m_axi_gmem_awvalid, m_axi_gmem_wvalid, m_axi_gmem_wlast, m_axi_gmem_bready;
+  wire                m_axi_gmem_arvalid, m_axi_gmem_rready;
+  wire [63:0]         m_axi_gmem_awaddr, m_axi_gmem_araddr;
+  wire [7:0]          m_axi_gmem_awlen, m_axi_gmem_arlen;
+  wire [2:0]          m_axi_gmem_awsize, m_axi_gmem_arsize;
+  wire [1:0]          m_axi_gmem_awburst, m_axi_gmem_arburst;
+  wire [127:0]        m_axi_gmem_wdata;
+  wire [15:0]         m_axi_gmem_wstrb;
+  reg                 m_axi_gmem_awready = 0, m_axi_gmem_wready = 0, m_axi_gmem_bvalid = 0;
+  reg                 m_axi_gmem_arready = 0, m_axi_gmem_rvalid = 0, m_axi_gmem_rlast = 0;
+  reg  [127:0]        m_axi_gmem_rdata = 0;
+  reg  [1:0]          m_axi_gmem_rresp = 0;
+
+  gemma_accelerator #(.ID_WIDTH(ID_WIDTH), .ARRAY_SIZE(SIZE)) dut (
+    .ap_clk(ap_clk), .ap_rst_n(ap_rst_n), .compute_clk(1'b0), .interrupt(interrupt),
+    .s_axi_control_awvalid(s_axi_control_awvalid), .s_axi_control_awready(s_axi_control_awready),
+    .s_axi_control_awaddr(s_axi_control_awaddr),
+    .s_axi_control_wvalid(s_axi_control_wvalid), .s_axi_control_wready(s_axi_control_wready),
+    .s_axi_control_wdata(s_axi_control_wdata), .s_axi_control_wstrb(4'hF),
+    .s_axi_control_bvalid(s_axi_control_bvalid), .s_axi_control_bready(s_axi_control_bready),
+    .s_axi_control_bresp(s_axi_control_bresp), .s_axi_control_awid(1'b0), .s_axi_control_bid(s_axi_control_bid),
+    .s_axi_control_arvalid(s_axi_control_arvalid), .s_axi_control_arready(s_axi_control_arready),
+    .s_axi_control_araddr(s_axi_control_araddr),
+    .s_axi_control_rvalid(s_axi_control_rvalid), .s_axi_control_rready(s_axi_control_rready),
+    .s_axi_control_rdata(s_axi_control_rdata), .s_axi_control_rresp(s_axi_control_rresp),
+    .s_axi_control_arid(1'b0), .s_axi_control_rid(s_axi_control_rid),
+    .m_axi_gmem_awid(m_axi_gmem_awid), .m_axi_gmem_bid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_awvalid(m_axi_gmem_awvalid), .m_axi_gmem_awready(m_axi_gmem_awready),
+    .m_axi_gmem_awaddr(m_axi_gmem_awaddr), .m_axi_gmem_awlen(m_axi_gmem_awlen),
+    .m_axi_gmem_awsize(m_axi_gmem_awsize), .m_axi_gmem_awburst(m_axi_gmem_awburst),
+    .m_axi_gmem_wvalid(m_axi_gmem_wvalid), .m_axi_gmem_wready(m_axi_gmem_wready),
+    .m_axi_gmem_wdata(m_axi_gmem_wdata), .m_axi_gmem_wstrb(m_axi_gmem_wstrb), .m_axi_gmem_wlast(m_axi_gmem_wlast),
+    .m_axi_gmem_bvalid(m_axi_gmem_bvalid), .m_axi_gmem_bready(m_axi_gmem_bready), .m_axi_gmem_bresp(2'b00),
+    .m_axi_gmem_arid(m_axi_gmem_arid), .m_axi_gmem_rid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_arvalid(m_axi_gmem_arvalid), .m_axi_gmem_arready(m_axi_gmem_arready),
+    .m_axi_gmem_araddr(m_axi_gmem_araddr), .m_axi_gmem_arlen(m_axi_gmem_arlen),
+    .m_axi_gmem_arsize(m_axi_gmem_arsize), .m_axi_gmem_arburst(m_axi_gmem_arburst),
+    .m_axi_gmem_rvalid(m_axi_gmem_rvalid), .m_axi_gmem_rready(m_axi_gmem_rready),
+    .m_axi_gmem_rdata(m_axi_gmem_rdata), .m_axi_gmem_rlast(m_axi_gmem_rlast), .m_axi_gmem_rresp(m_axi_gmem_rresp)
+  );
+
+  // ---------------------------------------------------------------------
+  // Memory slave: byte array behind in-order AR/AW queues. Read bursts
+  // starting in [err_lo, err_hi) return SLVERR on every beat.
+  // ---------------------------------------------------------------------
+  reg [7:0] mem [0:MEM_BYTES-1];
+
+  reg [63:0] ar_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  ar_len   [0:MAX_OUTSTANDING-1];
+  reg        ar_err   [0:MAX_OUTSTANDING-1];
+  integer    ar_ready_at [0:MAX_OUTSTANDING-1];
+  integer    ar_head = 0, ar_tail = 0, ar_count = 0;
+  integer    r_beat = 0;
+
+  reg [63:0] aw_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  aw_len   [0:MAX_OUTSTANDING-1];
+  integer    aw_head = 0, aw_tail = 0, aw_count = 0;
+  integer    w_beat = 0;
+  integer    b_due   [0:MAX_OUTSTANDING-1];
+  integer    b_head = 0, b_tail = 0, b_count = 0;
+
+  reg [63:0] err_lo = 0, err_hi = 0;
+  integer    errors = 0;
+
+  integer l;
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      m_axi_gmem_arready <= 0; m_axi_gmem_rvalid <= 0; m_axi_gmem_rlast <= 0;
+      m_axi_gmem_awready <= 0; m_axi_gmem_wready <= 0; m_axi_gmem_bvalid <= 0;
+    end else begin
+      // AR: one request per cycle while the queue has room
+      m_axi_gmem_arready <= (ar_count + (m_axi_gmem_arvalid && m_axi_gmem_arready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_arvalid && m_axi_gmem_arready) begin
+        if (m_axi_gmem_arsize != 3'b100 || m_axi_gmem_arburst != 2'b01 ||
+            (m_axi_gmem_araddr[11:0] + (m_axi_gmem_arlen + 1) * 16 > 4096)) begin
+          $display("ERROR: bad read burst addr %h len %0d", m_axi_gmem_araddr, m_axi_gmem_arlen);
+          errors = errors + 1;
+        end
+        ar_addr[ar_tail] = m_axi_gmem_araddr;
+        ar_len[ar_tail] = m_axi_gmem_arlen;
+        ar_err[ar_tail] = (m_axi_gmem_araddr >= err_lo && m_axi_gmem_araddr < err_hi);
+        ar_ready_at[ar_tail] = cycle + RD_LATENCY;
+        ar_tail = (ar_tail + 1) % MAX_OUTSTANDING;
+        ar_count = ar_count + 1;
+      end
+
+      // R: the head burst streams once its latency has elapsed
+      if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+        if (m_axi_gmem_rlast) begin
+          r_beat = 0;
+          ar_head = (ar_head + 1) % MAX_OUTSTANDING;
+          ar_count = ar_count - 1;
+        end else
+          r_beat = r_beat + 1;
+      end
+      if (ar_count > 0 && cycle >= ar_ready_at[ar_head] && (!m_axi_gmem_rvalid || m_axi_gmem_rready)) begin
+        for (l = 0; l < 16; l = l + 1)
+          m_axi_gmem_rdata[l*8 +: 8] <= mem[ar_addr[ar_head] + r_beat * 16 + l];
+        m_axi_gmem_rvalid <= 1;
+        m_axi_gmem_rlast  <= (r_beat == ar_len[ar_head]);
+        m_axi_gmem_rresp  <= ar_err[ar_head] ? 2'b10 : 2'b00;
+      end else if (m_axi_gmem_rready) begin
+        m_axi_gmem_rvalid <= 0;
+        m_axi_gmem_rlast  <= 0;
+      end
+
+      // AW/W: data goes to the oldest open burst; B is due WR_LATENCY later
+      m_axi_gmem_awready <= (aw_count + b_count + (m_axi_gmem_awvalid && m_axi_gmem_awready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_awvalid && m_axi_gmem_awready) begin
+        aw_addr[aw_tail] = m_axi_gmem_awaddr;
+        aw_len[aw_tail] = m_axi_gmem_awlen;
+        aw_tail = (aw_tail + 1) % MAX_OUTSTANDING;
+        aw_count = aw_count + 1;
+      end
+      m_axi_gmem_wready <= 1;
+      if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+        if (aw_count == 0) begin
+          $display("ERROR: W beat without an open write burst");
+          errors = errors + 1;
+        end
+        for (l = 0; l < 16; l = l + 1)
+          if (m_axi_gmem_wstrb[l])
+            mem[aw_addr[aw_head] + w_beat * 16 + l] = m_axi_gmem_wdata[l*8 +: 8];
+        if (m_axi_gmem_wlast != (w_beat == aw_len[aw_head])) begin
+          $display("ERROR: WLAST at beat %0d of a %0d-beat burst", w_beat, aw_len[aw_head] + 1);
+          errors = errors + 1;
+        end
+        if (m_axi_gmem_wlast) begin
+          w_beat = 0;
+          aw_head = (aw_head + 1) % MAX_OUTSTANDING;
+          aw_count = aw_count - 1;
+          b_due[b_tail] = cycle + WR_LATENCY;
+          b_tail = (b_tail + 1) % MAX_OUTSTANDING;
+          b_count = b_count + 1;
+        end else
+          w_beat = w_beat + 1;
+      end
+
+      // B: in order
+      if (m_axi_gmem_bvalid && m_axi_gmem_bready) begin
+        b_head = (b_head + 1) % MAX_OUTSTANDING;
+        b_count = b_count - 1;
+      end
+      m_axi_gmem_bvalid <= (b_count > 0 && cycle >= b_due[b_head]);
+    end
+  end
+
+  // ---------------------------------------------------------------------
+  // AXI-Lite access
+  // ---------------------------------------------------------------------
+  task automatic lite_wr(input [7:0] addr, input [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_awvalid <= 1; s_axi_control_awaddr <= addr;
+      s_axi_control_wvalid  <= 1; s_axi_control_wdata  <= data;
+      s_axi_control_bready  <= 1;
+      @(posedge ap_clk);
+      while (!(s_axi_control_awready && s_axi_control_wready)) @(posedge ap_clk);
+      s_axi_control_awvalid <= 0; s_axi_control_wvalid <= 0;
+      while (!s_axi_control_bvalid) @(posedge ap_clk);
+      @(posedge ap_clk);
+      s_axi_control_bready <= 0;
+    end
+  endtask
+
+  task automatic lite_rd(input [7:0] addr, output [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_arvalid <= 1; s_axi_control_araddr <= addr; s_axi_control_rready <= 1;
+      @(posedge ap_clk);
+      while (!s_axi_control_arready) @(posedge ap_clk);
+      s_axi_control_arvalid <= 0;
+      while (!s_axi_control_rvalid) @(posedge ap_clk);
+      data = s_axi_control_rdata;
+      @(posedge ap_clk);
+      s_axi_control_rready <= 0;
+    end
+  endtask
+
+  // ---------------------------------------------------------------------
+  // Launches
+  // ---------------------------------------------------------------------
+  localparam [31:0] A_BASE = 32'h0000_1000, B_BASE = 32'h0000_2000;
+  localparam [31:0] RING_BASE = 32'h0000_3000, HEAD_WB = 32'h0000_3400;
+  localparam [31:0] C_BASE = 32'h0000_4000, ERR_BASE = 32'h0000_E000;
+
+  localparam [31:0] INT_DONE = 32'h1, INT_RING = 32'h2, INT_ERROR = 32'h4;
+
+  integer irq_edges = 0;
+  reg     irq_q = 0;
+  always @(posedge ap_clk) begin
+    irq_q <= interrupt;
+    if (interrupt && !irq_q) irq_edges = irq_edges + 1;
+  end
+
+  task automatic put_word(input [31:0] addr, input [31:0] data);
+    integer i;
+    begin
+      for (i = 0; i < 4; i = i + 1) mem[addr + i] = data[i*8 +: 8];
+    end
+  endtask
+
+  function automatic [31:0] get_word(input [31:0] addr);
+    get_word = {mem[addr + 3], mem[addr + 2], mem[addr + 1], mem[addr]};
+  endfunction
+
+  // Dense ring entry: C of slot s at C_BASE + s * 0x400
+  task automatic put_entry(input integer slot, input [31:0] a);
+    integer i;
+    reg [31:0] d;
+    begin
+      d = RING_BASE + slot * 64;
+      for (i = 0; i < 64; i = i + 1) mem[d + i] = 8'h00;
+      put_word(d + 8'h00, a);
+      put_word(d + 8'h08, B_BASE);
+      put_word(d + 8'h10, C_BASE + slot * 32'h400);
+    end
+  endtask
+
+  task automatic register_launch(input [31:0] a, input [31:0] c);
+    begin
+      lite_wr(8'h10, a); lite_wr(8'h1C, B_BASE); lite_wr(8'h28, c);
+      lite_wr(8'h00, 32'h01);
+    end
+  endtask
+
+  // Wait for the interrupt output, at most max_cycles
+  task automatic wait_irq(input [8*24-1:0] name, input integer max_cycles);
+    integer t0;
+    begin
+      t0 = cycle;
+      while (!interrupt && cycle - t0 < max_cycles) @(posedge ap_clk);
+      if (!interrupt) begin
+        $display("ERROR: %0s: no interrupt within %0d cycles", name, max_cycles);
+        errors = errors + 1;
+      end
+    end
+  endtask
+
+  task automatic expect_reg(input [8*24-1:0] name, input [7:0] addr, input [31:0] expected);
+    reg [31:0] value;
+    begin
+      lite_rd(addr, value);
+      if (value !== expected) begin
+        $display("ERROR: %0s: register %h reads %h, expected %h", name, addr, value, expected);
+        errors = errors + 1;
+      end
+    end
+  endtask
+
+  // Write 1 to clear and check the line drops
+  task automatic ack(input [8*24-1:0] name, input [31:0] bits);
+    begin
+      lite_wr(8'h0C, bits);
+      repeat (3) @(posedge ap_clk);
+      if (interrupt) begin
+        $display("ERROR: %0s: interrupt still high after the acknowledge", name);
+        errors = errors + 1;
+      end
+    end
+  endtask
+
+  integer i, edges0, busy_writes;
+  reg [31:0] status, value;
+
+  initial begin
+    repeat (8) @(posedge ap_clk);
+    ap_rst_n <= 1;
+    for (i = 0; i < MEM_BYTES; i = i + 1) mem[i] = 8'h00;
+    for (i = 0; i < 16'h1000; i = i + 1) mem[A_BASE + i] = $random;
+    for (i = 0; i < SIZE * SIZE; i = i + 1) mem[B_BASE + i] = $random;
+
+    lite_rd(8'h80, value);
+    if (value[7:4] < 3) begin
+      $display("ERROR: ACC_ID %h does not report the interrupt version", value);
+      errors = errors + 1;
+    end
+    expect_reg("reset GIE", 8'h04, 0);
+    expect_reg("reset enable", 8'h08, 0);
+    expect_reg("reset status", 8'h0C, 0);
+
+    // 1. Register launch with the done source enabled: the line rises only
+    //    after DONE, i.e. after the last C write response
+    lite_wr(8'h04, 1);
+    lite_wr(8'h08, INT_DONE);
+    register_launch(A_BASE, C_BASE);
+    wait_irq("register launch", 5000);
+    if (!dut.accelerator_done || dut.current_state != 4'd0 || b_count != 0) begin
+      $display("ERROR: interrupt before completion (done %0d, state %0d, %0d B pending)",
+               dut.accelerator_done, dut.current_state, b_count);
+      errors = errors + 1;
+    end
+    expect_reg("launch status", 8'h0C, INT_DONE);
+    ack("launch", INT_DONE);
+    expect_reg("launch acked", 8'h0C, 0);
+
+    // 2. Masked source: latched but silent until enabled
+    lite_wr(8'h08, 0);
+    register_launch(A_BASE + 16'h100, C_BASE);
+    while (dut.accelerator_done) @(posedge ap_clk);
+    while (!dut.accelerator_done) @(posedge ap_clk);
+    repeat (5) @(posedge ap_clk);
+    if (interrupt) begin
+      $display("ERROR: masked source raised the interrupt");
+      errors = errors + 1;
+    end
+    expect_reg("masked status", 8'h0C, INT_DONE);
+    lite_wr(8'h08, INT_DONE);
+    wait_irq("enabled late", 5);
+    lite_wr(8'h04, 0);  // GIE masks everything
+    repeat (3) @(posedge ap_clk);
+    if (interrupt) begin
+      $display("ERROR: interrupt high with GIE off");
+      errors = errors + 1;
+    end
+    lite_wr(8'h04, 1);
+    ack("enabled late", INT_DONE);
+
+    // 3. Ring of four: one drained interrupt, after HEAD is written back.
+    //    The done bit is acknowledged while the ring runs.
+    lite_wr(8'h08, INT_RING);
+    lite_wr(8'h84, RING_BASE); lite_wr(8'h88, 0);
+    lite_wr(8'h98, HEAD_WB);   lite_wr(8'h9C, 0);
+    lite_wr(8'h8C, RING_ENTRIES);
+    for (i = 0; i < 4; i = i + 1) put_entry(i, A_BASE + i * 16'h100);
+    put_word(HEAD_WB, 32'hFFFF_FFFF);
+    edges0 = irq_edges;
+    lite_wr(8'h90, 4);
+    busy_writes = 0;
+    while (!interrupt) begin
+      if (dut.current_state != 4'd0) begin
+        lite_wr(8'h0C, INT_DONE);
+        if (dut.current_state != 4'd0 || dut.ring_head != 4) busy_writes = busy_writes + 1;
+      end else
+        @(posedge ap_clk);
+    end
+    if (get_word(HEAD_WB) !== 4 || dut.ring_head != 4) begin
+      $display("ERROR: drained interrupt with HEAD %0d, written back %h", dut.ring_head, get_word(HEAD_WB));
+      errors = errors + 1;
+    end
+    if (busy_writes == 0) begin
+      $display("ERROR: no INT_STATUS write completed while the ring ran");
+      errors = errors + 1;
+    end
+    lite_rd(8'h0C, value);
+    if (!value[1] || value[2]) begin
+      $display("ERROR: ring status %h (expected drained, no error)", value);
+      errors = errors + 1;
+    end
+    ack("ring", INT_DONE | INT_RING);
+    repeat (50) @(posedge ap_clk);
+    if (irq_edges - edges0 != 1) begin
+      $display("ERROR: %0d interrupts for one ring batch", irq_edges - edges0);
+      errors = errors + 1;
+    end
+
+    // 4. Error source: an operand read that fails
+    lite_wr(8'h08, INT_ERROR);
+    err_lo = ERR_BASE; err_hi = ERR_BASE + 32'h1000;
+    register_launch(ERR_BASE, C_BASE);
+    wait_irq("read error", 5000);
+    lite_rd(8'h00, status);
+    if (!status[0] || !status[2]) begin
+      $display("ERROR: STATUS %h at the error interrupt", status);
+      errors = errors + 1;
+    end
+    expect_reg("error status", 8'h0C, INT_DONE | INT_ERROR);
+    ack("error", INT_DONE | INT_ERROR);
+    err_lo = 0; err_hi = 0;
+
+    // A clean launch afterwards leaves the error source clear
+    register_launch(A_BASE, C_BASE);
+    while (dut.accelerator_done) @(posedge ap_clk);
+    while (!dut.accelerator_done) @(posedge ap_clk);
+    repeat (3) @(posedge ap_clk);
+    expect_reg("clean after error", 8'h0C, INT_DONE);
+
+    if (errors == 0)
+      $display("PASS");
+    else
+      $display("FAIL: %0d errors", errors);
+    $finish;
+  end
+
+  initial begin
+    #2_000_000;
+    $display("ERROR: simulation timed out");
+    $finish;
+  end
+
+endmodule
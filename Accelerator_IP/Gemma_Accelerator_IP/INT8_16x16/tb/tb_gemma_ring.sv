@@ -0,0 +1,436 @@
+`timescale 1ns / 1ps
+
+// Descriptor ring: batches of launches are written to a ring in the memory
+// model and started with one RING_TAIL write each. Checks every entry's C
+// against a reference product (dense, strided with ROWS, transposed, preload
+// plus cached reuse), that HEAD is written back to its 32-bit lane after
+// every entry, that a doorbell is accepted while the accelerator is busy,
+// that the ring wraps, and that an entry whose operand or descriptor read
+// fails is retired with the ring error set while later entries still run.
+module tb_gemma_ring;
+
+  localparam integer SIZE            = 16;
+  localparam integer ID_WIDTH        = 12;
+  localparam integer RD_LATENCY      = 20;
+  localparam integer WR_LATENCY      = 10;
+  localparam integer MAX_OUTSTANDING = 16;
+  localparam integer MEM_BYTES       = 64 * 1024;
+  localparam integer RING_ENTRIES    = 8;
+
+  reg ap_clk = 0;
+  reg ap_rst_n = 0;
+  always #5 ap_clk = ~ap_clk;
+
+  integer cycle = 0;
+  always @(posedge ap_clk) cycle <= cycle + 1;
+
+  // AXI-Lite control port
+  reg         s_axi_control_awvalid = 0;
+  wire        s_axi_control_awready;
+  reg  [7:0]  s_axi_control_awaddr = 0;
+  reg         s_axi_control_wvalid = 0;
+  wire        s_axi_control_wready;
+  reg  [31:0] s_axi_control_wdata = 0;
+  wire        s_axi_control_bvalid;
+  reg         s_axi_control_bready = 0;
+  wire [1:0]  s_axi_control_bresp;
+  wire [0:0]  s_axi_control_bid;
+  reg         s_axi_control_arvalid = 0;
+  wire        s_axi_control_arready;
+  reg  [7:0]  s_axi_control_araddr = 0;
+  wire        s_axi_control_rvalid;
+  reg         s_axi_control_rready = 0;
+  wire [31:0] s_axi_control_rdata;
+  wire [1:0]  s_axi_control_rresp;
+  wire [0:0]  s_axi_control_rid;
+
+  // AXI4 master port
+  wire [ID_WIDTH-1:0] m_axi_gmem_awid, m_axi_gmem_arid;
+  wire                m_axi_gmem_awvalid, m_axi_gmem_wvalid, m_axi_gmem_wlast, m_axi_gmem_bready;
+  wire                m_axi_gmem_arvalid, m_axi_gmem_rready;
+  wire [63:0]         m_axi_gmem_awaddr, m_axi_gmem_araddr;
+  wire [7:0]          m_axi_gmem_awlen, m_axi_gmem_arlen;
+  wire [2:0]          m_axi_gmem_awsize, m_axi_gmem_arsize;
+  wire [1:0]          m_axi_gmem_awburst, m_axi_gmem_arburst;
+  wire [127:0]        m_axi_gmem_wdata;
+  wire [15:0]         m_axi_gmem_wstrb;
+  reg                 m_axi_gmem_awready = 0, m_axi_gmem_wready = 0, m_axi_gmem_bvalid = 0;
+  reg                 m_axi_gmem_arready = 0, m_axi_gmem_rvalid = 0, m_axi_gmem_rlast = 0;
+  reg  [127:0]        m_axi_gmem_rdata = 0;
+  reg  [1:0]          m_axi_gmem_rresp = 0;
+
+  gemma_accelerator #(.ID_WIDTH(ID_WIDTH), .ARRAY_SIZE(SIZE)) dut (
+    .ap_clk(ap_clk), .ap_rst_n(ap_rst_n), .compute_clk(1'b0),
+    .s_axi_control_awvalid(s_axi_control_awvalid), .s_axi_control_awready(s_axi_control_awready),
+    .s_axi_control_awaddr(s_axi_control_awaddr),
+    .s_axi_control_wvalid(s_axi_control_wvalid), .s_axi_control_wready(s_axi_control_wready),
+    .s_axi_control_wdata(s_axi_control_wdata), .s_axi_control_wstrb(4'hF),
+    .s_axi_control_bvalid(s_axi_control_bvalid), .s_axi_control_bready(s_axi_control_bready),
+    .s_axi_control_bresp(s_axi_control_bresp), .s_axi_control_awid(1'b0), .s_axi_control_bid(s_axi_control_bid),
+    .s_axi_control_arvalid(s_axi_control_arvalid), .s_axi_control_arready(s_axi_control_arready),
+    .s_axi_control_araddr(s_axi_control_araddr),
+    .s_axi_control_rvalid(s_axi_control_rvalid), .s_axi_control_rready(s_axi_control_rready),
+    .s_axi_control_rdata(s_axi_control_rdata), .s_axi_control_rresp(s_axi_control_rresp),
+    .s_axi_control_arid(1'b0), .s_axi_control_rid(s_axi_control_rid),
+    .m_axi_gmem_awid(m_axi_gmem_awid), .m_axi_gmem_bid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_awvalid(m_axi_gmem_awvalid), .m_axi_gmem_awready(m_axi_gmem_awready),
+    .m_axi_gmem_awaddr(m_axi_gmem_awaddr), .m_axi_gmem_awlen(m_axi_gmem_awlen),
+    .m_axi_gmem_awsize(m_axi_gmem_awsize), .m_axi_gmem_awburst(m_axi_gmem_awburst),
+    .m_axi_gmem_wvalid(m_axi_gmem_wvalid), .m_axi_gmem_wready(m_axi_gmem_wready),
+    .m_axi_gmem_wdata(m_axi_gmem_wdata), .m_axi_gmem_wstrb(m_axi_gmem_wstrb), .m_axi_gmem_wlast(m_axi_gmem_wlast),
+    .m_axi_gmem_bvalid(m_axi_gmem_bvalid), .m_axi_gmem_bready(m_axi_gmem_bready), .m_axi_gmem_bresp(2'b00),
+    .m_axi_gmem_arid(m_axi_gmem_arid), .m_axi_gmem_rid({ID_WIDTH{1'b0}}),
+    .m_axi_gmem_arvalid(m_axi_gmem_arvalid), .m_axi_gmem_arready(m_axi_gmem_arready),
+    .m_axi_gmem_araddr(m_axi_gmem_araddr), .m_axi_gmem_arlen(m_axi_gmem_arlen),
+    .m_axi_gmem_arsize(m_axi_gmem_arsize), .m_axi_gmem_arburst(m_axi_gmem_arburst),
+    .m_axi_gmem_rvalid(m_axi_gmem_rvalid), .m_axi_gmem_rready(m_axi_gmem_rready),
+    .m_axi_gmem_rdata(m_axi_gmem_rdata), .m_axi_gmem_rlast(m_axi_gmem_rlast), .m_axi_gmem_rresp(m_axi_gmem_rresp)
+  );
+
+  // ---------------------------------------------------------------------
+  // Memory slave: byte array behind in-order AR/AW queues. Read bursts
+  // starting in [err_lo, err_hi) return SLVERR on every beat.
+  // ---------------------------------------------------------------------
+  reg [7:0] mem [0:MEM_BYTES-1];
+
+  reg [63:0] ar_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  ar_len   [0:MAX_OUTSTANDING-1];
+  reg        ar_err   [0:MAX_OUTSTANDING-1];
+  integer    ar_ready_at [0:MAX_OUTSTANDING-1];
+  integer    ar_head = 0, ar_tail = 0, ar_count = 0;
+  integer    r_beat = 0;
+
+  reg [63:0] aw_addr  [0:MAX_OUTSTANDING-1];
+  reg [7:0]  aw_len   [0:MAX_OUTSTANDING-1];
+  integer    aw_head = 0, aw_tail = 0, aw_count = 0;
+  integer    w_beat = 0;
+  integer    b_due   [0:MAX_OUTSTANDING-1];
+  integer    b_head = 0, b_tail = 0, b_count = 0;
+
+  reg [63:0] err_lo = 0, err_hi = 0;
+  integer    errors = 0;
+
+  integer l;
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      m_axi_gmem_arready <= 0; m_axi_gmem_rvalid <= 0; m_axi_gmem_rlast <= 0;
+      m_axi_gmem_awready <= 0; m_axi_gmem_wready <= 0; m_axi_gmem_bvalid <= 0;
+    end else begin
+      // AR: one request per cycle while the queue has room
+      m_axi_gmem_arready <= (ar_count + (m_axi_gmem_arvalid && m_axi_gmem_arready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_arvalid && m_axi_gmem_arready) begin
+        if (m_axi_gmem_arsize != 3'b100 || m_axi_gmem_arburst != 2'b01 ||
+            (m_axi_gmem_araddr[11:0] + (m_axi_gmem_arlen + 1) * 16 > 4096)) begin
+          $display("ERROR: bad read burst addr %h len %0d", m_axi_gmem_araddr, m_axi_gmem_arlen);
+          errors = errors + 1;
+        end
+        ar_addr[ar_tail] = m_axi_gmem_araddr;
+        ar_len[ar_tail] = m_axi_gmem_arlen;
+        ar_err[ar_tail] = (m_axi_gmem_araddr >= err_lo && m_axi_gmem_araddr < err_hi);
+        ar_ready_at[ar_tail] = cycle + RD_LATENCY;
+        ar_tail = (ar_tail + 1) % MAX_OUTSTANDING;
+        ar_count = ar_count + 1;
+      end
+
+      // R: the head burst streams once its latency has elapsed
+      if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+        if (m_axi_gmem_rlast) begin
+          r_beat = 0;
+          ar_head = (ar_head + 1) % MAX_OUTSTANDING;
+          ar_count = ar_count - 1;
+        end else
+          r_beat = r_beat + 1;
+      end
+      if (ar_count > 0 && cycle >= ar_ready_at[ar_head] && (!m_axi_gmem_rvalid || m_axi_gmem_rready)) begin
+        for (l = 0; l < 16; l = l + 1)
+          m_axi_gmem_rdata[l*8 +: 8] <= mem[ar_addr[ar_head] + r_beat * 16 + l];
+        m_axi_gmem_rvalid <= 1;
+        m_axi_gmem_rlast  <= (r_beat == ar_len[ar_head]);
+        m_axi_gmem_rresp  <= ar_err[ar_head] ? 2'b10 : 2'b00;
+      end else if (m_axi_gmem_rready) begin
+        m_axi_gmem_rvalid <= 0;
+        m_axi_gmem_rlast  <= 0;
+      end
+
+      // AW/W: data goes to the oldest open burst; B is due WR_LATENCY later
+      m_axi_gmem_awready <= (aw_count + b_count + (m_axi_gmem_awvalid && m_axi_gmem_awready) < MAX_OUTSTANDING);
+      if (m_axi_gmem_awvalid && m_axi_gmem_awready) begin
+        aw_addr[aw_tail] = m_axi_gmem_awaddr;
+        aw_len[aw_tail] = m_axi_gmem_awlen;
+        aw_tail = (aw_tail + 1) % MAX_OUTSTANDING;
+        aw_count = aw_count + 1;
+      end
+      m_axi_gmem_wready <= 1;
+      if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+        if (aw_count == 0) begin
+          $display("ERROR: W beat without an open write burst");
+          errors = errors + 1;
+        end
+        for (l = 0; l < 16; l = l + 1)
+          if (m_axi_gmem_wstrb[l])
+            mem[aw_addr[aw_head] + w_beat * 16 + l] = m_axi_gmem_wdata[l*8 +: 8];
+        if (m_axi_gmem_wlast != (w_beat == aw_len[aw_head])) begin
+          $display("ERROR: WLAST at beat %0d of a %0d-beat burst", w_beat, aw_len[aw_head] + 1);
+          errors = errors + 1;
+        end
+        if (m_axi_gmem_wlast) begin
+          w_beat = 0;
+          aw_head = (aw_head + 1) % MAX_OUTSTANDING;
+          aw_count = aw_count - 1;
+          b_due[b_tail] = cycle + WR_LATENCY;
+          b_tail = (b_tail + 1) % MAX_OUTSTANDING;
+          b_count = b_count + 1;
+        end else
+          w_beat = w_beat + 1;
+      end
+
+      // B: in order
+      if (m_axi_gmem_bvalid && m_axi_gmem_bready) begin
+        b_head = (b_head + 1) % MAX_OUTSTANDING;
+        b_count = b_count - 1;
+      end
+      m_axi_gmem_bvalid <= (b_count > 0 && cycle >= b_due[b_head]);
+    end
+  end
+
+  // ---------------------------------------------------------------------
+  // AXI-Lite access
+  // ---------------------------------------------------------------------
+  task automatic lite_wr(input [7:0] addr, input [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_awvalid <= 1; s_axi_control_awaddr <= addr;
+      s_axi_control_wvalid  <= 1; s_axi_control_wdata  <= data;
+      s_axi_control_bready  <= 1;
+      @(posedge ap_clk);
+      while (!(s_axi_control_awready && s_axi_control_wready)) @(posedge ap_clk);
+      s_axi_control_awvalid <= 0; s_axi_control_wvalid <= 0;
+      while (!s_axi_control_bvalid) @(posedge ap_clk);
+      @(posedge ap_clk);
+      s_axi_control_bready <= 0;
+    end
+  endtask
+
+  task automatic lite_rd(input [7:0] addr, output [31:0] data);
+    begin
+      @(posedge ap_clk);
+      s_axi_control_arvalid <= 1; s_axi_control_araddr <= addr; s_axi_control_rready <= 1;
+      @(posedge ap_clk);
+      while (!s_axi_control_arready) @(posedge ap_clk);
+      s_axi_control_arvalid <= 0;
+      while (!s_axi_control_rvalid) @(posedge ap_clk);
+      data = s_axi_control_rdata;
+      @(posedge ap_clk);
+      s_axi_control_rready <= 0;
+    end
+  endtask
+
+  // ---------------------------------------------------------------------
+  // Ring entries
+  // ---------------------------------------------------------------------
+  localparam [31:0] A_BASE = 32'h0000_1000, B_BASE = 32'h0000_2000;
+  localparam [31:0] RING_BASE = 32'h0000_3000, HEAD_WB = 32'h0000_3404;
+  localparam [31:0] C_BASE = 32'h0000_4000;  // Entry slot s writes C at C_BASE + s * 0x1000
+
+  // What each slot was last given, for checking
+  reg [31:0] e_a [0:RING_ENTRIES-1], e_b [0:RING_ENTRIES-1];
+  integer    e_lda [0:RING_ENTRIES-1], e_ldb [0:RING_ENTRIES-1], e_ldc [0:RING_ENTRIES-1];
+  integer    e_rows [0:RING_ENTRIES-1];
+  reg [31:0] e_ctrl [0:RING_ENTRIES-1];
+
+  task automatic put_word(input [31:0] addr, input [31:0] data);
+    integer i;
+    begin
+      for (i = 0; i < 4; i = i + 1) mem[addr + i] = data[i*8 +: 8];
+    end
+  endtask
+
+  function automatic [31:0] get_word(input [31:0] addr);
+    get_word = {mem[addr + 3], mem[addr + 2], mem[addr + 1], mem[addr]};
+  endfunction
+
+  task automatic put_entry(input integer slot, input [31:0] a, input [31:0] b, input integer lda,
+                           input integer ldb, input integer ldc, input integer rows, input [31:0] ctrl);
+    integer i;
+    reg [31:0] d;
+    begin
+      d = RING_BASE + slot * 64;
+      for (i = 0; i < 64; i = i + 1) mem[d + i] = 8'h00;
+      put_word(d + 8'h00, a);
+      put_word(d + 8'h08, b);
+      put_word(d + 8'h10, C_BASE + slot * 32'h1000);
+      put_word(d + 8'h18, lda);
+      put_word(d + 8'h1C, ldb);
+      put_word(d + 8'h20, ldc);
+      put_word(d + 8'h24, rows);
+      put_word(d + 8'h28, ctrl);
+      e_a[slot] = a; e_b[slot] = b; e_lda[slot] = lda; e_ldb[slot] = ldb;
+      e_ldc[slot] = ldc; e_rows[slot] = rows; e_ctrl[slot] = ctrl;
+      for (i = 0; i < 16'h1000; i = i + 1) mem[C_BASE + slot * 32'h1000 + i] = 8'hA5;
+    end
+  endtask
+
+  // C of one completed slot against the reference (a preload writes no C)
+  task automatic check_entry(input [8*16-1:0] name, input integer slot);
+    integer i, j, k, c_rows, ld_a, ld_b, ld_c, bad;
+    reg [31:0] c_base;
+    reg signed [31:0] ref_c, got;
+    reg signed [7:0]  a_ik, b_kj;
+    begin
+      ld_a = e_lda[slot] ? e_lda[slot] : SIZE;
+      ld_b = e_ldb[slot] ? e_ldb[slot] : SIZE;
+      ld_c = e_ldc[slot] ? e_ldc[slot] : SIZE * 4;
+      c_rows = e_rows[slot] ? e_rows[slot] : SIZE;
+      c_base = C_BASE + slot * 32'h1000;
+      bad = 0;
+      for (i = 0; i < SIZE; i = i + 1)
+        for (j = 0; j < SIZE; j = j + 1) begin
+          ref_c = 0;
+          for (k = 0; k < SIZE; k = k + 1) begin
+            a_ik = e_ctrl[slot][4] ? mem[e_a[slot] + k * ld_a + i] :
+                   (i < c_rows) ? mem[e_a[slot] + i * ld_a + k] : 8'd0;
+            b_kj = e_ctrl[slot][5] ? mem[e_b[slot] + j * ld_b + k] : mem[e_b[slot] + k * ld_b + j];
+            ref_c = ref_c + a_ik * b_kj;
+          end
+          got = get_word(c_base + i * ld_c + j * 4);
+          if (e_ctrl[slot][1] || i >= c_rows ? got !== 32'hA5A5A5A5 : got !== ref_c) begin
+            if (bad < 5)
+              $display("%0s C[%0d][%0d]: expected %0d, got %0d", name, i, j,
+                       e_ctrl[slot][1] || i >= c_rows ? 32'hA5A5A5A5 : ref_c, got);
+            bad = bad + 1;
+          end
+        end
+      errors = errors + bad;
+    end
+  endtask
+
+  // Ring the doorbell and wait for HEAD to reach the tail; returns the
+  // cycles taken and checks the written-back copy of HEAD
+  task automatic doorbell_and_drain(input integer tail, output integer cycles);
+    integer t0;
+    reg [31:0] head;
+    begin
+      t0 = cycle;
+      lite_wr(8'h90, tail);
+      head = 32'hFFFF_FFFF;
+      while (head != tail) lite_rd(8'h94, head);
+      while (dut.current_state != 4'd0) @(posedge ap_clk);
+      cycles = cycle - t0;
+      if (get_word(HEAD_WB) !== tail || get_word(HEAD_WB - 4) !== 32'hEEEE_EEEE ||
+          get_word(HEAD_WB + 4) !== 32'hEEEE_EEEE) begin
+        $display("ERROR: HEAD written back as %h (neighbours %h %h), expected %0d",
+                 get_word(HEAD_WB), get_word(HEAD_WB - 4), get_word(HEAD_WB + 4), tail);
+        errors = errors + 1;
+      end
+    end
+  endtask
+
+  integer i, t_batch, t_dbell, hits0;
+  reg [31:0] status, value;
+
+  initial begin
+    repeat (8) @(posedge ap_clk);
+    ap_rst_n <= 1;
+    for (i = 0; i < MEM_BYTES; i = i + 1) mem[i] = 8'h00;
+    for (i = 0; i < 16'h2000; i = i + 1)
+      mem[A_BASE + i] = (i == 0) ? 8'h80 : $random;
+    for (i = 0; i < 16; i = i + 1) mem[HEAD_WB - 8 + i] = 8'hEE;
+
+    lite_rd(8'h80, value);
+    if (value[7:4] < 2) begin
+      $display("ERROR: ACC_ID %h does not report the ring version", value);
+      errors = errors + 1;
+    end
+
+    lite_wr(8'h74, 32'h1);  // Cold weight cache
+    lite_wr(8'h84, RING_BASE); lite_wr(8'h88, 0);
+    lite_wr(8'h98, HEAD_WB);   lite_wr(8'h9C, 0);
+    lite_wr(8'h8C, RING_ENTRIES);
+
+    // Batch 1: five launches, one doorbell
+    //        slot A                B                 lda ldb ldc  rows ctrl
+    put_entry(0, A_BASE,          B_BASE,           0,  0,  0,   0,   32'h01);
+    put_entry(1, A_BASE + 16'h100, B_BASE,          64, 48, 128, 5,   32'h00);
+    put_entry(2, A_BASE,          B_BASE + 16'h400, 0,  0,  0,   0,   32'h30);
+    put_entry(3, A_BASE,          B_BASE + 16'h800, 0,  0,  0,   0,   32'hC2);  // Preload, pin
+    put_entry(4, A_BASE + 16'h200, B_BASE + 16'h800, 0, 0,  0,   0,   32'h40);  // Served from the cache
+    hits0 = dut.perf_wc_hits;
+    doorbell_and_drain(5, t_batch);
+    check_entry("dense", 0);
+    check_entry("strided rows 5", 1);
+    check_entry("transposed", 2);
+    check_entry("preload", 3);
+    check_entry("cached", 4);
+    if (dut.perf_wc_hits - hits0 != 1) begin
+      $display("ERROR: preloaded tile not reused (%0d cache hits)", dut.perf_wc_hits - hits0);
+      errors = errors + 1;
+    end
+    $display("batch of 5: %0d cycles from doorbell to HEAD", t_batch);
+
+    // Batch 2 wraps (slots 5, 6, 7 -> TAIL 0); the doorbell for 6 and 7 is
+    // written while slot 5 is running. Slot 6's A read fails.
+    put_entry(5, A_BASE + 16'h300, B_BASE, 0, 0, 0, 0, 32'h00);
+    lite_wr(8'h90, 6);
+    while (dut.current_state == 4'd0) @(posedge ap_clk);
+    put_entry(6, 32'h0000_E000, B_BASE, 0, 0, 0, 0, 32'h00);
+    put_entry(7, A_BASE + 16'h400, B_BASE + 16'h400, 0, 0, 0, 3, 32'h00);
+    err_lo = 32'h0000_E000; err_hi = 32'h0000_F000;
+    t_dbell = cycle;
+    lite_wr(8'h90, 0);
+    t_dbell = cycle - t_dbell;
+    if (dut.ring_head != 5) begin
+      $display("ERROR: doorbell waited for the running entry (%0d cycles)", t_dbell);
+      errors = errors + 1;
+    end
+    doorbell_and_drain(0, t_batch);
+    check_entry("wrapped 5", 5);
+    check_entry("after error", 7);
+    lite_rd(8'h00, status);
+    if (!status[3] || status[7]) begin
+      $display("ERROR: STATUS %h after a failed entry (expected ring error, ring empty)", status);
+      errors = errors + 1;
+    end
+    $display("busy doorbell took %0d cycles", t_dbell);
+
+    // Batch 3: slot 0's descriptor cannot be read; it is retired unrun
+    put_entry(0, A_BASE, B_BASE, 0, 0, 0, 0, 32'h00);
+    put_entry(1, A_BASE + 16'h500, B_BASE, 0, 0, 0, 0, 32'h00);
+    err_lo = RING_BASE; err_hi = RING_BASE + 64;
+    doorbell_and_drain(2, t_batch);
+    err_lo = 0; err_hi = 0;
+    e_ctrl[0] = 32'h02;  // Expect no C write
+    check_entry("bad descriptor", 0);
+    check_entry("after bad desc", 1);
+
+    // Rewriting RING_SIZE empties the ring and clears the error
+    lite_wr(8'h8C, RING_ENTRIES);
+    lite_rd(8'h00, status);
+    lite_rd(8'h94, value);
+    if (status[3] || value != 0) begin
+      $display("ERROR: ring reset left STATUS %h, HEAD %0d", status, value);
+      errors = errors + 1;
+    end
+
+    // A register launch after the ring
+    put_entry(2, A_BASE + 16'h600, B_BASE, 0, 0, 0, 0, 32'h00);
+    lite_wr(8'h10, e_a[2]); lite_wr(8'h1C, e_b[2]); lite_wr(8'h28, C_BASE + 2 * 32'h1000);
+    lite_wr(8'h54, 0); lite_wr(8'h58, 0); lite_wr(8'h5C, 0); lite_wr(8'h60, 0);
+    lite_wr(8'h00, 32'h01);
+    while (dut.accelerator_done) @(posedge ap_clk);
+    while (!dut.accelerator_done) @(posedge ap_clk);
+    check_entry("register launch", 2);
+
+    if (errors == 0)
+      $display("PASS");
+    else
+      $display("FAIL: %0d errors", errors);
+    $finish;
+  end
+
+  initial begin
+    #2_000_000;
+    $display("ERROR: simulation timed out");
+    $finish;
+  end
+
+endmodule
@@ -0,0 +1,188 @@
+`timescale 1ns / 1ps
+
+// Back-to-back tile streaming: NUM_TILES random tiles go through
+// systolic_array_16x16 (DUAL_MAC = 0 and 1) once with each tile's skewed
+// inputs following the previous tile's immediately, and once one tile at a
+// time (fill, compute, drain, as the accelerator runs a single launch).
+// Rows are captured on row_done and checked against a reference product;
+// occupancy is the share of cycles, from the first input to the last
+// finished row, in which each lane carries a useful operand.
+module tb_systolic_stream;
+
+  localparam integer SIZE        = 16;
+  localparam integer DATA_WIDTH  = 8;
+  localparam integer ACCUM_WIDTH = 32;
+  localparam integer NUM_TILES   = 64;
+
+  reg clk = 0;
+  reg rst = 1;
+  reg accum_reset = 0;
+  always #5 clk = ~clk;
+
+  reg  signed [DATA_WIDTH-1:0] a_mem [0:NUM_TILES-1][0:SIZE-1][0:SIZE-1];
+  reg  signed [DATA_WIDTH-1:0] b_mem [0:NUM_TILES-1][0:SIZE-1][0:SIZE-1];
+  reg  signed [SIZE*DATA_WIDTH-1:0] north_inputs, west_inputs;
+  reg  [SIZE-1:0] north_valid, west_valid, west_last;
+  wire signed [SIZE*SIZE*ACCUM_WIDTH-1:0] result_single, result_dual;
+  wire [SIZE-1:0] done_single, done_dual;
+
+  systolic_array_16x16 #(.SIZE(SIZE), .DATA_WIDTH(DATA_WIDTH), .ACCUM_WIDTH(ACCUM_WIDTH), .DUAL_MAC(0))
+    u_single (.clk(clk), .rst(rst), .accum_reset(accum_reset),
+              .north_inputs(north_inputs), .west_inputs(west_inputs),
+              .north_valid(north_valid), .west_valid(west_valid), .west_last(west_last),
+              .result_matrix(result_single), .row_done(done_single));
+
+  systolic_array_16x16 #(.SIZE(SIZE), .DATA_WIDTH(DATA_WIDTH), .ACCUM_WIDTH(ACCUM_WIDTH), .DUAL_MAC(1))
+    u_dual (.clk(clk), .rst(rst), .accum_reset(accum_reset),
+            .north_inputs(north_inputs), .west_inputs(west_inputs),
+            .north_valid(north_valid), .west_valid(west_valid), .west_last(west_last),
+            .result_matrix(result_dual), .row_done(done_dual));
+
+  // ---------------------------------------------------------------------
+  // Row checker: every finished row of either build against the reference
+  // ---------------------------------------------------------------------
+  integer cycle = 0;
+  integer last_done_cycle;
+  integer errors = 0;
+  integer rows_single, rows_dual;
+  integer row_tile_single [0:SIZE-1];
+  integer row_tile_dual   [0:SIZE-1];
+
+  always @(posedge clk) cycle <= cycle + 1;
+
+  function automatic signed [ACCUM_WIDTH-1:0] ref_c(input integer tile, input integer i, input integer j);
+    integer q;
+    begin
+      ref_c = 0;
+      for (q = 0; q < SIZE; q = q + 1)
+        ref_c = ref_c + a_mem[tile][i][q] * b_mem[tile][q][j];
+    end
+  endfunction
+
+  task automatic check_row(input integer build, input integer tile, input integer r,
+                           input [SIZE*SIZE*ACCUM_WIDTH-1:0] res);
+    integer j;
+    begin
+      for (j = 0; j < SIZE; j = j + 1)
+        if ($signed(res[(r*SIZE+j)*ACCUM_WIDTH +: ACCUM_WIDTH]) !== ref_c(tile, r, j)) begin
+          if (errors < 10)
+            $display("%s tile %0d C[%0d][%0d]: expected %0d, got %0d", build ? "dual" : "single",
+                     tile, r, j, ref_c(tile, r, j), $signed(res[(r*SIZE+j)*ACCUM_WIDTH +: ACCUM_WIDTH]));
+          errors = errors + 1;
+        end
+    end
+  endtask
+
+  integer cr;
+  always @(posedge clk) begin
+    for (cr = 0; cr < SIZE; cr = cr + 1) begin
+      if (done_single[cr]) begin
+        check_row(0, row_tile_single[cr], cr, result_single);
+        row_tile_single[cr] = row_tile_single[cr] + 1;
+        rows_single = rows_single + 1;
+        last_done_cycle = cycle;
+      end
+      if (done_dual[cr]) begin
+        check_row(1, row_tile_dual[cr], cr, result_dual);
+        row_tile_dual[cr] = row_tile_dual[cr] + 1;
+        rows_dual = rows_dual + 1;
+      end
+    end
+  end
+
+  // ---------------------------------------------------------------------
+  // Feed tiles [first, first + count) back to back with the accelerator's
+  // skew: lane i starts i + 1 cycles in
+  // ---------------------------------------------------------------------
+  task automatic feed_tiles(input integer first, input integer count);
+    integer t, i, e;
+    begin
+      for (t = 1; t <= count * SIZE + SIZE; t = t + 1) begin
+        @(posedge clk);
+        for (i = 0; i < SIZE; i = i + 1) begin
+          e = t - i - 1;
+          if (e >= 0 && e < count * SIZE) begin
+            north_inputs[i*DATA_WIDTH +: DATA_WIDTH] <= b_mem[first + e / SIZE][e % SIZE][i];
+            west_inputs[i*DATA_WIDTH +: DATA_WIDTH]  <= a_mem[first + e / SIZE][i][e % SIZE];
+            north_valid[i] <= 1'b1;
+            west_valid[i]  <= 1'b1;
+            west_last[i]   <= (e % SIZE == SIZE - 1);
+          end else begin
+            north_inputs[i*DATA_WIDTH +: DATA_WIDTH] <= 0;
+            west_inputs[i*DATA_WIDTH +: DATA_WIDTH]  <= 0;
+            north_valid[i] <= 1'b0;
+            west_valid[i]  <= 1'b0;
+            west_last[i]   <= 1'b0;
+          end
+        end
+      end
+    end
+  endtask
+
+  task automatic reset_counts;
+    integer r;
+    begin
+      rows_single = 0;
+      rows_dual = 0;
+      for (r = 0; r < SIZE; r = r + 1) begin
+        row_tile_single[r] = 0;
+        row_tile_dual[r] = 0;
+      end
+    end
+  endtask
+
+  task automatic report(input [8*8-1:0] mode, input integer start_cycle);
+    integer span;
+    begin
+      span = last_done_cycle - start_cycle + 1;
+      $display("%0s: %0d tiles in %0d cycles, %0d cycles/tile, occupancy %0d.%0d%%",
+               mode, NUM_TILES, span, span / NUM_TILES,
+               NUM_TILES * SIZE * 100 / span, (NUM_TILES * SIZE * 1000 / span) % 10);
+      if (rows_single != NUM_TILES * SIZE || rows_dual != NUM_TILES * SIZE) begin
+        $display("  missing rows: single %0d, dual %0d of %0d", rows_single, rows_dual, NUM_TILES * SIZE);
+        errors = errors + 1;
+      end
+    end
+  endtask
+
+  integer n, i, j, start_cycle;
+
+  initial begin
+    north_inputs = 0; west_inputs = 0; north_valid = 0; west_valid = 0; west_last = 0;
+    for (n = 0; n < NUM_TILES; n = n + 1)
+      for (i = 0; i < SIZE; i = i + 1)
+        for (j = 0; j < SIZE; j = j + 1) begin
+          a_mem[n][i][j] = (n == 0) ? -8'sd128 : $random;
+          b_mem[n][i][j] = (n == 0) ? -8'sd128 : $random;
+        end
+    reset_counts();
+    repeat (4) @(posedge clk);
+    rst <= 0;
+    @(posedge clk);
+
+    // Streamed: every tile right behind the previous one
+    start_cycle = cycle + 1;
+    feed_tiles(0, NUM_TILES);
+    repeat (2 * SIZE + 4) @(posedge clk);
+    report("stream", start_cycle);
+
+    // One tile at a time: clear, fill, compute, drain
+    reset_counts();
+    start_cycle = cycle + 1;
+    for (n = 0; n < NUM_TILES; n = n + 1) begin
+      @(posedge clk) accum_reset <= 1;
+      @(posedge clk) accum_reset <= 0;
+      feed_tiles(n, 1);
+      while (!done_single[SIZE-1]) @(posedge clk);
+    end
+    repeat (4) @(posedge clk);
+    report("per-tile", start_cycle);
+
+    if (errors == 0)
+      $display("PASS");
+    else
+      $display("FAIL: %0d errors", errors);
+    $finish;
+  end
+
+endmodule
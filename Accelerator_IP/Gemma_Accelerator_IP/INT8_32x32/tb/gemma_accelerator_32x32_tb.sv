@@ -98,20 +98,24 @@ module gemma_accelerator_32x32_tb;
   localparam [63:0] ADDR_C      = 64'h00023000;
 
   localparam [7:0]  ADDR_CTRL   = 8'h00;
-  localparam [7:0]  ADDR_STATUS = 8'h04;
+  localparam [7:0]  ADDR_STATUS = 8'h00;
   localparam [7:0]  A_LSB       = 8'h10;
   localparam [7:0]  A_MSB       = 8'h14;
-  localparam [7:0]  B_LSB       = 8'h18;
-  localparam [7:0]  B_MSB       = 8'h1C;
-  localparam [7:0]  C_LSB       = 8'h20;
-  localparam [7:0]  C_MSB       = 8'h24;
+  localparam [7:0]  B_LSB       = 8'h1C;
+  localparam [7:0]  B_MSB       = 8'h20;
+  localparam [7:0]  C_LSB       = 8'h28;
+  localparam [7:0]  C_MSB       = 8'h2C;
 
   //-------------------------------------------------------------------------
   // TB state
   //-------------------------------------------------------------------------
   reg  [7:0] read_count, write_count;
   reg        rd_a, rd_b;
+  reg  [7:0] rd_len;
+  integer    rd_off, wr_off;
   integer    errors;
+  integer    bad_addr;   // Bursts outside the A/B/C regions
+  integer    init_i;
 
   //-------------------------------------------------------------------------
   // DUT instantiation
@@ -126,6 +130,7 @@ module gemma_accelerator_32x32_tb;
   ) dut (
     .ap_clk               (ap_clk),
     .ap_rst_n             (ap_rst_n),
+    .compute_clk          (1'b0),
     // AXI-Lite
     .s_axi_control_awvalid(s_axi_control_awvalid),
     .s_axi_control_awready(s_axi_control_awready),
@@ -457,110 +462,136 @@ module gemma_accelerator_32x32_tb;
   endtask
 
 
- //-------------------------------------------------------------------------
-// AXI read-response model
 //-------------------------------------------------------------------------
-integer next_base, j;
-integer base, i;
+// AXI read-response model: decodes araddr into the A or B region, so a base
+// programmed at the wrong offset reads as an error instead of as mat_b
+//-------------------------------------------------------------------------
+ integer next_base, j;
+ integer base, i;
  
 always @(posedge ap_clk) begin
- if (!ap_rst_n) begin
-   m_axi_gmem_arready <= 0;
-   m_axi_gmem_rvalid  <= 0;
-   m_axi_gmem_rdata   <= 0;
-   m_axi_gmem_rlast   <= 0;
-   m_axi_gmem_rresp   <= 2'b00;
-   m_axi_gmem_rid     <= 0;
-   read_count         <= 0;
-   rd_a               <= 0;
-   rd_b               <= 0;
- end else begin
-   // AR handshake + start R burst
-   if (m_axi_gmem_arvalid && !m_axi_gmem_arready) begin
-     m_axi_gmem_arready <= 1;
-     m_axi_gmem_rid     <= m_axi_gmem_arid;
-     read_count         <= 0;
-     rd_a               <= (m_axi_gmem_araddr == ADDR_A);
-     rd_b               <= (m_axi_gmem_araddr == ADDR_B);
-     m_axi_gmem_rvalid  <= 1;
-      
-     // Load first beat data immediately
-
-     base = 0;
-     for (i = 0; i < 16; i = i + 1) begin
-       m_axi_gmem_rdata[i*8 +: 8] <= (m_axi_gmem_araddr == ADDR_A) ? mat_a[i] : mat_b[i];
-     end
-     m_axi_gmem_rlast <= (8'd0 == 8'd63);  // Check if single beat transfer
-   end else begin
-     m_axi_gmem_arready <= 0;
-   end
-
-   // Handle data transfer and burst advancement
-   if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
-     if (m_axi_gmem_rlast) begin
-       // End of burst
-       m_axi_gmem_rvalid <= 0;
-       m_axi_gmem_rlast  <= 0;
-     end else begin
-       // Advance to next beat
-       read_count <= read_count + 1;
-        
-       // Prepare next beat data
-
-       next_base = (read_count + 1) * 16;
-       for (j = 0; j < 16; j = j + 1) begin
-         m_axi_gmem_rdata[j*8 +: 8] <= rd_a ? mat_a[next_base + j] : mat_b[next_base + j];
-       end
-       m_axi_gmem_rlast <= ((read_count + 1) == 8'd63);  // Check if next beat is last (64 beats total)
-     end
-   end
- end
+  if (!ap_rst_n) begin
+    m_axi_gmem_arready <= 0;
+    m_axi_gmem_rvalid  <= 0;
+    m_axi_gmem_rdata   <= 0;
+    m_axi_gmem_rlast   <= 0;
+    m_axi_gmem_rresp   <= 2'b00;
+    m_axi_gmem_rid     <= 0;
+    read_count         <= 0;
+    rd_a               <= 0;
+    rd_b               <= 0;
+    rd_len             <= 0;
+    rd_off             <= 0;
+  end else begin
+    // AR handshake + start R burst (one burst at a time: the weight request
+    // issued during the activation burst waits for its last beat)
+    if (m_axi_gmem_arvalid && !m_axi_gmem_arready && !m_axi_gmem_rvalid) begin
+      m_axi_gmem_arready <= 1;
+      m_axi_gmem_rid     <= m_axi_gmem_arid;
+      read_count         <= 0;
+      rd_len             <= m_axi_gmem_arlen;
+      rd_a               <= (m_axi_gmem_araddr >= ADDR_A && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_A + NUM_ELEMENTS);
+      rd_b               <= (m_axi_gmem_araddr >= ADDR_B && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_B + NUM_ELEMENTS);
+      m_axi_gmem_rvalid  <= 1;
+
+      // Load first beat data immediately
+      if (m_axi_gmem_araddr >= ADDR_A && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_A + NUM_ELEMENTS) begin
+        base = m_axi_gmem_araddr - ADDR_A;
+        for (i = 0; i < 16; i = i + 1)
+          m_axi_gmem_rdata[i*8 +: 8] <= mat_a[base + i];
+        m_axi_gmem_rresp <= 2'b00;
+      end else if (m_axi_gmem_araddr >= ADDR_B && m_axi_gmem_araddr + (m_axi_gmem_arlen + 1) * 16 <= ADDR_B + NUM_ELEMENTS) begin
+        base = m_axi_gmem_araddr - ADDR_B;
+        for (i = 0; i < 16; i = i + 1)
+          m_axi_gmem_rdata[i*8 +: 8] <= mat_b[base + i];
+        m_axi_gmem_rresp <= 2'b00;
+      end else begin
+        $display("ERR: read burst at 0x%0h (len %0d) outside A and B", m_axi_gmem_araddr, m_axi_gmem_arlen + 1);
+        bad_addr = bad_addr + 1;
+        base = 0;
+        m_axi_gmem_rdata <= 128'd0;
+        m_axi_gmem_rresp <= 2'b10;
+      end
+      rd_off           <= base;
+      m_axi_gmem_rlast <= (m_axi_gmem_arlen == 8'd0);  // Single beat transfer
+    end else begin
+      m_axi_gmem_arready <= 0;
+    end
+
+    // Handle data transfer and burst advancement
+    if (m_axi_gmem_rvalid && m_axi_gmem_rready) begin
+      if (m_axi_gmem_rlast) begin
+        // End of burst
+        m_axi_gmem_rvalid <= 0;
+        m_axi_gmem_rlast  <= 0;
+      end else begin
+        // Advance to next beat
+        read_count <= read_count + 1;
+
+        // Prepare next beat data
+        next_base = rd_off + (read_count + 1) * 16;
+        for (j = 0; j < 16; j = j + 1) begin
+          m_axi_gmem_rdata[j*8 +: 8] <= rd_a ? mat_a[next_base + j] : rd_b ? mat_b[next_base + j] : 8'd0;
+        end
+        m_axi_gmem_rlast <= ((read_count + 1) == rd_len);  // Check if next beat is last
+      end
+    end
+  end
 end
 
+  //-------------------------------------------------------------------------
+  // AXI write-response model: results land at (awaddr - ADDR_C) / 4, so C
+  // written anywhere else is caught
+  //-------------------------------------------------------------------------
+  always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+      m_axi_gmem_awready <= 0;
+      m_axi_gmem_wready  <= 0;
+      m_axi_gmem_bvalid  <= 0;
+      m_axi_gmem_bresp   <= 2'b00;
+      m_axi_gmem_bid     <= 0;
+      write_count        <= 0;
+      wr_off             <= 0;
+    end else begin
+      if (m_axi_gmem_awvalid && !m_axi_gmem_awready) begin
+        m_axi_gmem_awready <= 1;
+        m_axi_gmem_bid     <= m_axi_gmem_awid;
+        write_count        <= 0;
+        if (m_axi_gmem_awaddr >= ADDR_C && m_axi_gmem_awaddr + (m_axi_gmem_awlen + 1) * 16 <= ADDR_C + 4 * NUM_ELEMENTS) begin
+          wr_off          <= (m_axi_gmem_awaddr - ADDR_C) / 4;
+          m_axi_gmem_bresp <= 2'b00;
+        end else begin
+          $display("ERR: write burst at 0x%0h (len %0d) outside C", m_axi_gmem_awaddr, m_axi_gmem_awlen + 1);
+          bad_addr = bad_addr + 1;
+          wr_off          <= -1;
+          m_axi_gmem_bresp <= 2'b10;
+        end
+      end else begin
+        m_axi_gmem_awready <= 0;
+      end
 
+      if (m_axi_gmem_awready)
+        m_axi_gmem_wready <= 1;
+
+      if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
+        integer base, i;
+        base = wr_off + write_count * 4;
+        if (wr_off >= 0)
+          for (i = 0; i < 4; i = i + 1)
+            if (m_axi_gmem_wstrb[i*4])
+              mat_c_act[base + i] = m_axi_gmem_wdata[i*32 +: 32];
+        if (m_axi_gmem_wlast) begin
+          m_axi_gmem_wready <= 0;
+          m_axi_gmem_bvalid <= 1;
+        end else begin
+          write_count <= write_count + 1;
+        end
+      end
 
- //-------------------------------------------------------------------------
- // AXI write-response model (unchanged)
- //-------------------------------------------------------------------------
- always @(posedge ap_clk) begin
-   if (!ap_rst_n) begin
-     m_axi_gmem_awready <= 0;
-     m_axi_gmem_wready  <= 0;
-     m_axi_gmem_bvalid  <= 0;
-     m_axi_gmem_bresp   <= 2'b00;
-     m_axi_gmem_bid     <= 0;
-     write_count        <= 0;
-   end else begin
-     if (m_axi_gmem_awvalid && !m_axi_gmem_awready) begin
-       m_axi_gmem_awready <= 1;
-       m_axi_gmem_bid     <= m_axi_gmem_awid;
-       write_count        <= 0;
-     end else begin
-       m_axi_gmem_awready <= 0;
-     end
-
-     if (m_axi_gmem_awready)
-       m_axi_gmem_wready <= 1;
-
-     if (m_axi_gmem_wvalid && m_axi_gmem_wready) begin
-       integer base, i;
-       base = write_count * 8;
-       for (i = 0; i < 8; i = i + 1) begin
-         mat_c_act[base + i] = {{16{m_axi_gmem_wdata[i*16+15]}},
-                                m_axi_gmem_wdata[i*16 +:16]};
-       end
-       if (m_axi_gmem_wlast) begin
-         m_axi_gmem_wready <= 0;
-         m_axi_gmem_bvalid <= 1;
-       end else begin
-         write_count <= write_count + 1;
-       end
-     end
-
-     if (m_axi_gmem_bvalid && m_axi_gmem_bready)
-       m_axi_gmem_bvalid <= 0;
-   end
- end
+      if (m_axi_gmem_bvalid && m_axi_gmem_bready)
+        m_axi_gmem_bvalid <= 0;
+    end
+  end
 
   //-------------------------------------------------------------------------
   // Wait for DONE bit-0
@@ -599,6 +630,10 @@ end
           errors = errors + 1;
         end
       end
+      if (bad_addr != 0) begin
+        $display("ERR: %0d bursts outside the programmed A/B/C regions", bad_addr);
+        errors = errors + bad_addr;
+      end
       if (errors == 0)
         $display("+++ PASS: all outputs match");
       else
@@ -616,10 +651,13 @@ end
     s_axi_control_bready  = 0;
     s_axi_control_arvalid = 0;
     s_axi_control_rready  = 0;
+    bad_addr             = 0;
     #100;
     ap_rst_n = 1;
 
     init_matrices();
+    for (init_i = 0; init_i < NUM_ELEMENTS; init_i = init_i + 1)
+      mat_c_act[init_i] = 32'hDEADBEEF;  // Unwritten results fail the compare
 
     // Program A, B, C bases
     axi_lite_wr(A_LSB, ADDR_A[31:0]);
@@ -1,3 +1,8 @@
+// AXI4 slave memory for the testbenches: 128-bit words, INCR bursts.
+// Read and write requests queue (any number outstanding, served in order),
+// R and W honour the valid/ready handshake, and write strobes are applied
+// per byte. A burst that leaves the memory or crosses a 4 KB boundary is
+// reported and answered with SLVERR.
 module axi_memory_model #(
     parameter ADDR_WIDTH = 64,
     parameter DATA_WIDTH = 128,
@@ -18,6 +23,7 @@ module axi_memory_model #(
     output logic rvalid,
     output logic [DATA_WIDTH-1:0] rdata,
     output logic rlast,
+    output logic [1:0] rresp,
     input  logic rready,
 
     // AXI Write Address
@@ -31,69 +37,136 @@ module axi_memory_model #(
     // AXI Write Data
     input  logic wvalid,
     input  logic [DATA_WIDTH-1:0] wdata,
-    input  logic [15:0] wstrb,
+    input  logic [DATA_WIDTH/8-1:0] wstrb,
     input  logic wlast,
     output logic wready,
 
     // Write Response
     output logic bvalid,
+    output logic [1:0] bresp,
     input  logic bready
 );
 
+    localparam int BYTES = DATA_WIDTH / 8;
+
     logic [DATA_WIDTH-1:0] mem [0:DEPTH-1];
 
-    logic [ADDR_WIDTH-1:0] rptr, wptr;
-    logic [7:0] r_cnt, w_cnt;
-    logic reading, writing;
+    typedef struct {
+        logic [ADDR_WIDTH-1:0] addr;
+        logic [7:0]            len;
+    } burst_t;
+
+    burst_t ar_q[$], aw_q[$];
+    logic [1:0] b_q[$];
+
+    function automatic logic burst_ok(input logic [ADDR_WIDTH-1:0] addr, input logic [7:0] len, input string kind);
+        longint first = addr / BYTES;
+        longint last  = first + len;
+        if (last >= DEPTH) begin
+            $error("%s burst 0x%0h len %0d runs past the %0d-word memory", kind, addr, len + 1, DEPTH);
+            return 0;
+        end
+        if ((addr % 4096) + (len + 1) * BYTES > 4096) begin
+            $error("%s burst 0x%0h len %0d crosses a 4 KB boundary", kind, addr, len + 1);
+            return 0;
+        end
+        return 1;
+    endfunction
+
+    assign arready = 1'b1;
+    assign awready = 1'b1;
+    assign wready  = 1'b1;
 
-    // Read FSM
-    always_ff @(posedge clk) begin
+    // Read: one beat per cycle from the oldest request
+    burst_t rd;
+    logic   rd_active, rd_ok;
+    logic [7:0] rd_beat;
+
+    always @(posedge clk) begin
         if (!rstn) begin
-            arready <= 0; rvalid <= 0; rlast <= 0; reading <= 0;
+            rvalid <= 0; rlast <= 0; rresp <= 0;
+            rd_active = 0;
+            ar_q.delete();
         end else begin
-            if (arvalid && !reading) begin
-                arready <= 1;
-                rptr <= araddr >> 4;
-                r_cnt <= arlen;
-                reading <= 1;
-            end else begin
-                arready <= 0;
+            if (arvalid && arready) begin
+                burst_t req;
+                req.addr = araddr;
+                req.len  = arlen;
+                ar_q.push_back(req);
             end
 
-            if (reading && rready) begin
-                rdata <= mem[rptr];
-                rptr <= rptr + 1;
-                rlast <= (r_cnt == 0);
-                rvalid <= 1;
-                if (r_cnt == 0) reading <= 0;
-                else r_cnt <= r_cnt - 1;
-            end else rvalid <= 0;
+            if (rvalid && rready)
+                rvalid <= 0;
+
+            if (!rvalid || rready) begin
+                if (!rd_active && ar_q.size() > 0) begin
+                    rd        = ar_q.pop_front();
+                    rd_ok     = burst_ok(rd.addr, rd.len, "Read");
+                    rd_beat   = 0;
+                    rd_active = 1;
+                end
+                if (rd_active) begin
+                    rdata  <= rd_ok ? mem[rd.addr / BYTES + rd_beat] : '0;
+                    rresp  <= rd_ok ? 2'b00 : 2'b10;
+                    rlast  <= (rd_beat == rd.len);
+                    rvalid <= 1;
+                    if (rd_beat == rd.len)
+                        rd_active = 0;
+                    else
+                        rd_beat = rd_beat + 1;
+                end
+            end
         end
     end
 
-    // Write FSM
-    always_ff @(posedge clk) begin
+    // Write: beats land in the oldest open burst
+    burst_t wr;
+    logic   wr_active, wr_ok;
+    logic [7:0] wr_beat;
+
+    always @(posedge clk) begin
         if (!rstn) begin
-            awready <= 0; wready <= 0; bvalid <= 0; writing <= 0;
+            bvalid <= 0; bresp <= 0;
+            wr_active = 0;
+            aw_q.delete();
+            b_q.delete();
         end else begin
-            if (awvalid && !writing) begin
-                awready <= 1;
-                wptr <= awaddr >> 4;
-                w_cnt <= awlen;
-                writing <= 1;
-            end else awready <= 0;
-
-            if (writing && wvalid) begin
-                mem[wptr] <= wdata;
-                wptr <= wptr + 1;
-                if (w_cnt == 0 || wlast) begin
-                    bvalid <= 1;
-                    writing <= 0;
-                end else w_cnt <= w_cnt - 1;
-                wready <= 1;
-            end else wready <= 0;
-
-            if (bvalid && bready) bvalid <= 0;
+            if (awvalid && awready) begin
+                burst_t req;
+                req.addr = awaddr;
+                req.len  = awlen;
+                aw_q.push_back(req);
+            end
+
+            if (wvalid && wready) begin
+                if (!wr_active) begin
+                    if (aw_q.size() == 0)
+                        $fatal(1, "Write data beat with no write address");
+                    wr        = aw_q.pop_front();
+                    wr_ok     = burst_ok(wr.addr, wr.len, "Write");
+                    wr_beat   = 0;
+                    wr_active = 1;
+                end
+                if (wr_ok)
+                    for (int i = 0; i < BYTES; i++)
+                        if (wstrb[i])
+                            mem[wr.addr / BYTES + wr_beat][i*8 +: 8] = wdata[i*8 +: 8];
+                if (wlast != (wr_beat == wr.len))
+                    $error("WLAST on beat %0d of a %0d-beat burst", wr_beat + 1, wr.len + 1);
+                if (wr_beat == wr.len) begin
+                    b_q.push_back(wr_ok ? 2'b00 : 2'b10);
+                    wr_active = 0;
+                end else begin
+                    wr_beat = wr_beat + 1;
+                end
+            end
+
+            if (bvalid && bready)
+                bvalid <= 0;
+            if ((!bvalid || bready) && b_q.size() > 0) begin
+                bresp  <= b_q.pop_front();
+                bvalid <= 1;
+            end
         end
     end
 
@@ -1,30 +1,55 @@
+// Output-stationary INT4 PE. Operands arrive widened to DATA_WIDTH bits
+// (sign or zero extended by the feed), so one signed multiplier serves both
+// signed and unsigned INT4. inp_valid, inp_first and inp_last travel east
+// with the west operand: the first K element of a C tile restarts the sum,
+// and the last one moves it to `result`, which holds until the next tile
+// ends. Cycles without inp_valid leave the sum alone.
 module pe #(
-    parameter DATA_WIDTH = 8
+    parameter DATA_WIDTH = 5,
+    parameter ACCUM_WIDTH = 32
 )(
     input clk,
     input rst,
+    input inp_valid,
+    input inp_first,
+    input inp_last,
     input [DATA_WIDTH-1:0] inp_north,
     input [DATA_WIDTH-1:0] inp_west,
+    output reg outp_valid,
+    output reg outp_first,
+    output reg outp_last,
     output reg [DATA_WIDTH-1:0] outp_south,
     output reg [DATA_WIDTH-1:0] outp_east,
-    output reg [2*DATA_WIDTH-1:0] result
+    output reg signed [ACCUM_WIDTH-1:0] result
 );
 
+reg  signed [ACCUM_WIDTH-1:0]  accum;
+wire signed [2*DATA_WIDTH-1:0] prod = $signed(inp_north) * $signed(inp_west);
+wire signed [ACCUM_WIDTH-1:0]  base = inp_first ? {ACCUM_WIDTH{1'b0}} : accum;
+wire signed [ACCUM_WIDTH-1:0]  sum  = base + prod;
+
 always @(posedge clk or posedge rst) begin
     if (rst) begin
         outp_south <= 0;
         outp_east <= 0;
+        outp_valid <= 0;
+        outp_first <= 0;
+        outp_last <= 0;
+        accum <= 0;
         result <= 0;
     end else begin
         outp_south <= inp_north;
         outp_east <= inp_west;
-        
-        // Accumulate when both inputs are valid (non-zero)
-        if (inp_north != 0 && inp_west != 0) begin
-            result <= result + (inp_north * inp_west);
+        outp_valid <= inp_valid;
+        outp_first <= inp_first;
+        outp_last <= inp_last;
+
+        if (inp_valid) begin
+            accum <= sum;
+            if (inp_last)
+                result <= sum;
         end
-        // Keep previous result when inputs are zero (no accumulation)
     end
 end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -1,187 +1,342 @@
 `timescale 1ns / 1ps
 
+// INT4 x INT4 GEMM engine: C (M x N, INT32) = A (M x K) * B (K x N) for any
+// M, N, K up to 65535, tiled onto a SIZE x SIZE systolic array.
+//
+// Operands are packed INT4, two per byte, low nibble first, rows K-contiguous:
+// A is M x K row-major and B is given as W = B^T, N x K row-major (the way
+// linear-layer weights are stored). One 128-bit beat carries 32 operands,
+// so a C tile reads half the bytes the INT8 accelerator does for the same K.
+//
+// The register map follows gemma_accelerator (32-bit AXI-Lite, 64-bit
+// addresses as LSB/MSB pairs); only the GEMM shape and the busy-cycle
+// counter live past the INT8 map, at 0xA0-0xAC. For each C tile the read
+// engine streams K in chunks of CHUNK_BEATS beats per row, one burst per
+// row, into one of two chunk banks while the array sums the other. Finished
+// tiles leave as one write burst per C row while the next tile computes.
+//
+// Alignment: A, B, LDA and LDB multiples of 16 * CHUNK_BEATS bytes, C and
+// LDC multiples of 4 * SIZE bytes, so no burst crosses a 4 KB boundary.
 module systolic_array_axi_stream #(
-    parameter SIZE = 8,
+    parameter SIZE = 8,          // Array is SIZE x SIZE: 8, 16 or 32
     parameter DATA_WIDTH = 4,
-    parameter ADDR_WIDTH = 6,
-    parameter BUFFER_DEPTH = 64
+    parameter CHUNK_BEATS = 4    // K per chunk = 32 * CHUNK_BEATS (power of two)
 )(
-    input wire s_axi_aclk,
-    input wire s_axi_aresetn,
+    input  wire          ap_clk,
+    input  wire          ap_rst_n,
+    output reg           interrupt,    // Level: INT_GIE on and an enabled INT_STATUS bit set
 
     // AXI4-Lite Slave Interface (Control)
-    input  wire [63:0]  s_axi_awaddr,
-    input  wire         s_axi_awvalid,
-    output reg          s_axi_awready,
-    input  wire [127:0] s_axi_wdata,
-    input  wire         s_axi_wvalid,
-    output reg          s_axi_wready,
-    input  wire         s_axi_bready,
-    output reg          s_axi_bvalid,
-    output reg [1:0]    s_axi_bresp,
-    input  wire [63:0]  s_axi_araddr,
-    input  wire         s_axi_arvalid,
-    output reg          s_axi_arready,
-    output reg [127:0]  s_axi_rdata,
-    output reg          s_axi_rvalid,
-    output reg [1:0]    s_axi_rresp,
-    input  wire         s_axi_rready,
+    input  wire          s_axi_control_awvalid,
+    output wire          s_axi_control_awready,
+    input  wire [7:0]    s_axi_control_awaddr,
+    input  wire          s_axi_control_wvalid,
+    output wire          s_axi_control_wready,
+    input  wire [31:0]   s_axi_control_wdata,
+    input  wire [3:0]    s_axi_control_wstrb,
+    output reg           s_axi_control_bvalid,
+    input  wire          s_axi_control_bready,
+    output wire [1:0]    s_axi_control_bresp,
+    input  wire          s_axi_control_arvalid,
+    output wire          s_axi_control_arready,
+    input  wire [7:0]    s_axi_control_araddr,
+    output reg           s_axi_control_rvalid,
+    input  wire          s_axi_control_rready,
+    output reg  [31:0]   s_axi_control_rdata,
+    output wire [1:0]    s_axi_control_rresp,
 
     // AXI Master Interface
-    output reg          m_axi_arvalid,
-    input  wire         m_axi_arready,
-    output reg [63:0]   m_axi_araddr,
-    output reg [7:0]    m_axi_arlen,
-    output reg [2:0]    m_axi_arsize,
-    output reg [1:0]    m_axi_arburst,
-    input  wire         m_axi_rvalid,
-    input  wire [127:0] m_axi_rdata,
-    input  wire         m_axi_rlast,
-    output reg          m_axi_rready,
-
-    output reg          m_axi_awvalid,
-    input  wire         m_axi_awready,
-    output reg [63:0]   m_axi_awaddr,
-    output reg [7:0]    m_axi_awlen,
-    output reg [2:0]    m_axi_awsize,
-    output reg [1:0]    m_axi_awburst,
-
-    output reg          m_axi_wvalid,
-    input  wire         m_axi_wready,
-    output reg [127:0]  m_axi_wdata,
-    output reg [15:0]   m_axi_wstrb,
-    output reg          m_axi_wlast,
-
-    input  wire         m_axi_bvalid,
-    output reg          m_axi_bready
+    output reg           m_axi_gmem_arvalid,
+    input  wire          m_axi_gmem_arready,
+    output reg  [63:0]   m_axi_gmem_araddr,
+    output reg  [7:0]    m_axi_gmem_arlen,
+    output wire [2:0]    m_axi_gmem_arsize,
+    output wire [1:0]    m_axi_gmem_arburst,
+    input  wire          m_axi_gmem_rvalid,
+    input  wire [127:0]  m_axi_gmem_rdata,
+    input  wire          m_axi_gmem_rlast,
+    input  wire [1:0]    m_axi_gmem_rresp,
+    output wire          m_axi_gmem_rready,
+
+    output reg           m_axi_gmem_awvalid,
+    input  wire          m_axi_gmem_awready,
+    output reg  [63:0]   m_axi_gmem_awaddr,
+    output reg  [7:0]    m_axi_gmem_awlen,
+    output wire [2:0]    m_axi_gmem_awsize,
+    output wire [1:0]    m_axi_gmem_awburst,
+
+    output reg           m_axi_gmem_wvalid,
+    input  wire          m_axi_gmem_wready,
+    output reg  [127:0]  m_axi_gmem_wdata,
+    output reg  [15:0]   m_axi_gmem_wstrb,
+    output reg           m_axi_gmem_wlast,
+
+    input  wire          m_axi_gmem_bvalid,
+    input  wire [1:0]    m_axi_gmem_bresp,
+    output wire          m_axi_gmem_bready
 );
 
 // --------------------------------------------------
 // Control Registers
 // --------------------------------------------------
-localparam REG_CONTROL      = 0;
-localparam REG_SIZE         = 1;
-localparam REG_STATUS       = 2;
-localparam REG_ADDR_A_BASE  = 3;
-localparam REG_ADDR_B_BASE  = 4;
-localparam REG_ADDR_C_BASE  = 5;
-
-reg [31:0] slv_reg [0:15];
-wire       start       = slv_reg[REG_CONTROL][0];
-wire [7:0] matrix_size = slv_reg[REG_SIZE][7:0];
-// wire [63:0] addr_a     = {slv_reg[REG_ADDR_A_BASE], 2'b00};
-// wire [63:0] addr_b     = {slv_reg[REG_ADDR_B_BASE], 2'b00};
-// wire [63:0] addr_c     = {slv_reg[REG_ADDR_C_BASE], 2'b00};
-
-wire [63:0] addr_a     = {slv_reg[REG_ADDR_A_BASE]};
-wire [63:0] addr_b     = {slv_reg[REG_ADDR_B_BASE]};
-wire [63:0] addr_c     = {slv_reg[REG_ADDR_C_BASE]};
-
-wire done, result_valid;
+localparam [7:0]
+    ADDR_CTRL   = 8'h00,  ADDR_STATUS = 8'h00,  // W: bit0 start, bit3 unsigned operands
+                                                // R: bit0 done, bit1 busy, bit2 axi_error, bit3 unsigned
+    INT_GIE     = 8'h04,  // bit0: global enable of the interrupt output
+    INT_ENABLE  = 8'h08,  // Per-source enables, bits as in INT_STATUS
+    INT_STATUS  = 8'h0C,  // bit0 run done, bit2 error; write 1 to clear
+    A_LSB       = 8'h10,  A_MSB       = 8'h14,
+    B_LSB       = 8'h1C,  B_MSB       = 8'h20,  // W = B^T, N x K
+    C_LSB       = 8'h28,  C_MSB       = 8'h2C,
+    LDA         = 8'h54,  // Row pitches in bytes, 0 = packed (see lda_eff)
+    LDB         = 8'h58,
+    LDC         = 8'h5C,
+    PERF_ACT_BEATS = 8'h64,  // A read beats (free-running, wrap)
+    PERF_WGT_BEATS = 8'h68,  // W read beats
+    PERF_OUT_BEATS = 8'h6C,  // C write beats
+    ACC_ID      = 8'h80,  // {8'h34, SIZE, CHUNK_BEATS, ID_VERSION, 4'd0}
+    DIM_M       = 8'hA0,
+    DIM_N       = 8'hA4,
+    DIM_K       = 8'hA8,
+    PERF_BUSY_CYCLES = 8'hAC;
+
+// gemm_offload reads the signature byte, so it never mistakes this engine
+// for the INT8 accelerator ('G')
+localparam [7:0]  ID_SIGNATURE = 8'h34;  // '4'
+localparam [7:0]  ID_SIZE      = SIZE;
+localparam [7:0]  ID_CHUNK     = CHUNK_BEATS;
+localparam [3:0]  ID_VERSION   = 4'd1;
+localparam [31:0] ACC_ID_VALUE = {ID_SIGNATURE, ID_SIZE, ID_CHUNK, ID_VERSION, 4'd0};
+
+localparam integer INT_SOURCES   = 3;
+localparam integer BUS_BYTES     = 16;
+localparam integer BEAT_ELEMS    = 128 / DATA_WIDTH;       // 32 operands per beat
+localparam integer CHUNK_K       = CHUNK_BEATS * BEAT_ELEMS;
+localparam integer CHUNK_BYTES   = CHUNK_BEATS * BUS_BYTES;
+localparam integer OUT_ROW_BEATS = SIZE * 4 / BUS_BYTES;
+localparam integer LOG_SIZE      = $clog2(SIZE);
+localparam integer LOG_CHUNK_K   = $clog2(CHUNK_K);
+localparam integer SIZE_W        = $clog2(SIZE + 1);
+localparam integer K_W           = $clog2(CHUNK_K + 1);
+localparam integer CB_W          = $clog2(CHUNK_BEATS + 1);
+localparam integer RB_W          = $clog2(OUT_ROW_BEATS + 1);
+
+reg  [63:0] addr_a_reg, addr_b_reg, addr_c_reg;
+reg  [31:0] lda_reg, ldb_reg, ldc_reg;
+reg  [15:0] dim_m, dim_n, dim_k;
+reg         unsigned_ops;
+reg         start_pulse;
+reg         running, run_done, axi_error;
+reg         int_gie;
+reg  [INT_SOURCES-1:0] int_enable, int_status;
+reg  [31:0] perf_act_beats, perf_wgt_beats, perf_out_beats, perf_busy_cycles;
+
+reg  [7:0]  awaddr_latched;
+reg  [31:0] wdata_latched;
+reg  [3:0]  wstrb_latched;
+reg         awvalid_seen, wvalid_seen;
+
+// Tile counts and packed pitches: a packed operand row is K/2 bytes rounded
+// up to a whole chunk, a packed C row is N rounded up to a whole tile
+wire [15:0] tiles_m = (dim_m + SIZE - 1) >> LOG_SIZE;
+wire [15:0] tiles_n = (dim_n + SIZE - 1) >> LOG_SIZE;
+wire [15:0] tiles_k = (dim_k + CHUNK_K - 1) >> LOG_CHUNK_K;
+wire [31:0] lda_eff = (lda_reg == 32'd0) ? tiles_k * CHUNK_BYTES : lda_reg;
+wire [31:0] ldb_eff = (ldb_reg == 32'd0) ? tiles_k * CHUNK_BYTES : ldb_reg;
+wire [31:0] ldc_eff = (ldc_reg == 32'd0) ? tiles_n * SIZE * 4    : ldc_reg;
+wire        empty_run = (dim_m == 0) || (dim_n == 0) || (dim_k == 0);
+
+// Rows (or columns) of tile t inside a dimension of dim
+function [SIZE_W-1:0] tile_rows;
+    input [15:0] dim;
+    input [15:0] t;
+    reg   [15:0] left;
+    begin
+        left = dim - (t << LOG_SIZE);
+        tile_rows = (left >= SIZE) ? SIZE : left[SIZE_W-1:0];
+    end
+endfunction
+
+// K elements in chunk kc
+function [K_W-1:0] chunk_elems;
+    input [15:0] kc;
+    reg   [15:0] left;
+    begin
+        left = dim_k - (kc << LOG_CHUNK_K);
+        chunk_elems = (left >= CHUNK_K) ? CHUNK_K : left[K_W-1:0];
+    end
+endfunction
+
+// Merge function to handle byte-wise writes
+function [31:0] merge_by_wstrb;
+    input [31:0] oldw;
+    input [31:0] neww;
+    input [3:0]  wstrb;
+    begin
+        merge_by_wstrb = oldw;
+        if (wstrb[0]) merge_by_wstrb[ 7: 0] = neww[ 7: 0];
+        if (wstrb[1]) merge_by_wstrb[15: 8] = neww[15: 8];
+        if (wstrb[2]) merge_by_wstrb[23:16] = neww[23:16];
+        if (wstrb[3]) merge_by_wstrb[31:24] = neww[31:24];
+    end
+endfunction
 
 // --------------------------------------------------
-// AXI-Lite Read/Write Handling
+// Read engine
 // --------------------------------------------------
-always @(posedge s_axi_aclk) begin
-    if (!s_axi_aresetn) begin
-        s_axi_awready <= 0; s_axi_wready <= 0; s_axi_bvalid <= 0;
-        s_axi_arready <= 0; s_axi_rvalid <= 0; s_axi_rdata <= 0;
+// Requests walk tiles in C order (tm, then tn) and K chunks inside each:
+// a chunk is A rows then W rows, one burst per row. The data side walks the
+// same order with its own counters, since every request uses the same ID
+// and bursts return in order. A chunk's requests start only once its bank
+// is free, so R is always ready.
+reg         ar_active, ar_all, ar_w, ar_bank;
+reg  [15:0] ar_tm, ar_tn, ar_kc;
+reg  [SIZE_W-1:0] ar_row;
+reg  [1:0]  bank_busy;
+
+reg  [15:0] rd_tm, rd_tn, rd_kc;
+reg         rd_w, rd_bank;
+reg  [SIZE_W-1:0] rd_row;
+reg  [CB_W-1:0]   rd_beat;
+
+wire [SIZE_W-1:0] ar_a_rows = tile_rows(dim_m, ar_tm);
+wire [SIZE_W-1:0] ar_w_rows = tile_rows(dim_n, ar_tn);
+wire [K_W-1:0]    ar_elems  = chunk_elems(ar_kc);
+wire [CB_W-1:0]   ar_beats  = (ar_elems + BEAT_ELEMS - 1) / BEAT_ELEMS;
+wire              ar_last_row = ar_row == (ar_w ? ar_w_rows : ar_a_rows) - 1'b1;
+
+wire [SIZE_W-1:0] rd_a_rows = tile_rows(dim_m, rd_tm);
+wire [SIZE_W-1:0] rd_w_rows = tile_rows(dim_n, rd_tn);
+wire [K_W-1:0]    rd_elems  = chunk_elems(rd_kc);
+wire [CB_W-1:0]   rd_beats  = (rd_elems + BEAT_ELEMS - 1) / BEAT_ELEMS;
+wire              rd_fire   = m_axi_gmem_rvalid && m_axi_gmem_rready;
+wire              rd_row_end   = (rd_beat == rd_beats - 1'b1);
+wire              rd_chunk_end = rd_row_end && rd_w && (rd_row == rd_w_rows - 1'b1);
+
+// Core load port, one cycle behind R
+reg               load_en, load_w, load_bank;
+reg  [SIZE_W-1:0] load_row;
+reg  [CB_W-1:0]   load_beat;
+reg  [127:0]      load_data;
+reg               chunk_push, chunk_bank, chunk_first, chunk_last;
+reg  [K_W-1:0]    chunk_len;
+reg  [SIZE_W-1:0] chunk_a_rows, chunk_w_rows;
+wire [1:0]        chunk_done;
+
+assign m_axi_gmem_arsize  = 3'b100;  // 16 bytes
+assign m_axi_gmem_arburst = 2'b01;   // INCR
+assign m_axi_gmem_rready  = 1'b1;
+
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        m_axi_gmem_arvalid <= 0;
+        m_axi_gmem_araddr  <= 0;
+        m_axi_gmem_arlen   <= 0;
+        ar_active <= 0; ar_all <= 1; ar_w <= 0; ar_bank <= 0;
+        ar_tm <= 0; ar_tn <= 0; ar_kc <= 0; ar_row <= 0;
+        bank_busy <= 2'b00;
     end else begin
-        s_axi_awready <= s_axi_awvalid;
-        s_axi_wready <= s_axi_wvalid;
-
-        if (s_axi_awvalid && s_axi_wvalid) begin
-            slv_reg[s_axi_awaddr[5:2]] <= s_axi_wdata[31:0];
-            s_axi_bvalid <= 1;
-        end
-
-        if (s_axi_bvalid && s_axi_bready)
-            s_axi_bvalid <= 0;
-
-        s_axi_arready <= s_axi_arvalid;
-        if (s_axi_arvalid) begin
-            s_axi_rdata <= {96'd0, slv_reg[s_axi_araddr[5:2]]};
-            s_axi_rvalid <= 1;
+        bank_busy <= bank_busy & ~chunk_done;
+
+        if (m_axi_gmem_arvalid && m_axi_gmem_arready)
+            m_axi_gmem_arvalid <= 0;
+
+        // ar_bank, rd_bank and the core's feed bank each flip once per
+        // chunk and carry over between runs, so they stay in step
+        if (start_pulse) begin
+            ar_all  <= empty_run;
+            ar_tm <= 0; ar_tn <= 0; ar_kc <= 0;
+        end else if (!ar_active && !ar_all && !bank_busy[ar_bank]) begin
+            ar_active <= 1;
+            ar_w      <= 0;
+            ar_row    <= 0;
+            bank_busy[ar_bank] <= 1'b1;
+        end else if (ar_active && (!m_axi_gmem_arvalid || m_axi_gmem_arready)) begin
+            m_axi_gmem_arvalid <= 1;
+            m_axi_gmem_arlen   <= ar_beats - 1'b1;
+            m_axi_gmem_araddr  <= ar_w ? addr_b_reg + ((ar_tn << LOG_SIZE) + ar_row) * ldb_eff + ar_kc * CHUNK_BYTES
+                                       : addr_a_reg + ((ar_tm << LOG_SIZE) + ar_row) * lda_eff + ar_kc * CHUNK_BYTES;
+            ar_row <= ar_row + 1'b1;
+            if (ar_last_row) begin
+                ar_row <= 0;
+                if (!ar_w) begin
+                    ar_w <= 1;
+                end else begin
+                    // Chunk requested: next chunk, tile column, tile row
+                    ar_active <= 0;
+                    ar_bank   <= ~ar_bank;
+                    if (ar_kc != tiles_k - 1) begin
+                        ar_kc <= ar_kc + 1'b1;
+                    end else begin
+                        ar_kc <= 0;
+                        if (ar_tn != tiles_n - 1) begin
+                            ar_tn <= ar_tn + 1'b1;
+                        end else begin
+                            ar_tn <= 0;
+                            if (ar_tm != tiles_m - 1)
+                                ar_tm <= ar_tm + 1'b1;
+                            else
+                                ar_all <= 1;
+                        end
+                    end
+                end
+            end
         end
-        if (s_axi_rvalid && s_axi_rready)
-            s_axi_rvalid <= 0;
     end
 end
 
-// --------------------------------------------------
-// Read FSM with 256-bit buffering (Matrix A and B)
-// --------------------------------------------------
-reg reading_a, reading_b, compute_start;
-reg [5:0] load_idx;
-reg weight_load_en, activation_load_en;
-
-// reg [255:0] axi_rdata_reg_A, axi_rdata_reg_B;
-reg [1:0] burst_count;
-reg [127:0] last_rdata;
-
-reg [255:0] weight_buffer, activation_buffer;
-
-always @(posedge s_axi_aclk) begin
-    if (!s_axi_aresetn) begin
-        reading_a <= 0; reading_b <= 0; compute_start <= 0;
-        m_axi_arvalid <= 0; m_axi_rready <= 1;
-        burst_count <= 0;
-        // axi_rdata_reg_A <= 0;
-        // axi_rdata_reg_B <= 0;
-        weight_load_en <= 0;
-        activation_load_en <= 0;
-        load_idx <= 0;
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        rd_tm <= 0; rd_tn <= 0; rd_kc <= 0;
+        rd_w <= 0; rd_bank <= 0; rd_row <= 0; rd_beat <= 0;
+        load_en <= 0; load_w <= 0; load_bank <= 0; load_row <= 0; load_beat <= 0; load_data <= 0;
+        chunk_push <= 0; chunk_bank <= 0; chunk_first <= 0; chunk_last <= 0;
+        chunk_len <= 0; chunk_a_rows <= 0; chunk_w_rows <= 0;
     end else begin
-        weight_load_en <= 0;
-        activation_load_en <= 0;
-        compute_start <= 0;
-
-        // AXI read response collection
-        if (m_axi_rvalid && m_axi_rready) begin
-            case (burst_count)
-                0: begin
-                    last_rdata <= m_axi_rdata;
-                    burst_count <= 1;
-                end
-                1: begin
-                    if (reading_a) begin
-                        // axi_rdata_reg_A <= {m_axi_rdata, last_rdata};
-                        activation_buffer <= {m_axi_rdata, last_rdata};
-                        activation_load_en <= 1;
-                    end else if (reading_b) begin
-                        // axi_rdata_reg_B <= {m_axi_rdata, last_rdata};
-                        weight_buffer <= {m_axi_rdata, last_rdata};
-                        weight_load_en <= 1;
-                    end
-                    burst_count <= 0;
-                    load_idx <= load_idx + 1;
-
-                    if (m_axi_rlast) begin
-                        if (reading_a) begin
-                            reading_a <= 0;
-                            reading_b <= 1;
-                            m_axi_araddr <= addr_b;
-                            m_axi_arvalid <= 1;
-                            load_idx <= 0;
-                        end else if (reading_b) begin
-                            reading_b <= 0;
-                            compute_start <= 1;
-                            load_idx <= 0;
+        load_en    <= rd_fire;
+        chunk_push <= rd_fire && rd_chunk_end;
+
+        if (start_pulse) begin
+            rd_tm <= 0; rd_tn <= 0; rd_kc <= 0;
+            rd_w <= 0; rd_row <= 0; rd_beat <= 0;
+        end else if (rd_fire) begin
+            load_w    <= rd_w;
+            load_bank <= rd_bank;
+            load_row  <= rd_row;
+            load_beat <= rd_beat;
+            load_data <= m_axi_gmem_rdata;
+
+            rd_beat <= rd_beat + 1'b1;
+            if (rd_row_end) begin
+                rd_beat <= 0;
+                rd_row  <= rd_row + 1'b1;
+                if (!rd_w && rd_row == rd_a_rows - 1'b1) begin
+                    rd_w   <= 1;
+                    rd_row <= 0;
+                end else if (rd_chunk_end) begin
+                    chunk_bank   <= rd_bank;
+                    chunk_len    <= rd_elems;
+                    chunk_a_rows <= rd_a_rows;
+                    chunk_w_rows <= rd_w_rows;
+                    chunk_first  <= (rd_kc == 0);
+                    chunk_last   <= (rd_kc == tiles_k - 1);
+
+                    rd_w    <= 0;
+                    rd_row  <= 0;
+                    rd_bank <= ~rd_bank;
+                    if (rd_kc != tiles_k - 1) begin
+                        rd_kc <= rd_kc + 1'b1;
+                    end else begin
+                        rd_kc <= 0;
+                        if (rd_tn != tiles_n - 1) begin
+                            rd_tn <= rd_tn + 1'b1;
+                        end else begin
+                            rd_tn <= 0;
+                            rd_tm <= rd_tm + 1'b1;
                         end
                     end
                 end
-            endcase
-        end
-
-        if (start && !reading_a && !reading_b) begin
-            m_axi_araddr <= addr_a;
-            m_axi_arlen <= 1; // Two 128-bit beats (2x128 = 256)
-            m_axi_arsize <= 3'b100;
-            m_axi_arburst <= 2'b01;
-            m_axi_arvalid <= 1;
-            reading_a <= 1;
-        end else if ((reading_a || reading_b) && m_axi_arvalid && m_axi_arready) begin
-            m_axi_arvalid <= 0;
+            end
         end
     end
 end
@@ -189,103 +344,315 @@ end
 // --------------------------------------------------
 // Systolic Core Instance
 // --------------------------------------------------
-wire [SIZE*SIZE*2*DATA_WIDTH-1:0] result_matrix;
+wire               res_ready;
+wire               res_release;
+reg  [SIZE_W-1:0]  w_row;
+reg  [RB_W-1:0]    w_beat;
+wire [127:0]       res_data;
+wire               core_busy;
 
 systolic_array_with_buffers #(
     .SIZE(SIZE),
     .DATA_WIDTH(DATA_WIDTH),
-    .BUFFER_DEPTH(BUFFER_DEPTH)
+    .ACCUM_WIDTH(32),
+    .CHUNK_BEATS(CHUNK_BEATS)
 ) core (
-    .clk(s_axi_aclk),
-    .rst(~s_axi_aresetn),
-    .start(compute_start),
-    .weight_load_en(weight_load_en),
-    .weight_addr(load_idx),
-    .weight_data(weight_buffer),
-    .activation_load_en(activation_load_en),
-    .activation_addr(load_idx),
-    .activation_data(activation_buffer),
-    .matrix_size(matrix_size),
-    .done(done),
-    .result_matrix(result_matrix),
-    .result_valid(result_valid)
+    .clk(ap_clk),
+    .rst(~ap_rst_n),
+    .signed_ops(!unsigned_ops),
+    .load_en(load_en),
+    .load_w(load_w),
+    .load_bank(load_bank),
+    .load_row(load_row),
+    .load_beat(load_beat),
+    .load_data(load_data),
+    .chunk_push(chunk_push),
+    .chunk_bank(chunk_bank),
+    .chunk_len(chunk_len),
+    .chunk_a_rows(chunk_a_rows),
+    .chunk_w_rows(chunk_w_rows),
+    .chunk_first(chunk_first),
+    .chunk_last(chunk_last),
+    .chunk_done(chunk_done),
+    .res_ready(res_ready),
+    .res_release(res_release),
+    .res_row(w_row),
+    .res_beat(w_beat),
+    .res_data(res_data),
+    .busy(core_busy)
 );
 
 // --------------------------------------------------
-// AXI Writeback FSM - For 4-beat burst
+// AXI Writeback - one burst per C row
 // --------------------------------------------------
-reg writing_result;
-reg [1:0] burst_counter;
-reg [511:0] result_buffer;
-
-always @(posedge s_axi_aclk) begin
-    if (!s_axi_aresetn) begin
-        m_axi_awvalid   <= 0;
-        m_axi_awaddr    <= 0;
-        m_axi_awlen     <= 0;
-        m_axi_awsize    <= 0;
-        m_axi_awburst   <= 0;
-
-        m_axi_wvalid    <= 0;
-        m_axi_wdata     <= 0;
-        m_axi_wstrb     <= 0;
-        m_axi_wlast     <= 0;
-
-        m_axi_bready    <= 1;
-
-        writing_result  <= 0;
-        burst_counter   <= 0;
-        result_buffer   <= 0;
+// A finished tile is written row by row; a row's W beats follow its AW.
+// Edge tiles send only the beats holding valid columns, with the lanes past
+// N strobed off. The core drops the tile as its last beat is taken, so the
+// next tile's closing chunk can be fed while the B responses return.
+reg               wr_busy, wr_all;
+reg  [15:0]       wr_tm, wr_tn;
+reg  [SIZE_W-1:0] aw_row, aw_done;
+reg  [15:0]       b_pending;
+
+wire [SIZE_W-1:0] wr_rows = tile_rows(dim_m, wr_tm);
+wire [SIZE_W-1:0] wr_cols = tile_rows(dim_n, wr_tn);
+wire [RB_W-1:0]   wr_row_beats = (wr_cols + 3) / 4;
+wire              aw_fire = m_axi_gmem_awvalid && m_axi_gmem_awready;
+wire              b_fire  = m_axi_gmem_bvalid && m_axi_gmem_bready;
+wire              w_load  = wr_busy && (w_row < aw_done) && (!m_axi_gmem_wvalid || m_axi_gmem_wready);
+wire              w_row_end  = (w_beat == wr_row_beats - 1'b1);
+wire              w_tile_end = w_row_end && (w_row == wr_rows - 1'b1);
+
+assign res_release        = w_load && w_tile_end;
+assign m_axi_gmem_awsize  = 3'b100;
+assign m_axi_gmem_awburst = 2'b01;
+assign m_axi_gmem_bready  = 1'b1;
+
+integer lane;
+
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        m_axi_gmem_awvalid <= 0;
+        m_axi_gmem_awaddr  <= 0;
+        m_axi_gmem_awlen   <= 0;
+        m_axi_gmem_wvalid  <= 0;
+        m_axi_gmem_wdata   <= 0;
+        m_axi_gmem_wstrb   <= 0;
+        m_axi_gmem_wlast   <= 0;
+        wr_busy <= 0; wr_all <= 1;
+        wr_tm <= 0; wr_tn <= 0;
+        aw_row <= 0; aw_done <= 0;
+        w_row <= 0; w_beat <= 0;
+        b_pending <= 0;
     end else begin
-        // Start write burst
-        if (result_valid && !writing_result) begin
-            result_buffer   <= result_matrix;
-            m_axi_awaddr    <= addr_c;
-            m_axi_awlen     <= 3; // 4 beats
-            m_axi_awsize    <= 3'b100;
-            m_axi_awburst   <= 2'b01;
-            m_axi_awvalid   <= 1;
-            burst_counter   <= 0;
-            writing_result  <= 1;
+        if (aw_fire)
+            m_axi_gmem_awvalid <= 0;
+        if (m_axi_gmem_wvalid && m_axi_gmem_wready)
+            m_axi_gmem_wvalid <= 0;
+        b_pending <= b_pending + aw_fire - b_fire;
+
+        if (start_pulse) begin
+            wr_all <= empty_run;
+            wr_tm <= 0; wr_tn <= 0;
+        end else if (!wr_busy && res_ready) begin
+            wr_busy <= 1;
+            aw_row <= 0; aw_done <= 0;
+            w_row <= 0; w_beat <= 0;
         end
 
-        // Once AW is accepted
-        if (m_axi_awvalid && m_axi_awready) begin
-            m_axi_awvalid <= 0;
-        end
+        if (wr_busy) begin
+            if (aw_fire)
+                aw_done <= aw_done + 1'b1;
 
-        // Drive write data when ready
-        if (writing_result && (!m_axi_wvalid || (m_axi_wvalid && m_axi_wready))) begin
-            m_axi_wvalid <= 1;
-            m_axi_wstrb  <= 16'hFFFF;
-            m_axi_wlast  <= (burst_counter == 3);
-
-            case (burst_counter)
-                0: m_axi_wdata <= result_buffer[255:128];
-                1: m_axi_wdata <= result_buffer[383:256];
-                2: m_axi_wdata <= result_buffer[511:384];
-                default:m_axi_wdata <= result_buffer[127:0];
-            endcase
+            if (aw_row < wr_rows && (!m_axi_gmem_awvalid || m_axi_gmem_awready)) begin
+                m_axi_gmem_awvalid <= 1;
+                m_axi_gmem_awlen   <= wr_row_beats - 1'b1;
+                m_axi_gmem_awaddr  <= addr_c_reg + ((wr_tm << LOG_SIZE) + aw_row) * ldc_eff + (wr_tn << LOG_SIZE) * 4;
+                aw_row <= aw_row + 1'b1;
+            end
 
-            if (burst_counter == 3) begin
-                writing_result <= 0;
-            end else begin
-                burst_counter <= burst_counter + 1;
+            if (w_load) begin
+                m_axi_gmem_wvalid <= 1;
+                m_axi_gmem_wdata  <= res_data;
+                m_axi_gmem_wlast  <= w_row_end;
+                for (lane = 0; lane < 4; lane = lane + 1)
+                    m_axi_gmem_wstrb[lane*4 +: 4] <= (w_beat * 4 + lane < wr_cols) ? 4'hF : 4'h0;
+
+                w_beat <= w_beat + 1'b1;
+                if (w_row_end) begin
+                    w_beat <= 0;
+                    w_row  <= w_row + 1'b1;
+                end
+                if (w_tile_end) begin
+                    wr_busy <= 0;
+                    if (wr_tn != tiles_n - 1) begin
+                        wr_tn <= wr_tn + 1'b1;
+                    end else begin
+                        wr_tn <= 0;
+                        if (wr_tm != tiles_m - 1)
+                            wr_tm <= wr_tm + 1'b1;
+                        else
+                            wr_all <= 1;
+                    end
+                end
             end
         end
     end
 end
 
+// --------------------------------------------------
+// Run control, status and counters
+// --------------------------------------------------
+// A run is done once every tile is written and every B response is in.
+wire run_finish = running && !start_pulse && ar_all && wr_all && !wr_busy && !core_busy &&
+                  !m_axi_gmem_awvalid && !m_axi_gmem_wvalid && (b_pending == 0);
+// The last B response is in a cycle before run_finish, so axi_error is final
+wire [INT_SOURCES-1:0] int_events = {run_finish && axi_error, 1'b0, run_finish};
+
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        running <= 0;
+        run_done <= 0;
+        axi_error <= 0;
+        perf_act_beats <= 0;
+        perf_wgt_beats <= 0;
+        perf_out_beats <= 0;
+        perf_busy_cycles <= 0;
+    end else begin
+        if (start_pulse) begin
+            running   <= 1;
+            run_done  <= 0;
+            axi_error <= 0;
+        end else begin
+            if ((rd_fire && m_axi_gmem_rresp != 2'b00) || (b_fire && m_axi_gmem_bresp != 2'b00))
+                axi_error <= 1;
+            if (run_finish) begin
+                running  <= 0;
+                run_done <= 1;
+            end
+        end
+
+        if (rd_fire && !rd_w)
+            perf_act_beats <= perf_act_beats + 1;
+        if (rd_fire && rd_w)
+            perf_wgt_beats <= perf_wgt_beats + 1;
+        if (m_axi_gmem_wvalid && m_axi_gmem_wready)
+            perf_out_beats <= perf_out_beats + 1;
+        if (running)
+            perf_busy_cycles <= perf_busy_cycles + 1;
+    end
+end
 
 // --------------------------------------------------
-// Update Status Register
+// AXI-Lite Read/Write Handling
 // --------------------------------------------------
-always @(posedge s_axi_aclk) begin
-    if (!s_axi_aresetn)
-        slv_reg[REG_STATUS] <= 0;
-    else begin
-        slv_reg[REG_STATUS][0] <= done;
-        slv_reg[REG_STATUS][1] <= result_valid;
+// Registers are written only while no run is in progress (a write otherwise
+// waits), except the interrupt registers, which are taken any time.
+wire [7:0] awaddr_in    = {s_axi_control_awaddr[7:2], 2'b00};
+wire [7:0] awaddr_word  = {awaddr_latched[7:2], 2'b00};
+wire [7:0] araddr_word  = {s_axi_control_araddr[7:2], 2'b00};
+wire       lite_wr_open = !running && !start_pulse;
+wire       lite_wr_any_time = (awaddr_in == INT_GIE) || (awaddr_in == INT_ENABLE) || (awaddr_in == INT_STATUS);
+
+assign s_axi_control_awready = (lite_wr_open || lite_wr_any_time) && !awvalid_seen;
+assign s_axi_control_wready  = (lite_wr_open || awvalid_seen) && !wvalid_seen;
+assign s_axi_control_arready = 1'b1;
+assign s_axi_control_bresp   = 2'b00;
+assign s_axi_control_rresp   = 2'b00;
+
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        s_axi_control_bvalid <= 0;
+        start_pulse  <= 0;
+        awvalid_seen <= 0;
+        wvalid_seen  <= 0;
+        awaddr_latched <= 0;
+        wdata_latched  <= 0;
+        wstrb_latched  <= 0;
+        addr_a_reg <= 64'd0;
+        addr_b_reg <= 64'd0;
+        addr_c_reg <= 64'd0;
+        lda_reg <= 32'd0;
+        ldb_reg <= 32'd0;
+        ldc_reg <= 32'd0;
+        dim_m <= 16'd0;
+        dim_n <= 16'd0;
+        dim_k <= 16'd0;
+        unsigned_ops <= 0;
+        int_gie <= 0;
+        int_enable <= {INT_SOURCES{1'b0}};
+        int_status <= {INT_SOURCES{1'b0}};
+        interrupt <= 0;
+    end else begin
+        start_pulse <= 0;
+
+        // A source firing in the cycle its bit is cleared stays set
+        if (awvalid_seen && wvalid_seen && awaddr_word == INT_STATUS && wstrb_latched[0])
+            int_status <= (int_status & ~wdata_latched[INT_SOURCES-1:0]) | int_events;
+        else
+            int_status <= int_status | int_events;
+        interrupt <= int_gie && |(int_status & int_enable);
+
+        if (s_axi_control_bvalid && s_axi_control_bready)
+            s_axi_control_bvalid <= 0;
+
+        if (s_axi_control_awvalid && s_axi_control_awready) begin
+            awaddr_latched <= s_axi_control_awaddr;
+            awvalid_seen   <= 1;
+        end
+
+        if (s_axi_control_wvalid && s_axi_control_wready) begin
+            wdata_latched <= s_axi_control_wdata;
+            wstrb_latched <= s_axi_control_wstrb;
+            wvalid_seen   <= 1;
+        end
+
+        if (awvalid_seen && wvalid_seen && !s_axi_control_bvalid) begin
+            awvalid_seen <= 0;
+            wvalid_seen  <= 0;
+            s_axi_control_bvalid <= 1;
+
+            if (awaddr_word == ADDR_CTRL && wstrb_latched[0]) begin
+                unsigned_ops <= wdata_latched[3];
+                if (wdata_latched[0])
+                    start_pulse <= 1;
+            end
+
+            case (awaddr_word)
+                A_LSB:      addr_a_reg[31:0]  <= merge_by_wstrb(addr_a_reg[31:0],  wdata_latched, wstrb_latched);
+                A_MSB:      addr_a_reg[63:32] <= merge_by_wstrb(addr_a_reg[63:32], wdata_latched, wstrb_latched);
+                B_LSB:      addr_b_reg[31:0]  <= merge_by_wstrb(addr_b_reg[31:0],  wdata_latched, wstrb_latched);
+                B_MSB:      addr_b_reg[63:32] <= merge_by_wstrb(addr_b_reg[63:32], wdata_latched, wstrb_latched);
+                C_LSB:      addr_c_reg[31:0]  <= merge_by_wstrb(addr_c_reg[31:0],  wdata_latched, wstrb_latched);
+                C_MSB:      addr_c_reg[63:32] <= merge_by_wstrb(addr_c_reg[63:32], wdata_latched, wstrb_latched);
+                LDA:        lda_reg <= merge_by_wstrb(lda_reg, wdata_latched, wstrb_latched);
+                LDB:        ldb_reg <= merge_by_wstrb(ldb_reg, wdata_latched, wstrb_latched);
+                LDC:        ldc_reg <= merge_by_wstrb(ldc_reg, wdata_latched, wstrb_latched);
+                DIM_M:      dim_m <= merge_by_wstrb({16'd0, dim_m}, wdata_latched, wstrb_latched);
+                DIM_N:      dim_n <= merge_by_wstrb({16'd0, dim_n}, wdata_latched, wstrb_latched);
+                DIM_K:      dim_k <= merge_by_wstrb({16'd0, dim_k}, wdata_latched, wstrb_latched);
+                INT_GIE:    if (wstrb_latched[0]) int_gie <= wdata_latched[0];
+                INT_ENABLE: if (wstrb_latched[0]) int_enable <= wdata_latched[INT_SOURCES-1:0];
+                default: ;
+            endcase
+        end
+    end
+end
+
+always @(posedge ap_clk) begin
+    if (!ap_rst_n) begin
+        s_axi_control_rvalid <= 0;
+        s_axi_control_rdata  <= 32'd0;
+    end else begin
+        if (s_axi_control_rvalid && s_axi_control_rready) begin
+            s_axi_control_rvalid <= 0;
+        end else if (s_axi_control_arvalid && s_axi_control_arready) begin
+            s_axi_control_rvalid <= 1;
+            case (araddr_word)
+                ADDR_STATUS:      s_axi_control_rdata <= {28'd0, unsigned_ops, axi_error, running, run_done};
+                INT_GIE:          s_axi_control_rdata <= {31'd0, int_gie};
+                INT_ENABLE:       s_axi_control_rdata <= {{(32-INT_SOURCES){1'b0}}, int_enable};
+                INT_STATUS:       s_axi_control_rdata <= {{(32-INT_SOURCES){1'b0}}, int_status};
+                A_LSB:            s_axi_control_rdata <= addr_a_reg[31:0];
+                A_MSB:            s_axi_control_rdata <= addr_a_reg[63:32];
+                B_LSB:            s_axi_control_rdata <= addr_b_reg[31:0];
+                B_MSB:            s_axi_control_rdata <= addr_b_reg[63:32];
+                C_LSB:            s_axi_control_rdata <= addr_c_reg[31:0];
+                C_MSB:            s_axi_control_rdata <= addr_c_reg[63:32];
+                LDA:              s_axi_control_rdata <= lda_reg;
+                LDB:              s_axi_control_rdata <= ldb_reg;
+                LDC:              s_axi_control_rdata <= ldc_reg;
+                PERF_ACT_BEATS:   s_axi_control_rdata <= perf_act_beats;
+                PERF_WGT_BEATS:   s_axi_control_rdata <= perf_wgt_beats;
+                PERF_OUT_BEATS:   s_axi_control_rdata <= perf_out_beats;
+                ACC_ID:           s_axi_control_rdata <= ACC_ID_VALUE;
+                DIM_M:            s_axi_control_rdata <= {16'd0, dim_m};
+                DIM_N:            s_axi_control_rdata <= {16'd0, dim_n};
+                DIM_K:            s_axi_control_rdata <= {16'd0, dim_k};
+                PERF_BUSY_CYCLES: s_axi_control_rdata <= perf_busy_cycles;
+                default:          s_axi_control_rdata <= 32'hDEADBEEF;
+            endcase
+        end
     end
 end
 
@@ -1,48 +1,202 @@
+// Compute side of the INT4 GEMM engine: two operand chunk banks, the skewed
+// feed, the PE grid and the finished C tile.
+//
+// A chunk is up to CHUNK_BEATS 128-bit beats (32 INT4 each) of K for every
+// A row and every W row of one C tile, W being B stored N x K. The read
+// engine fills one bank while the other is fed, then pushes it with its K
+// length, its valid A and W row counts and whether it opens or closes its
+// C tile. The PEs keep summing across the chunks of a tile, so the whole K
+// is accumulated on chip.
+//
+// A closing chunk is not fed while the previous tile still waits to be
+// written, since its last element would overwrite the PE results. res_ready
+// rises once the last element has reached the far corner; the write engine
+// reads the tile through res_row/res_beat and drops it with res_release.
 module systolic_array_with_buffers #(
-    parameter SIZE = 4,
+    parameter SIZE = 8,                    // Multiple of 4
     parameter DATA_WIDTH = 4,              // INT4 data
-    parameter BUFFER_DEPTH = 64
+    parameter ACCUM_WIDTH = 32,            // Result lanes are packed four to a beat
+    parameter CHUNK_BEATS = 4
 )(
     input clk,
     input rst,
-    input start,
-
-    // Weight buffer interface
-    input weight_load_en,
-    input [$clog2(BUFFER_DEPTH)-1:0] weight_addr,
-    input [DATA_WIDTH*64-1:0] weight_data, // 256 bits = 64 x INT4
-
-    // Activation buffer interface
-    input activation_load_en,
-    input [$clog2(BUFFER_DEPTH)-1:0] activation_addr,
-    input [DATA_WIDTH*64-1:0] activation_data,
+    input signed_ops,                      // 1: operands are -8..7, 0: 0..15
+
+    // Operand beats: beat load_beat of row load_row of A (load_w = 0) or W
+    input load_en,
+    input load_w,
+    input load_bank,
+    input [$clog2(SIZE+1)-1:0] load_row,
+    input [$clog2(CHUNK_BEATS+1)-1:0] load_beat,
+    input [127:0] load_data,
+
+    // Chunk handshake
+    input chunk_push,                      // Bank chunk_bank is filled
+    input chunk_bank,
+    input [$clog2(CHUNK_BEATS*128/DATA_WIDTH+1)-1:0] chunk_len,  // K elements in the chunk, at least 1
+    input [$clog2(SIZE+1)-1:0] chunk_a_rows,
+    input [$clog2(SIZE+1)-1:0] chunk_w_rows,
+    input chunk_first,
+    input chunk_last,
+    output reg [1:0] chunk_done,           // Pulse per bank: fed, free to refill
+
+    // Finished C tile: beat res_beat of row res_row is columns 4*res_beat..+3
+    output reg res_ready,
+    input res_release,
+    input [$clog2(SIZE+1)-1:0] res_row,
+    input [$clog2(SIZE/4+1)-1:0] res_beat,
+    output [127:0] res_data,
+
+    output busy
+);
 
-    // Matrix dimensions
-    input [$clog2(SIZE+1)-1:0] matrix_size,
+    localparam integer OPW         = DATA_WIDTH + 1;
+    localparam integer BEAT_ELEMS  = 128 / DATA_WIDTH;
+    localparam integer SIZE_W      = $clog2(SIZE + 1);
+    localparam integer K_W         = $clog2(CHUNK_BEATS * BEAT_ELEMS + 1);
+    localparam integer BANK_WORDS  = SIZE * CHUNK_BEATS;
+    localparam integer DRAIN_W     = $clog2(2 * SIZE + 2);
+
+    // Banks: word (bank * SIZE + row) * CHUNK_BEATS + beat
+    reg [127:0] a_bank [0:2*BANK_WORDS-1];
+    reg [127:0] w_bank [0:2*BANK_WORDS-1];
+
+    reg [1:0]        bank_full;
+    reg [K_W-1:0]    bank_len    [0:1];
+    reg [SIZE_W-1:0] bank_a_rows [0:1];
+    reg [SIZE_W-1:0] bank_w_rows [0:1];
+    reg [1:0]        bank_first, bank_last;
+
+    reg              feeding;
+    reg              feed_bank;
+    reg [K_W-1:0]    feed_k;
+    reg [DRAIN_W-1:0] drain_cnt;
+
+    wire feed_end   = feeding && (feed_k == bank_len[feed_bank] - 1'b1);
+    wire feed_start = !feeding && bank_full[feed_bank] &&
+                      (!bank_last[feed_bank] || (!res_ready && drain_cnt == 0));
+
+    assign busy = feeding || (bank_full != 2'b00) || (drain_cnt != 0) || res_ready;
+
+    // Skew lines: entry [i][0] is the edge register, lane i enters the grid
+    // from entry [i][i]. Flags ride with the A lanes.
+    reg [OPW-1:0] a_skew [0:SIZE-1][0:SIZE-1];
+    reg [OPW-1:0] w_skew [0:SIZE-1][0:SIZE-1];
+    reg [2:0]     f_skew [0:SIZE-1][0:SIZE-1];   // {last, first, valid}
+
+    wire [OPW-1:0]         north_data [0:SIZE-1][0:SIZE-1];
+    wire [OPW-1:0]         west_data  [0:SIZE-1][0:SIZE-1];
+    wire [2:0]             west_flags [0:SIZE-1][0:SIZE-1];
+    wire [OPW-1:0]         south_data [0:SIZE-1][0:SIZE-1];
+    wire [OPW-1:0]         east_data  [0:SIZE-1][0:SIZE-1];
+    wire [2:0]             east_flags [0:SIZE-1][0:SIZE-1];
+    wire [ACCUM_WIDTH-1:0] pe_results [0:SIZE-1][0:SIZE-1];
+
+    integer i, d;
+
+    // ----------------- Operand banks -----------------
+    always @(posedge clk) begin
+        if (load_en) begin
+            if (load_w)
+                w_bank[(load_bank * SIZE + load_row) * CHUNK_BEATS + load_beat] <= load_data;
+            else
+                a_bank[(load_bank * SIZE + load_row) * CHUNK_BEATS + load_beat] <= load_data;
+        end
+    end
 
-    // Output interface
-    output reg done,
-    output reg [SIZE*SIZE*2*DATA_WIDTH-1:0] result_matrix,
-    output reg result_valid
-);
+    // ----------------- Chunk sequencing -----------------
+    always @(posedge clk or posedge rst) begin
+        if (rst) begin
+            bank_full  <= 2'b00;
+            bank_first <= 2'b00;
+            bank_last  <= 2'b00;
+            chunk_done <= 2'b00;
+            feeding    <= 0;
+            feed_bank  <= 0;
+            feed_k     <= 0;
+            drain_cnt  <= 0;
+            res_ready  <= 0;
+            for (i = 0; i < 2; i = i + 1) begin
+                bank_len[i]    <= 0;
+                bank_a_rows[i] <= 0;
+                bank_w_rows[i] <= 0;
+            end
+        end else begin
+            chunk_done <= 2'b00;
+
+            // The read engine only pushes a bank that is not being fed
+            if (chunk_push) begin
+                bank_full[chunk_bank]   <= 1'b1;
+                bank_len[chunk_bank]    <= chunk_len;
+                bank_a_rows[chunk_bank] <= chunk_a_rows;
+                bank_w_rows[chunk_bank] <= chunk_w_rows;
+                bank_first[chunk_bank]  <= chunk_first;
+                bank_last[chunk_bank]   <= chunk_last;
+            end
 
-    // Systolic array interconnections
-    wire [DATA_WIDTH-1:0] north_data [0:SIZE-1][0:SIZE-1];
-    wire [DATA_WIDTH-1:0] west_data  [0:SIZE-1][0:SIZE-1];
-    wire [DATA_WIDTH-1:0] south_data [0:SIZE-1][0:SIZE-1];
-    wire [DATA_WIDTH-1:0] east_data  [0:SIZE-1][0:SIZE-1];
-    wire [2*DATA_WIDTH-1:0] pe_results [0:SIZE-1][0:SIZE-1];
+            if (feed_start) begin
+                feeding <= 1;
+                feed_k  <= 0;
+            end else if (feeding) begin
+                feed_k <= feed_k + 1'b1;
+                if (feed_end) begin
+                    feeding               <= 0;
+                    bank_full[feed_bank]  <= 1'b0;
+                    chunk_done[feed_bank] <= 1'b1;
+                    feed_bank             <= ~feed_bank;
+                end
+            end
 
-    // Input staging registers
-    reg [DATA_WIDTH-1:0] north_inputs [0:SIZE-1];
-    reg [DATA_WIDTH-1:0] west_inputs [0:SIZE-1];
+            // The last element reaches PE (SIZE-1, SIZE-1) 2 * SIZE cycles
+            // after it is fed; its result is registered one cycle later
+            if (feed_end && bank_last[feed_bank])
+                drain_cnt <= 2 * SIZE + 1;
+            else if (drain_cnt != 0)
+                drain_cnt <= drain_cnt - 1'b1;
+
+            if (drain_cnt == 1)
+                res_ready <= 1;
+            else if (res_release)
+                res_ready <= 0;
+        end
+    end
 
-    reg computing;
-    reg [$clog2(3*SIZE+1)-1:0] cycle_count;
-    reg [$clog2(SIZE+1)-1:0] current_size;
-    reg capture_results;  // Added flag to delay result capture
+    // ----------------- Skewed feed -----------------
+    // Element k of row i sits in beat k / 32 of that row, lane k % 32.
+    // Rows past the tile edge feed zeros; the flags still flow so every PE
+    // opens and closes the tile.
+    reg [127:0]          a_word, w_word;
+    reg [DATA_WIDTH-1:0] a_nib, w_nib;
 
-    integer i, j;
+    always @(posedge clk or posedge rst) begin
+        if (rst) begin
+            for (i = 0; i < SIZE; i = i + 1)
+                for (d = 0; d < SIZE; d = d + 1) begin
+                    a_skew[i][d] <= 0;
+                    w_skew[i][d] <= 0;
+                    f_skew[i][d] <= 0;
+                end
+        end else begin
+            for (i = 0; i < SIZE; i = i + 1) begin
+                a_word = a_bank[(feed_bank * SIZE + i) * CHUNK_BEATS + feed_k / BEAT_ELEMS];
+                w_word = w_bank[(feed_bank * SIZE + i) * CHUNK_BEATS + feed_k / BEAT_ELEMS];
+                a_nib  = a_word[(feed_k % BEAT_ELEMS) * DATA_WIDTH +: DATA_WIDTH];
+                w_nib  = w_word[(feed_k % BEAT_ELEMS) * DATA_WIDTH +: DATA_WIDTH];
+
+                a_skew[i][0] <= (feeding && i < bank_a_rows[feed_bank]) ? {signed_ops & a_nib[DATA_WIDTH-1], a_nib} : {OPW{1'b0}};
+                w_skew[i][0] <= (feeding && i < bank_w_rows[feed_bank]) ? {signed_ops & w_nib[DATA_WIDTH-1], w_nib} : {OPW{1'b0}};
+                f_skew[i][0] <= {feed_end && bank_last[feed_bank],
+                                 feeding && feed_k == 0 && bank_first[feed_bank],
+                                 feeding};
+
+                for (d = 1; d < SIZE; d = d + 1) begin
+                    a_skew[i][d] <= a_skew[i][d-1];
+                    w_skew[i][d] <= w_skew[i][d-1];
+                    f_skew[i][d] <= f_skew[i][d-1];
+                end
+            end
+        end
+    end
 
     // ----------------- PE Array -----------------
     genvar row, col;
@@ -50,15 +204,22 @@ module systolic_array_with_buffers #(
         for (row = 0; row < SIZE; row = row + 1) begin : row_gen
             for (col = 0; col < SIZE; col = col + 1) begin : col_gen
                 // Connect inputs
-                assign north_data[row][col] = (row == 0) ? north_inputs[col] : south_data[row-1][col];
-                assign west_data[row][col]  = (col == 0) ? west_inputs[row]  : east_data[row][col-1];
+                assign north_data[row][col] = (row == 0) ? w_skew[col][col] : south_data[row-1][col];
+                assign west_data[row][col]  = (col == 0) ? a_skew[row][row] : east_data[row][col-1];
+                assign west_flags[row][col] = (col == 0) ? f_skew[row][row] : east_flags[row][col-1];
 
                 // PE instance
-                pe #(.DATA_WIDTH(DATA_WIDTH)) pe_inst (
+                pe #(.DATA_WIDTH(OPW), .ACCUM_WIDTH(ACCUM_WIDTH)) pe_inst (
                     .clk(clk),
                     .rst(rst),
+                    .inp_valid(west_flags[row][col][0]),
+                    .inp_first(west_flags[row][col][1]),
+                    .inp_last(west_flags[row][col][2]),
                     .inp_north(north_data[row][col]),
                     .inp_west(west_data[row][col]),
+                    .outp_valid(east_flags[row][col][0]),
+                    .outp_first(east_flags[row][col][1]),
+                    .outp_last(east_flags[row][col][2]),
                     .outp_south(south_data[row][col]),
                     .outp_east(east_data[row][col]),
                     .result(pe_results[row][col])
@@ -67,69 +228,8 @@ module systolic_array_with_buffers #(
         end
     endgenerate
 
-    // ----------------- Control FSM -----------------
-    always @(posedge clk or posedge rst) begin
-        if (rst) begin
-            computing     <= 0;
-            cycle_count   <= 0;
-            result_matrix <= 0;
-            done          <= 0;
-            result_valid  <= 0;
-            capture_results <= 0;
-        end else begin
-            if (start && !computing && !done) begin
-                computing   <= 1;
-                cycle_count <= 0;
-                done        <= 0;
-                result_valid <= 0;
-                capture_results <= 0;
-
-                // Clear input registers
-                for (i = 0; i < SIZE; i = i + 1) begin
-                    north_inputs[i] <= 0;
-                    west_inputs[i]  <= 0;
-                end
-
-                current_size <= matrix_size;
-
-            end else if (computing) begin
-                cycle_count <= cycle_count + 1;
-
-                // Assign inputs to top row and left column
-                for (i = 0; i < SIZE; i = i + 1) begin
-                    if (cycle_count >= i && (cycle_count - i) < current_size) begin
-                        // Extract weight and activation from packed data
-                        north_inputs[i] <= weight_data[DATA_WIDTH * ((cycle_count - i) * SIZE + i) +: DATA_WIDTH];
-                        west_inputs[i]  <= activation_data[DATA_WIDTH * (i * SIZE + (cycle_count - i)) +: DATA_WIDTH];
-                    end else begin
-                        north_inputs[i] <= 0;
-                        west_inputs[i]  <= 0;
-                    end
-                end
-
-                // Check if all data passed through
-                if (cycle_count >= (2 * current_size + SIZE - 2)) begin
-                    computing <= 0;
-                    capture_results <= 1;  // Set flag to capture results next cycle
-                end
-                
-            end else if (capture_results) begin
-                // Capture results one cycle after computing ends
-                capture_results <= 0;
-                done <= 1;
-                result_valid <= 1;
-
-                // Store all PE results - now captured at the right time
-                for (i = 0; i < SIZE; i = i + 1) begin
-                    for (j = 0; j < SIZE; j = j + 1) begin
-                        result_matrix[(i*SIZE + j)*2*DATA_WIDTH +: 2*DATA_WIDTH] <= pe_results[i][j];
-                    end
-                end
-                
-            end else if (done && start) begin
-                done <= 0;
-            end
-        end
-    end
+    // ----------------- Result beats -----------------
+    assign res_data = {pe_results[res_row][4*res_beat+3], pe_results[res_row][4*res_beat+2],
+                       pe_results[res_row][4*res_beat+1], pe_results[res_row][4*res_beat]};
 
-endmodule
\ No newline at end of file
+endmodule
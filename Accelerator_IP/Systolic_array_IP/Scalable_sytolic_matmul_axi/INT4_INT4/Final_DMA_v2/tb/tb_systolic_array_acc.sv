@@ -1,113 +1,131 @@
 `timescale 1ns / 1ps
 
+// INT4 GEMM engine against axi_memory_model: a single tile (the original
+// SIZE x SIZE x SIZE check, now with full 32-bit results), ragged shapes
+// with pitches that leave every tile edge partial, several K chunks per
+// tile, and a decode-shaped GEMV. Each run checks C, the untouched bytes
+// around C, and the AXI beat counters against the tile walk.
 module tb_systolic_array_acc;
 
 parameter SIZE = 8;
 parameter DATA_WIDTH = 4;
-parameter ADDR_WIDTH = 64;
-parameter BUFFER_DEPTH = 128;
-parameter BASE_ADDR_A = 64;
-parameter BASE_ADDR_B = 128;
-parameter BASE_ADDR_C = 192;
+parameter CHUNK_BEATS = 4;
+parameter MEM_WORDS = 65536;                 // 1 MB
+parameter longint BASE_ADDR_A = 'h00000;
+parameter longint BASE_ADDR_B = 'h40000;
+parameter longint BASE_ADDR_C = 'h80000;
+
+localparam int CHUNK_K     = CHUNK_BEATS * 32;
+localparam int CHUNK_BYTES = CHUNK_BEATS * 16;
+
+// Register map (gemma_accelerator offsets)
+localparam [7:0] REG_CTRL = 8'h00, REG_INT_GIE = 8'h04, REG_INT_ENABLE = 8'h08, REG_INT_STATUS = 8'h0C,
+                 REG_A_LSB = 8'h10, REG_A_MSB = 8'h14, REG_B_LSB = 8'h1C, REG_B_MSB = 8'h20,
+                 REG_C_LSB = 8'h28, REG_C_MSB = 8'h2C, REG_LDA = 8'h54, REG_LDB = 8'h58, REG_LDC = 8'h5C,
+                 REG_PERF_ACT = 8'h64, REG_PERF_WGT = 8'h68, REG_PERF_OUT = 8'h6C, REG_ACC_ID = 8'h80,
+                 REG_DIM_M = 8'hA0, REG_DIM_N = 8'hA4, REG_DIM_K = 8'hA8, REG_PERF_BUSY = 8'hAC;
+localparam [31:0] CTRL_START = 32'h1, CTRL_UNSIGNED = 32'h8;
+localparam [31:0] SENTINEL = 32'hDEADBEEF;
 
 logic clk = 0;
 logic rstn = 0;
 always #5 clk = ~clk;
 
 // DUT <-> Memory interface
-logic m_axi_arvalid, m_axi_arready;
-logic [ADDR_WIDTH-1:0] m_axi_araddr;
-logic [7:0] m_axi_arlen;
-logic [2:0] m_axi_arsize;
-logic [1:0] m_axi_arburst;
-logic m_axi_rvalid, m_axi_rready, m_axi_rlast;
+logic         m_axi_arvalid, m_axi_arready;
+logic [63:0]  m_axi_araddr;
+logic [7:0]   m_axi_arlen;
+logic [2:0]   m_axi_arsize;
+logic [1:0]   m_axi_arburst;
+logic         m_axi_rvalid, m_axi_rready, m_axi_rlast;
 logic [127:0] m_axi_rdata;
+logic [1:0]   m_axi_rresp;
 
-logic m_axi_awvalid, m_axi_awready;
-logic [ADDR_WIDTH-1:0] m_axi_awaddr;
-logic [7:0] m_axi_awlen;
-logic [2:0] m_axi_awsize;
-logic [1:0] m_axi_awburst;
+logic         m_axi_awvalid, m_axi_awready;
+logic [63:0]  m_axi_awaddr;
+logic [7:0]   m_axi_awlen;
+logic [2:0]   m_axi_awsize;
+logic [1:0]   m_axi_awburst;
 
-logic m_axi_wvalid, m_axi_wready, m_axi_wlast;
+logic         m_axi_wvalid, m_axi_wready, m_axi_wlast;
 logic [127:0] m_axi_wdata;
-logic [15:0] m_axi_wstrb;
-logic m_axi_bvalid, m_axi_bready;
+logic [15:0]  m_axi_wstrb;
+logic         m_axi_bvalid, m_axi_bready;
+logic [1:0]   m_axi_bresp;
 
 // AXI-Lite interface
-logic [63:0] s_axi_awaddr, s_axi_araddr;
-logic        s_axi_awvalid, s_axi_wvalid, s_axi_arvalid;
+logic [7:0]  s_axi_awaddr = 0, s_axi_araddr = 0;
+logic        s_axi_awvalid = 0, s_axi_wvalid = 0, s_axi_arvalid = 0;
 logic        s_axi_awready, s_axi_wready, s_axi_arready;
-logic [127:0] s_axi_wdata, s_axi_rdata;
-logic s_axi_bready = 1, s_axi_bvalid, s_axi_rvalid;
-logic [1:0] s_axi_bresp, s_axi_rresp;
-logic s_axi_rready = 1;
-
-// Matrices
-logic [DATA_WIDTH-1:0] mat_a [0:SIZE*SIZE-1];
-logic [DATA_WIDTH-1:0] mat_b [0:SIZE*SIZE-1];
-logic [2*DATA_WIDTH-1:0] golden [0:SIZE*SIZE-1];
-logic [2*DATA_WIDTH-1:0] result [0:SIZE*SIZE-1];
+logic [31:0] s_axi_wdata = 0, s_axi_rdata;
+logic [3:0]  s_axi_wstrb = 4'hF;
+logic        s_axi_bready = 1, s_axi_bvalid, s_axi_rvalid;
+logic [1:0]  s_axi_bresp, s_axi_rresp;
+logic        s_axi_rready = 1;
+logic        interrupt;
 
 // --------------------- DUT -----------------------
 systolic_array_axi_stream #(
     .SIZE(SIZE),
     .DATA_WIDTH(DATA_WIDTH),
-    .ADDR_WIDTH(6),
-    .BUFFER_DEPTH(BUFFER_DEPTH)
+    .CHUNK_BEATS(CHUNK_BEATS)
 ) dut (
-    .s_axi_aclk(clk),
-    .s_axi_aresetn(rstn),
+    .ap_clk(clk),
+    .ap_rst_n(rstn),
+    .interrupt(interrupt),
 
     // AXI-Lite
-    .s_axi_awaddr(s_axi_awaddr),
-    .s_axi_awvalid(s_axi_awvalid),
-    .s_axi_awready(s_axi_awready),
-    .s_axi_wdata(s_axi_wdata),
-    .s_axi_wvalid(s_axi_wvalid),
-    .s_axi_wready(s_axi_wready),
-    .s_axi_bready(s_axi_bready),
-    .s_axi_bvalid(s_axi_bvalid),
-    .s_axi_bresp(s_axi_bresp),
-    .s_axi_araddr(s_axi_araddr),
-    .s_axi_arvalid(s_axi_arvalid),
-    .s_axi_arready(s_axi_arready),
-    .s_axi_rdata(s_axi_rdata),
-    .s_axi_rvalid(s_axi_rvalid),
-    .s_axi_rresp(s_axi_rresp),
-    .s_axi_rready(s_axi_rready),
+    .s_axi_control_awvalid(s_axi_awvalid),
+    .s_axi_control_awready(s_axi_awready),
+    .s_axi_control_awaddr(s_axi_awaddr),
+    .s_axi_control_wvalid(s_axi_wvalid),
+    .s_axi_control_wready(s_axi_wready),
+    .s_axi_control_wdata(s_axi_wdata),
+    .s_axi_control_wstrb(s_axi_wstrb),
+    .s_axi_control_bvalid(s_axi_bvalid),
+    .s_axi_control_bready(s_axi_bready),
+    .s_axi_control_bresp(s_axi_bresp),
+    .s_axi_control_arvalid(s_axi_arvalid),
+    .s_axi_control_arready(s_axi_arready),
+    .s_axi_control_araddr(s_axi_araddr),
+    .s_axi_control_rvalid(s_axi_rvalid),
+    .s_axi_control_rready(s_axi_rready),
+    .s_axi_control_rdata(s_axi_rdata),
+    .s_axi_control_rresp(s_axi_rresp),
 
     // AXI Master
-    .m_axi_arvalid(m_axi_arvalid),
-    .m_axi_arready(m_axi_arready),
-    .m_axi_araddr(m_axi_araddr),
-    .m_axi_arlen(m_axi_arlen),
-    .m_axi_arsize(m_axi_arsize),
-    .m_axi_arburst(m_axi_arburst),
-    .m_axi_rvalid(m_axi_rvalid),
-    .m_axi_rdata(m_axi_rdata),
-    .m_axi_rlast(m_axi_rlast),
-    .m_axi_rready(m_axi_rready),
-    .m_axi_awvalid(m_axi_awvalid),
-    .m_axi_awready(m_axi_awready),
-    .m_axi_awaddr(m_axi_awaddr),
-    .m_axi_awlen(m_axi_awlen),
-    .m_axi_awsize(m_axi_awsize),
-    .m_axi_awburst(m_axi_awburst),
-    .m_axi_wvalid(m_axi_wvalid),
-    .m_axi_wready(m_axi_wready),
-    .m_axi_wdata(m_axi_wdata),
-    .m_axi_wstrb(m_axi_wstrb),
-    .m_axi_wlast(m_axi_wlast),
-    .m_axi_bvalid(m_axi_bvalid),
-    .m_axi_bready(m_axi_bready)
+    .m_axi_gmem_arvalid(m_axi_arvalid),
+    .m_axi_gmem_arready(m_axi_arready),
+    .m_axi_gmem_araddr(m_axi_araddr),
+    .m_axi_gmem_arlen(m_axi_arlen),
+    .m_axi_gmem_arsize(m_axi_arsize),
+    .m_axi_gmem_arburst(m_axi_arburst),
+    .m_axi_gmem_rvalid(m_axi_rvalid),
+    .m_axi_gmem_rdata(m_axi_rdata),
+    .m_axi_gmem_rlast(m_axi_rlast),
+    .m_axi_gmem_rresp(m_axi_rresp),
+    .m_axi_gmem_rready(m_axi_rready),
+    .m_axi_gmem_awvalid(m_axi_awvalid),
+    .m_axi_gmem_awready(m_axi_awready),
+    .m_axi_gmem_awaddr(m_axi_awaddr),
+    .m_axi_gmem_awlen(m_axi_awlen),
+    .m_axi_gmem_awsize(m_axi_awsize),
+    .m_axi_gmem_awburst(m_axi_awburst),
+    .m_axi_gmem_wvalid(m_axi_wvalid),
+    .m_axi_gmem_wready(m_axi_wready),
+    .m_axi_gmem_wdata(m_axi_wdata),
+    .m_axi_gmem_wstrb(m_axi_wstrb),
+    .m_axi_gmem_wlast(m_axi_wlast),
+    .m_axi_gmem_bvalid(m_axi_bvalid),
+    .m_axi_gmem_bresp(m_axi_bresp),
+    .m_axi_gmem_bready(m_axi_bready)
 );
 
 // ------------------ Memory Model -------------------
 axi_memory_model #(
-    .ADDR_WIDTH(ADDR_WIDTH),
+    .ADDR_WIDTH(64),
     .DATA_WIDTH(128),
-    .DEPTH(20)
+    .DEPTH(MEM_WORDS)
 ) mem (
     .clk(clk),
     .rstn(rstn),
@@ -121,6 +139,7 @@ axi_memory_model #(
     .rvalid(m_axi_rvalid),
     .rdata(m_axi_rdata),
     .rlast(m_axi_rlast),
+    .rresp(m_axi_rresp),
     .rready(m_axi_rready),
 
     .awvalid(m_axi_awvalid),
@@ -135,144 +154,215 @@ axi_memory_model #(
     .wlast(m_axi_wlast),
     .wready(m_axi_wready),
     .bvalid(m_axi_bvalid),
+    .bresp(m_axi_bresp),
     .bready(m_axi_bready)
 );
 
 // ----------- Helper Tasks --------------
 
-task automatic axi_write(input [5:0] addr, input [31:0] data);
+task automatic axi_write(input [7:0] addr, input [31:0] data);
     @(posedge clk);
-    s_axi_awaddr <= addr << 2;
-    s_axi_wdata <= {96'd0, data};
+    s_axi_awaddr  <= addr;
+    s_axi_wdata   <= data;
     s_axi_awvalid <= 1;
-    s_axi_wvalid <= 1;
-    wait (s_axi_awready && s_axi_wready);
+    s_axi_wvalid  <= 1;
+    fork
+        begin do @(posedge clk); while (!s_axi_awready); s_axi_awvalid <= 0; end
+        begin do @(posedge clk); while (!s_axi_wready);  s_axi_wvalid  <= 0; end
+    join
+    do @(posedge clk); while (!s_axi_bvalid);
+endtask
+
+task automatic axi_read(input [7:0] addr, output [31:0] data);
     @(posedge clk);
-    s_axi_awvalid <= 0;
-    s_axi_wvalid <= 0;
+    s_axi_araddr  <= addr;
+    s_axi_arvalid <= 1;
+    do @(posedge clk); while (!s_axi_arready);
+    s_axi_arvalid <= 0;
+    do @(posedge clk); while (!s_axi_rvalid);
+    data = s_axi_rdata;
 endtask
 
-function logic [127:0] pack_4bit_32(input logic [3:0] src [32]);
-    logic [127:0] out;
-    for (int i = 0; i < 32; i++)
-        out[i*4 +: 4] = src[i];
-    return out;
+function automatic void poke8(input longint addr, input [7:0] v);
+    mem.mem[addr >> 4][(addr & 15) * 8 +: 8] = v;
+endfunction
+
+function automatic [31:0] peek32(input longint addr);
+    return mem.mem[addr >> 4][(addr & 15) * 8 +: 32];
 endfunction
 
-task automatic compare_results;
-    int mismatches = 0;
-    for (int i = 0; i < SIZE*SIZE; i++) begin
-        int word_idx = (BASE_ADDR_C >> 4) + i / 16;
-        int bit_offset = (i % 16) * 8;
-        result[i] = mem.mem[word_idx][bit_offset +: 8];
-        if (result[i] !== golden[i]) begin
-            $display("Result[%0d] = %0d (expected %0d)", i, result[i], golden[i]);
-            mismatches++;
-        end else begin
-            $display("Result[%0d] = %0d", i, result[i]);
+function automatic void poke32(input longint addr, input [31:0] v);
+    mem.mem[addr >> 4][(addr & 15) * 8 +: 32] = v;
+endfunction
+
+// Element (r, k) of a packed INT4 matrix: byte r * ld + k / 2, low nibble first
+function automatic void poke_int4(input longint base, input int ld, input int r, input int k, input int v);
+    longint addr = base + longint'(r) * ld + k / 2;
+    logic [7:0] b = mem.mem[addr >> 4][(addr & 15) * 8 +: 8];
+    if (k % 2 == 0) b[3:0] = v[3:0];
+    else            b[7:4] = v[3:0];
+    poke8(addr, b);
+endfunction
+
+int total_failures = 0;
+
+// Run C = A * W^T for an M x K A and an N x K W; ld* = 0 selects the packed pitch
+task automatic run_gemm(input string name, input int m, input int n, input int k, input bit uns,
+                        input int lda, input int ldb, input int ldc);
+    int lda_eff = lda ? lda : (k + CHUNK_K - 1) / CHUNK_K * CHUNK_BYTES;
+    int ldb_eff = ldb ? ldb : (k + CHUNK_K - 1) / CHUNK_K * CHUNK_BYTES;
+    int ldc_eff = ldc ? ldc : (n + SIZE - 1) / SIZE * SIZE * 4;
+    int tiles_m = (m + SIZE - 1) / SIZE;
+    int tiles_n = (n + SIZE - 1) / SIZE;
+    int row_beats = (k + 31) / 32;
+    int a_m[], w_m[];
+    int mismatches = 0, clobbered = 0;
+    int exp_out = 0;
+    logic [31:0] status, act0, wgt0, out0, act1, wgt1, out1, busy_cycles;
+
+    a_m = new[m * k];
+    w_m = new[n * k];
+
+    // Junk everywhere the operands live, so anything read past K shows up
+    for (longint i = 0; i < longint'(m) * lda_eff; i++) poke8(BASE_ADDR_A + i, $urandom);
+    for (longint i = 0; i < longint'(n) * ldb_eff; i++) poke8(BASE_ADDR_B + i, $urandom);
+    for (longint i = 0; i < longint'(m + 1) * ldc_eff; i += 4) poke32(BASE_ADDR_C + i, SENTINEL);
+
+    for (int r = 0; r < m; r++)
+        for (int q = 0; q < k; q++) begin
+            a_m[r*k + q] = uns ? $urandom_range(0, 15) : $signed($urandom_range(0, 15)) - 8;
+            poke_int4(BASE_ADDR_A, lda_eff, r, q, a_m[r*k + q]);
+        end
+    for (int r = 0; r < n; r++)
+        for (int q = 0; q < k; q++) begin
+            w_m[r*k + q] = uns ? $urandom_range(0, 15) : $signed($urandom_range(0, 15)) - 8;
+            poke_int4(BASE_ADDR_B, ldb_eff, r, q, w_m[r*k + q]);
         end
+
+    // Configure ACC via AXI-Lite
+    axi_write(REG_A_LSB, BASE_ADDR_A[31:0]);
+    axi_write(REG_A_MSB, BASE_ADDR_A[63:32]);
+    axi_write(REG_B_LSB, BASE_ADDR_B[31:0]);
+    axi_write(REG_B_MSB, BASE_ADDR_B[63:32]);
+    axi_write(REG_C_LSB, BASE_ADDR_C[31:0]);
+    axi_write(REG_C_MSB, BASE_ADDR_C[63:32]);
+    axi_write(REG_LDA, lda);
+    axi_write(REG_LDB, ldb);
+    axi_write(REG_LDC, ldc);
+    axi_write(REG_DIM_M, m);
+    axi_write(REG_DIM_N, n);
+    axi_write(REG_DIM_K, k);
+    axi_read(REG_PERF_ACT, act0);
+    axi_read(REG_PERF_WGT, wgt0);
+    axi_read(REG_PERF_OUT, out0);
+    axi_read(REG_PERF_BUSY, busy_cycles);
+    axi_write(REG_CTRL, CTRL_START | (uns ? CTRL_UNSIGNED : 0));
+
+    // Wait for completion
+    status = 0;
+    for (int t = 0; t < 200000 && !status[0]; t++)
+        axi_read(REG_CTRL, status);
+    if (!status[0]) begin
+        $display("[%s] TIMEOUT (STATUS 0x%08h)", name, status);
+        total_failures++;
+        return;
     end
-    if (mismatches == 0)
-        $display("🎉 Test PASSED");
-    else
-        $display("FAILED with %0d mismatches", mismatches);
+    if (status[2]) begin
+        $display("[%s] AXI error reported", name);
+        total_failures++;
+    end
+    axi_read(REG_PERF_ACT, act1);
+    axi_read(REG_PERF_WGT, wgt1);
+    axi_read(REG_PERF_OUT, out1);
+    begin
+        logic [31:0] busy1;
+        axi_read(REG_PERF_BUSY, busy1);
+        busy_cycles = busy1 - busy_cycles;
+    end
+
+    // Check output and the bytes around it
+    for (int r = 0; r <= m; r++)
+        for (int c = 0; c < ldc_eff / 4; c++) begin
+            logic [31:0] got = peek32(BASE_ADDR_C + longint'(r) * ldc_eff + c * 4);
+            if (r < m && c < n) begin
+                int sum = 0;
+                for (int q = 0; q < k; q++) sum += a_m[r*k + q] * w_m[c*k + q];
+                if ($signed(got) !== sum) begin
+                    if (mismatches < 8) $display("[%s] C[%0d][%0d] = %0d (expected %0d)", name, r, c, $signed(got), sum);
+                    mismatches++;
+                end
+            end else if (got !== SENTINEL) begin
+                if (clobbered < 8) $display("[%s] wrote outside C at row %0d word %0d", name, r, c);
+                clobbered++;
+            end
+        end
+
+    // Every A row is read once per tile column and every W row once per tile row
+    for (int tn = 0; tn < tiles_n; tn++)
+        exp_out += m * ((((n - tn * SIZE) < SIZE ? (n - tn * SIZE) : SIZE) + 3) / 4);
+    if (act1 - act0 != tiles_n * m * row_beats || wgt1 - wgt0 != tiles_m * n * row_beats || out1 - out0 != exp_out) begin
+        $display("[%s] beats A/W/C %0d/%0d/%0d, expected %0d/%0d/%0d", name, act1 - act0, wgt1 - wgt0, out1 - out0,
+                 tiles_n * m * row_beats, tiles_m * n * row_beats, exp_out);
+        mismatches++;
+    end
+
+    $display("[%s] %0dx%0dx%0d %s: %0d cycles, %0d operand bytes read (INT8 would read %0d), %0d mismatches, %0d clobbered",
+             name, m, n, k, uns ? "unsigned" : "signed", busy_cycles, ((act1 - act0) + (wgt1 - wgt0)) * 16,
+             (tiles_n * m + tiles_m * n) * k, mismatches, clobbered);
+    total_failures += mismatches + clobbered;
 endtask
 
 // --------------------- TEST -----------------------
 
 initial begin
+    logic [31:0] id, int_status;
+
     rstn = 0;
     repeat (5) @(posedge clk);
     rstn = 1;
+    repeat (2) @(posedge clk);
 
-    // Generate test matrices
-    // for (int i = 0; i < SIZE*SIZE; i++) begin
-    //     mat_a[i] = i;
-    //     mat_b[i] = (SIZE*SIZE - 1 - i);
-    // end
-
-//     // Custom Matrix A (no pattern)
-// mat_a = '{
-//     12,  3,  7,  0,  9,  6, 15,  4,
-//      2, 13,  5, 14,  1,  8,  0, 11,
-//      7,  1, 12,  6,  5,  3,  9,  2,
-//      4, 15, 10,  2, 11,  0,  8,  7,
-//      9,  5,  3, 13, 14, 12,  6,  0,
-//     11,  0,  8,  1,  7, 10,  2,  5,
-//      6, 14,  4,  9,  0,  1, 13,  3,
-//      8,  2,  6,  5, 10,  7,  1, 15
-// };
-
-// // Custom Matrix B (no pattern)
-// mat_b = '{
-//      5,  8,  1, 14,  0, 13,  7,  9,
-//      6,  0, 10,  3, 15,  2,  4, 11,
-//     12,  4,  9,  6,  1,  5,  0,  8,
-//      0,  7, 13, 11,  2,  3,  6, 14,
-//      3, 10,  5,  0,  8, 12,  1,  4,
-//      7, 15,  2,  1,  9,  0, 13,  6,
-//     14,  6, 11,  5,  4,  8, 10,  0,
-//      1,  9,  3, 12,  6, 14,  2,  5
-// };
-
-
-    // for (int i = 0; i < SIZE*SIZE; i++) begin
-    // mat_a[i] = 4'd1;
-    // mat_b[i] = 4'd1;
-    // end
-
-    // Checkerboard A
-// for (int i = 0; i < SIZE*SIZE; i++) begin
-//     mat_a[i] = (i % 2);
-// end
-
-// // Identity matrix B
-// for (int i = 0; i < SIZE*SIZE; i++) begin
-//     mat_b[i] = (i / SIZE == i % SIZE) ? 4'd1 : 4'd0;
-// end
-
-// // Generate test matrices
-for (int i = 0; i < SIZE*SIZE; i++) begin
-    mat_a[i] = $urandom_range(0, 15); // 4-bit unsigned values
-    mat_b[i] = $urandom_range(0, 15);
-end
+    axi_read(REG_ACC_ID, id);
+    $display("ACC_ID 0x%08h (SIZE %0d, %0d beats per chunk)", id, id[23:16], id[15:8]);
+    if (id[31:24] != 8'h34 || id[23:16] != SIZE) begin
+        $display("Unexpected ACC_ID");
+        total_failures++;
+    end
 
+    // The original single-tile check
+    run_gemm("single tile", SIZE, SIZE, SIZE, 1, 0, 0, 0);
 
-    // Compute golden result
-    for (int r = 0; r < SIZE; r++)
-        for (int c = 0; c < SIZE; c++) begin
-            golden[r*SIZE + c] = 0;
-            for (int k = 0; k < SIZE; k++)
-                golden[r*SIZE + c] += mat_a[r*SIZE + k] * mat_b[k*SIZE + c];
-        end
+    // Partial tiles in every dimension, two K chunks, padded pitches
+    run_gemm("ragged", 13, 21, 200, 0, 128, 128, 4 * SIZE * 3);
 
-    // Pack and write matrix A and B to memory
-    for (int blk = 0; blk < SIZE*SIZE/32; blk++) begin
-        logic [3:0] tmp_a[32], tmp_b[32];
-        for (int j = 0; j < 32; j++) begin
-            tmp_a[j] = mat_a[blk*32 + j];
-            tmp_b[j] = mat_b[blk*32 + j];
-        end
+    // Several full K chunks per tile
+    run_gemm("K chunks", 2 * SIZE, 2 * SIZE, 4 * CHUNK_K, 0, 0, 0, 0);
 
-        mem.mem[(BASE_ADDR_A >> 4) + blk] = pack_4bit_32(tmp_a);
-        mem.mem[(BASE_ADDR_B >> 4) + blk] = pack_4bit_32(tmp_b);
-    end
+    // Decode: one activation row against a Gemma-sized K
+    run_gemm("decode", 1, 40, 1152, 0, 0, 0, 0);
 
-    // Configure ACC via AXI-Lite
-    axi_write(1, SIZE);                 // Matrix size
-    axi_write(3, BASE_ADDR_A[31:0]);    // Address A
-    axi_write(4, BASE_ADDR_B[31:0]);    // Address B
-    axi_write(5, BASE_ADDR_C[31:0]);    // Address C
-    axi_write(0, 1);                    // Start
-
-    // Wait for completion
-    repeat (100) @(posedge clk);
+    // Completion interrupt, then a rerun with the other operand mode
+    axi_write(REG_INT_ENABLE, 32'h1);
+    axi_write(REG_INT_GIE, 32'h1);
+    run_gemm("ragged unsigned", 13, 21, 200, 1, 128, 128, 4 * SIZE * 3);
+    repeat (4) @(posedge clk);
+    axi_read(REG_INT_STATUS, int_status);
+    if (!interrupt || !int_status[0]) begin
+        $display("Completion interrupt not raised (INT_STATUS 0x%08h)", int_status);
+        total_failures++;
+    end
+    axi_write(REG_INT_STATUS, 32'h1);
+    repeat (4) @(posedge clk);
+    if (interrupt) begin
+        $display("Interrupt still high after acknowledge");
+        total_failures++;
+    end
 
-    // Check output
-    compare_results();
+    if (total_failures == 0)
+        $display("🎉 Test PASSED");
+    else
+        $display("FAILED with %0d mismatches", total_failures);
     $finish;
 end
 
 endmodule
-
-
@@ -0,0 +1,1416 @@
+// gemm_offload.c - INT8 GEMM offload API for the Gemma accelerator
+// See gemm_offload.h for the data layout and platform hooks.
+
+#include "gemm_offload.h"
+#include <string.h>
+
+// ============================================================================
+// Capability discovery
+// ============================================================================
+
+int gemm_tile_size = 16;
+
+static gemm_caps_t gemm_caps_cur = { 16, 0, 0, 0, 0, 0 };
+
+int gemm_open(void) {
+    uint32_t id = read_reg32(GEMM_REG_ACC_ID);
+    gemm_caps_t caps;
+
+    // A build from before ACC_ID (GEMM_ID_LEGACY) has no LDA/LDB/LDC/ROWS,
+    // transpose or weight cache, which every launch below programs; any other
+    // signature is a different engine (the INT4 array reads '4' there)
+    if (GEMM_ID_SIGNATURE(id) != GEMM_ID_MAGIC) {
+        return GEMM_ERR_NODEV;
+    }
+    caps.tile     = (int)GEMM_ID_SIZE(id);
+    caps.wc_slots = (int)GEMM_ID_WC_SLOTS(id);
+    caps.dual_mac = (id & GEMM_ID_DUAL_MAC) != 0;
+    caps.async_compute = (id & GEMM_ID_ASYNC_COMPUTE) != 0;
+    caps.version  = (int)GEMM_ID_VERSION(id);
+    caps.id       = id;
+
+    // Beat-multiple tiles only: the strided fetches and C row bursts assume
+    // whole 16-byte beats per operand row
+    if (caps.tile < 16 || caps.tile > GEMM_TILE_MAX || (caps.tile & (caps.tile - 1)) != 0) {
+        return GEMM_ERR_NODEV;
+    }
+    gemm_caps_cur = caps;
+    gemm_tile_size = caps.tile;
+    return GEMM_OK;
+}
+
+const gemm_caps_t *gemm_caps(void) {
+    return &gemm_caps_cur;
+}
+
+// ============================================================================
+// Panel packers
+// ============================================================================
+// RV32IMAFC has no vector unit, so the packers work a 32-bit word (4 INT8) at
+// a time: aligned row copies move whole words, and the column-major paths
+// transpose 4x4 byte blocks inside registers. Anything misaligned or at a
+// ragged edge falls back to the byte loop.
+
+int gemm_panel_init(gemm_panel_t *p, int8_t *storage, int rows, int cols) {
+    if (!p || !storage || rows <= 0 || cols <= 0 || ((uintptr_t)storage % GEMM_ALIGN) != 0) {
+        return GEMM_ERR_ARG;
+    }
+    p->data    = storage;
+    p->rows    = rows;
+    p->cols    = cols;
+    p->tiles_r = gemm_tiles(rows);
+    p->tiles_c = gemm_tiles(cols);
+    p->nz      = 0;
+    return GEMM_OK;
+}
+
+// Any nonzero byte in a packed tile, a word at a time
+static int gemm_tile_nonzero(const int8_t *tile) {
+    const uint32_t *w = (const uint32_t *)tile;
+    uint32_t any = 0;
+    for (int i = 0; i < GEMM_TILE_BYTES / 4; i++) any |= w[i];
+    return any != 0;
+}
+
+static void gemm_panel_mark(gemm_panel_t *p, int tr, int tc, int nonzero) {
+    size_t i = (size_t)tr * p->tiles_c + tc;
+    if (nonzero) {
+        p->nz[i / 32] |= 1u << (i % 32);
+    } else {
+        p->nz[i / 32] &= ~(1u << (i % 32));
+    }
+}
+
+void gemm_panel_set_nz(gemm_panel_t *p, uint32_t *nz) {
+    p->nz = nz;
+}
+
+void gemm_panel_scan_nz(gemm_panel_t *p) {
+    if (!p->nz) {
+        return;
+    }
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            gemm_panel_mark(p, tr, tc, gemm_tile_nonzero(gemm_panel_tile(p, tr, tc)));
+        }
+    }
+}
+
+// 4x4 byte transpose: in[c] holds rows 0..3 of column c, out[r] holds
+// columns 0..3 of row r (little-endian byte order)
+static inline void transpose4x4_u8(const uint32_t in[4], uint32_t out[4]) {
+    uint32_t t0 = (in[0] & 0x00FF00FFu) | ((in[1] & 0x00FF00FFu) << 8);
+    uint32_t t1 = ((in[0] >> 8) & 0x00FF00FFu) | (in[1] & 0xFF00FF00u);
+    uint32_t t2 = (in[2] & 0x00FF00FFu) | ((in[3] & 0x00FF00FFu) << 8);
+    uint32_t t3 = ((in[2] >> 8) & 0x00FF00FFu) | (in[3] & 0xFF00FF00u);
+    out[0] = (t0 & 0x0000FFFFu) | (t2 << 16);
+    out[1] = (t1 & 0x0000FFFFu) | (t3 << 16);
+    out[2] = (t0 >> 16) | (t2 & 0xFFFF0000u);
+    out[3] = (t1 >> 16) | (t3 & 0xFFFF0000u);
+}
+
+static inline int word_aligned(const void *p, int ld) {
+    return ((uintptr_t)p % 4) == 0 && (ld % 4) == 0;
+}
+
+void gemm_pack_rowmajor(gemm_panel_t *p, const int8_t *src, int ld) {
+    int fast = word_aligned(src, ld);
+
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            int8_t *tile = gemm_panel_tile(p, tr, tc);
+            int r0 = tr * GEMM_TILE, c0 = tc * GEMM_TILE;
+            int nr = p->rows - r0 < GEMM_TILE ? p->rows - r0 : GEMM_TILE;
+            int nc = p->cols - c0 < GEMM_TILE ? p->cols - c0 : GEMM_TILE;
+
+            if (nr < GEMM_TILE || nc < GEMM_TILE) {
+                memset(tile, 0, GEMM_TILE_BYTES);
+            }
+            for (int r = 0; r < nr; r++) {
+                const int8_t *s = src + (size_t)(r0 + r) * ld + c0;
+                int8_t *d = tile + r * GEMM_TILE;
+                if (fast && nc == GEMM_TILE) {
+                    const uint32_t *sw = (const uint32_t *)s;
+                    uint32_t *dw = (uint32_t *)d;
+                    for (int w = 0; w < GEMM_TILE / 4; w++) dw[w] = sw[w];
+                } else {
+                    for (int c = 0; c < nc; c++) d[c] = s[c];
+                }
+            }
+            if (p->nz) {
+                gemm_panel_mark(p, tr, tc, gemm_tile_nonzero(tile));
+            }
+        }
+    }
+}
+
+void gemm_pack_colmajor(gemm_panel_t *p, const int8_t *src, int ld) {
+    int fast = word_aligned(src, ld);
+
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            int8_t *tile = gemm_panel_tile(p, tr, tc);
+            int r0 = tr * GEMM_TILE, c0 = tc * GEMM_TILE;
+            int nr = p->rows - r0 < GEMM_TILE ? p->rows - r0 : GEMM_TILE;
+            int nc = p->cols - c0 < GEMM_TILE ? p->cols - c0 : GEMM_TILE;
+
+            if (fast && nr == GEMM_TILE && nc == GEMM_TILE) {
+                uint32_t *dw = (uint32_t *)tile;
+                for (int cb = 0; cb < GEMM_TILE; cb += 4) {
+                    for (int rb = 0; rb < GEMM_TILE; rb += 4) {
+                        uint32_t in[4], out[4];
+                        for (int k = 0; k < 4; k++) {
+                            in[k] = *(const uint32_t *)(src + (size_t)(c0 + cb + k) * ld + r0 + rb);
+                        }
+                        transpose4x4_u8(in, out);
+                        for (int k = 0; k < 4; k++) {
+                            dw[((rb + k) * GEMM_TILE + cb) / 4] = out[k];
+                        }
+                    }
+                }
+            } else {
+                memset(tile, 0, GEMM_TILE_BYTES);
+                for (int c = 0; c < nc; c++) {
+                    const int8_t *s = src + (size_t)(c0 + c) * ld + r0;
+                    for (int r = 0; r < nr; r++) tile[r * GEMM_TILE + c] = s[r];
+                }
+            }
+            if (p->nz) {
+                gemm_panel_mark(p, tr, tc, gemm_tile_nonzero(tile));
+            }
+        }
+    }
+}
+
+void gemm_quantize_rowmajor(gemm_panel_t *p, const float *src, int ld, float inv_scale) {
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            int8_t *tile = gemm_panel_tile(p, tr, tc);
+            int r0 = tr * GEMM_TILE, c0 = tc * GEMM_TILE;
+            int nr = p->rows - r0 < GEMM_TILE ? p->rows - r0 : GEMM_TILE;
+            int nc = p->cols - c0 < GEMM_TILE ? p->cols - c0 : GEMM_TILE;
+            int any = 0;
+
+            if (nr < GEMM_TILE || nc < GEMM_TILE) {
+                memset(tile, 0, GEMM_TILE_BYTES);
+            }
+            for (int r = 0; r < nr; r++) {
+                const float *s = src + (size_t)(r0 + r) * ld + c0;
+                int8_t *d = tile + r * GEMM_TILE;
+                for (int c = 0; c < nc; c++) {
+                    float v = s[c] * inv_scale;
+                    int q = v >= 127.0f ? 127 : v <= -128.0f ? -128 : (int)(v + (v >= 0.0f ? 0.5f : -0.5f));
+                    d[c] = (int8_t)q;
+                    any |= q;
+                }
+            }
+            if (p->nz) {
+                gemm_panel_mark(p, tr, tc, any != 0);
+            }
+        }
+    }
+}
+
+void gemm_unpack_rowmajor(const gemm_panel_t *p, int8_t *dst, int ld) {
+    int fast = word_aligned(dst, ld);
+
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            const int8_t *tile = gemm_panel_tile(p, tr, tc);
+            int r0 = tr * GEMM_TILE, c0 = tc * GEMM_TILE;
+            int nr = p->rows - r0 < GEMM_TILE ? p->rows - r0 : GEMM_TILE;
+            int nc = p->cols - c0 < GEMM_TILE ? p->cols - c0 : GEMM_TILE;
+
+            for (int r = 0; r < nr; r++) {
+                const int8_t *s = tile + r * GEMM_TILE;
+                int8_t *d = dst + (size_t)(r0 + r) * ld + c0;
+                if (fast && nc == GEMM_TILE) {
+                    const uint32_t *sw = (const uint32_t *)s;
+                    uint32_t *dw = (uint32_t *)d;
+                    for (int w = 0; w < GEMM_TILE / 4; w++) dw[w] = sw[w];
+                } else {
+                    for (int c = 0; c < nc; c++) d[c] = s[c];
+                }
+            }
+        }
+    }
+}
+
+void gemm_unpack_colmajor(const gemm_panel_t *p, int8_t *dst, int ld) {
+    int fast = word_aligned(dst, ld);
+
+    for (int tr = 0; tr < p->tiles_r; tr++) {
+        for (int tc = 0; tc < p->tiles_c; tc++) {
+            const int8_t *tile = gemm_panel_tile(p, tr, tc);
+            int r0 = tr * GEMM_TILE, c0 = tc * GEMM_TILE;
+            int nr = p->rows - r0 < GEMM_TILE ? p->rows - r0 : GEMM_TILE;
+            int nc = p->cols - c0 < GEMM_TILE ? p->cols - c0 : GEMM_TILE;
+
+            if (fast && nr == GEMM_TILE && nc == GEMM_TILE) {
+                const uint32_t *sw = (const uint32_t *)tile;
+                for (int rb = 0; rb < GEMM_TILE; rb += 4) {
+                    for (int cb = 0; cb < GEMM_TILE; cb += 4) {
+                        uint32_t in[4], out[4];
+                        // Rows of the tile are the "columns" of the transpose
+                        for (int k = 0; k < 4; k++) {
+                            in[k] = sw[((rb + k) * GEMM_TILE + cb) / 4];
+                        }
+                        transpose4x4_u8(in, out);
+                        for (int k = 0; k < 4; k++) {
+                            *(uint32_t *)(dst + (size_t)(c0 + cb + k) * ld + r0 + rb) = out[k];
+                        }
+                    }
+                }
+                continue;
+            }
+
+            for (int c = 0; c < nc; c++) {
+                int8_t *d = dst + (size_t)(c0 + c) * ld + r0;
+                for (int r = 0; r < nr; r++) d[r] = tile[r * GEMM_TILE + c];
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Accelerator tile execution
+// ============================================================================
+
+// Let the accelerator serve weight tiles from its resident tile or cache
+static int gemm_reuse_weights = 1;
+
+// Ring set up by gemm_ring_init(); gemm_pin_weights() queues through it
+static gemm_ring_t *gemm_ring_cur;
+
+// Completion interrupt: waits sleep in gemm_irq_wait when set, else poll
+static gemm_irq_wait_fn gemm_irq_wait;
+static void            *gemm_irq_ctx;
+static uint32_t         gemm_irq_sources;  // INT_ENABLE as last written
+
+int gemm_irq_enable(gemm_irq_wait_fn wait, void *ctx) {
+    if (!wait) {
+        return GEMM_ERR_ARG;
+    }
+    if (gemm_caps_cur.version < GEMM_ID_VERSION_IRQ) {
+        return GEMM_ERR_NODEV;
+    }
+    write_reg32(GEMM_REG_INT_ENABLE, 0);
+    write_reg32(GEMM_REG_INT_STATUS, GEMM_INT_DONE | GEMM_INT_RING | GEMM_INT_ERROR);
+    write_reg32(GEMM_REG_INT_GIE, 1);
+    gemm_irq_sources = 0;
+    gemm_irq_wait = wait;
+    gemm_irq_ctx = ctx;
+    return GEMM_OK;
+}
+
+void gemm_irq_disable(void) {
+    if (!gemm_irq_wait) {
+        return;
+    }
+    write_reg32(GEMM_REG_INT_GIE, 0);
+    write_reg32(GEMM_REG_INT_ENABLE, 0);
+    gemm_irq_wait = 0;
+    gemm_irq_ctx = 0;
+}
+
+uint32_t gemm_irq_ack(void) {
+    // Only the sources read are cleared, so one firing meanwhile stays pending
+    uint32_t pending = read_reg32(GEMM_REG_INT_STATUS);
+    if (pending) {
+        write_reg32(GEMM_REG_INT_STATUS, pending);
+    }
+    return pending;
+}
+
+// One wait step after a failed STATUS/HEAD check: sleep until one of the
+// sources fires (a source that already fired is latched, so none is missed),
+// or return at once when polling. Nonzero if the wait function timed out.
+static int gemm_irq_sleep(uint32_t sources) {
+    if (!gemm_irq_wait) {
+        return 0;
+    }
+    if (sources != gemm_irq_sources) {
+        write_reg32(GEMM_REG_INT_ENABLE, sources);
+        gemm_irq_sources = sources;
+    }
+    return gemm_irq_wait(gemm_irq_ctx) < 0;
+}
+
+// Program operand addresses and start. Cache maintenance is left to the caller.
+static void gemm_start(const int8_t *a, const int8_t *b, int32_t *c, uint32_t ctrl) {
+    write_reg32(GEMM_REG_A_LSB, (uint32_t)(uintptr_t)a);
+    write_reg32(GEMM_REG_A_MSB, 0);
+    write_reg32(GEMM_REG_B_LSB, (uint32_t)(uintptr_t)b);
+    write_reg32(GEMM_REG_B_MSB, 0);
+    write_reg32(GEMM_REG_C_LSB, (uint32_t)(uintptr_t)c);
+    write_reg32(GEMM_REG_C_MSB, 0);
+    write_reg32(GEMM_REG_CTRL, ctrl);
+}
+
+static int gemm_wait(void) {
+    // DONE is raised only after the final write response (S_WAIT_WRITE_END)
+    for (int polls = 0; polls < GEMM_TIMEOUT_POLLS; polls++) {
+        uint32_t status = read_reg32(GEMM_REG_CTRL);
+        if ((status & GEMM_STATUS_DONE) && !(status & GEMM_STATUS_BUSY)) {
+            return (status & GEMM_STATUS_ERROR) ? GEMM_ERR_AXI : GEMM_OK;
+        }
+        if (gemm_irq_sleep(GEMM_INT_DONE | GEMM_INT_ERROR)) {
+            return GEMM_ERR_TIMEOUT;
+        }
+    }
+    return GEMM_ERR_TIMEOUT;
+}
+
+static int gemm_launch(const int8_t *a, const int8_t *b, int32_t *c, uint32_t ctrl) {
+    gemm_start(a, b, c, ctrl);
+    return gemm_wait();
+}
+
+void gemm_set_weight_reuse(int enable) {
+    gemm_reuse_weights = enable != 0;
+}
+
+void gemm_read_counters(gemm_counters_t *cnt) {
+    cnt->act_beats = read_reg32(GEMM_REG_PERF_ACT_BEATS);
+    cnt->wgt_beats = read_reg32(GEMM_REG_PERF_WGT_BEATS);
+    cnt->out_beats = read_reg32(GEMM_REG_PERF_OUT_BEATS);
+    cnt->wgt_reuse = read_reg32(GEMM_REG_PERF_WGT_REUSE);
+    cnt->wc_hits   = read_reg32(GEMM_REG_WCACHE_HITS);
+    cnt->wc_misses = read_reg32(GEMM_REG_WCACHE_MISSES);
+}
+
+int gemm_pin_weights(int trans_b, int n, int k, const int8_t *b, int ldb) {
+    if (n <= 0 || k <= 0 || !b || ldb < (trans_b ? k : n) ||
+        ((uintptr_t)b % GEMM_ALIGN) != 0 || (ldb % GEMM_ALIGN) != 0) {
+        return GEMM_ERR_ARG;
+    }
+
+    int slots = gemm_caps_cur.wc_slots;
+    int pinned = 0;
+    uint32_t ctrl = GEMM_CTRL_START | GEMM_CTRL_PRELOAD_B | GEMM_CTRL_REUSE_B | GEMM_CTRL_PIN_B;
+    gemm_ring_t *ring = gemm_ring_cur;
+    int rc = GEMM_OK;
+
+    cache_clean_range((uintptr_t)b, (size_t)((trans_b ? n : k) - 1) * ldb + (trans_b ? k : n));
+    if (!ring) {
+        write_reg32(GEMM_REG_LDB, (uint32_t)ldb);
+    }
+
+    // Same traversal and tags (address, pitch) as gemm_int8(); ragged edge
+    // tiles are staged through scratch there and cannot be pinned. With a
+    // ring every preload is queued and one doorbell starts them all.
+    for (int c0 = 0; c0 + GEMM_TILE <= n && pinned < slots && rc == GEMM_OK; c0 += GEMM_TILE) {
+        for (int k0 = 0; k0 + GEMM_TILE <= k && pinned < slots && rc == GEMM_OK; k0 += GEMM_TILE) {
+            const int8_t *blk = trans_b ? b + (size_t)c0 * ldb + k0 : b + (size_t)k0 * ldb + c0;
+            rc = ring ? gemm_ring_push(ring, 0, blk, 0, 0, (uint32_t)ldb, 0, 0, ctrl)
+                      : gemm_launch(0, blk, 0, ctrl);
+            pinned++;
+        }
+    }
+    if (ring && rc == GEMM_OK) {
+        rc = gemm_ring_wait(ring);
+    }
+
+    write_reg32(GEMM_REG_LDB, 0);
+    return rc == GEMM_OK ? pinned : rc;
+}
+
+void gemm_unpin_weights(void) {
+    write_reg32(GEMM_REG_WCACHE_CTRL, GEMM_WCACHE_UNPIN);
+}
+
+void gemm_invalidate_weights(void) {
+    write_reg32(GEMM_REG_WCACHE_CTRL, GEMM_WCACHE_INVALIDATE);
+}
+
+// Shape registers are only rewritten when they change between launches
+typedef struct {
+    uint32_t lda, ldb, ldc, rows;
+} gemm_cfg_t;
+
+static void gemm_set_cfg(gemm_cfg_t *cur, uint32_t lda, uint32_t ldb, uint32_t ldc, uint32_t rows) {
+    if (cur->lda != lda)   { write_reg32(GEMM_REG_LDA, lda);   cur->lda = lda; }
+    if (cur->ldb != ldb)   { write_reg32(GEMM_REG_LDB, ldb);   cur->ldb = ldb; }
+    if (cur->ldc != ldc)   { write_reg32(GEMM_REG_LDC, ldc);   cur->ldc = ldc; }
+    if (cur->rows != rows) { write_reg32(GEMM_REG_ROWS, rows); cur->rows = rows; }
+}
+
+int gemm_run_tile(const int8_t *a, const int8_t *b, int32_t *c) {
+    // Operands must reach DDR; no dirty line of C may be evicted over the result
+    cache_clean_range((uintptr_t)a, GEMM_TILE_BYTES);
+    cache_clean_range((uintptr_t)b, GEMM_TILE_BYTES);
+    cache_flush_range((uintptr_t)c, GEMM_TILE_C_BYTES);
+
+    int rc = gemm_launch(a, b, c, GEMM_CTRL_START);
+    if (rc != GEMM_ERR_TIMEOUT) {
+        cache_invalidate_range((uintptr_t)c, GEMM_TILE_C_BYTES);
+    }
+    return rc;
+}
+
+int gemm_int8_panels(const gemm_panel_t *a, const gemm_panel_t *b,
+                     int32_t *c, int ldc, int32_t *c_scratch) {
+    if (!a || !b || !c || !c_scratch || a->cols != b->rows || ldc < b->cols ||
+        ((uintptr_t)c_scratch % GEMM_ALIGN) != 0) {
+        return GEMM_ERR_ARG;
+    }
+
+    int m = a->rows, n = b->cols;
+
+    for (int tm = 0; tm < a->tiles_r; tm++) {
+        for (int tn = 0; tn < b->tiles_c; tn++) {
+            int r0 = tm * GEMM_TILE, c0 = tn * GEMM_TILE;
+            int nr = m - r0 < GEMM_TILE ? m - r0 : GEMM_TILE;
+            int nc = n - c0 < GEMM_TILE ? n - c0 : GEMM_TILE;
+            int first = 1;
+
+            // The array does not accumulate across launches; sum K tiles here.
+            // A product with an all-zero operand tile adds nothing.
+            for (int tk = 0; tk < a->tiles_c; tk++) {
+                if (!gemm_panel_tile_nz(a, tm, tk) || !gemm_panel_tile_nz(b, tk, tn)) {
+                    continue;
+                }
+                int rc = gemm_run_tile(gemm_panel_tile(a, tm, tk),
+                                       gemm_panel_tile(b, tk, tn), c_scratch);
+                if (rc != GEMM_OK) return rc;
+
+                for (int r = 0; r < nr; r++) {
+                    int32_t *dst = c + (size_t)(r0 + r) * ldc + c0;
+                    const int32_t *src = c_scratch + r * GEMM_TILE;
+                    if (first) {
+                        for (int j = 0; j < nc; j++) dst[j] = src[j];
+                    } else {
+                        for (int j = 0; j < nc; j++) dst[j] += src[j];
+                    }
+                }
+                first = 0;
+            }
+            if (first) {
+                for (int r = 0; r < nr; r++) {
+                    memset(c + (size_t)(r0 + r) * ldc + c0, 0, (size_t)nc * sizeof(int32_t));
+                }
+            }
+        }
+    }
+    return GEMM_OK;
+}
+
+// ============================================================================
+// Descriptor ring
+// ============================================================================
+
+static uint32_t gemm_ring_head(const gemm_ring_t *r) {
+    if (!r->head_wb) {
+        return read_reg32(GEMM_REG_RING_HEAD);
+    }
+    cache_invalidate_range((uintptr_t)r->head_wb, sizeof(uint32_t));
+    return *r->head_wb;
+}
+
+// Empty the ring on both sides: the RING_SIZE write zeroes HEAD, TAIL and
+// the sticky ring error
+static void gemm_ring_reset(gemm_ring_t *r) {
+    r->tail = r->doorbell = r->head = 0;
+    if (r->head_wb) {
+        *r->head_wb = 0;
+        cache_flush_range((uintptr_t)r->head_wb, sizeof(uint32_t));
+    }
+    write_reg32(GEMM_REG_RING_SIZE, r->entries);
+}
+
+int gemm_ring_init(gemm_ring_t *r, gemm_desc_t *storage, int entries, volatile uint32_t *head_wb) {
+    if (!r || !storage || entries < 2 || entries > 0xFFFF ||
+        ((uintptr_t)storage % sizeof(gemm_desc_t)) != 0 || ((uintptr_t)head_wb % sizeof(uint32_t)) != 0) {
+        return GEMM_ERR_ARG;
+    }
+    if (gemm_caps_cur.version < GEMM_ID_VERSION_RING) {
+        return GEMM_ERR_NODEV;
+    }
+
+    r->desc = storage;
+    r->head_wb = head_wb;
+    r->entries = (uint32_t)entries;
+    write_reg32(GEMM_REG_RING_BASE_LO, (uint32_t)(uintptr_t)storage);
+    write_reg32(GEMM_REG_RING_BASE_HI, 0);
+    write_reg32(GEMM_REG_RING_WB_LO, (uint32_t)(uintptr_t)head_wb);
+    write_reg32(GEMM_REG_RING_WB_HI, 0);
+    gemm_ring_reset(r);
+    gemm_ring_cur = r;
+    return GEMM_OK;
+}
+
+int gemm_ring_push(gemm_ring_t *r, const int8_t *a, const int8_t *b, int32_t *c,
+                   uint32_t lda, uint32_t ldb, uint32_t ldc, uint32_t rows, uint32_t ctrl) {
+    uint32_t next = (r->tail + 1 == r->entries) ? 0 : r->tail + 1;
+
+    // Full: hand the accelerator what is queued and wait for one entry
+    if (next == r->head) {
+        gemm_ring_submit(r);
+        for (int polls = 0; (r->head = gemm_ring_head(r)) == next; polls++) {
+            if (polls == GEMM_TIMEOUT_POLLS || gemm_irq_sleep(GEMM_INT_DONE | GEMM_INT_ERROR)) {
+                return GEMM_ERR_TIMEOUT;
+            }
+        }
+    }
+
+    gemm_desc_t *d = &r->desc[r->tail];
+    d->a_lo = (uint32_t)(uintptr_t)a;
+    d->a_hi = 0;
+    d->b_lo = (uint32_t)(uintptr_t)b;
+    d->b_hi = 0;
+    d->c_lo = (uint32_t)(uintptr_t)c;
+    d->c_hi = 0;
+    d->lda  = lda;
+    d->ldb  = ldb;
+    d->ldc  = ldc;
+    d->rows = rows;
+    d->ctrl = ctrl & ~(uint32_t)GEMM_CTRL_START;
+    memset(d->reserved, 0, sizeof(d->reserved));
+    r->tail = next;
+    return GEMM_OK;
+}
+
+void gemm_ring_submit(gemm_ring_t *r) {
+    if (r->tail == r->doorbell) {
+        return;
+    }
+    // Entries filled since the last doorbell must reach DDR before it
+    if (r->tail > r->doorbell) {
+        cache_clean_range((uintptr_t)&r->desc[r->doorbell], (r->tail - r->doorbell) * sizeof(gemm_desc_t));
+    } else {
+        cache_clean_range((uintptr_t)&r->desc[r->doorbell], (r->entries - r->doorbell) * sizeof(gemm_desc_t));
+        cache_clean_range((uintptr_t)r->desc, r->tail * sizeof(gemm_desc_t));
+    }
+    write_reg32(GEMM_REG_RING_TAIL, r->tail);
+    r->doorbell = r->tail;
+}
+
+int gemm_ring_wait(gemm_ring_t *r) {
+    gemm_ring_submit(r);
+
+    // The timeout restarts whenever an entry completes. HEAD moves only after
+    // the entry's last write response, as DONE does for a register launch.
+    uint32_t last = r->head;
+    for (int polls = 0; (r->head = gemm_ring_head(r)) != r->tail; polls++) {
+        if (r->head != last) {
+            last = r->head;
+            polls = 0;
+        } else if (polls == GEMM_TIMEOUT_POLLS) {
+            return GEMM_ERR_TIMEOUT;
+        }
+        if (gemm_irq_sleep(GEMM_INT_RING | GEMM_INT_ERROR)) {
+            return GEMM_ERR_TIMEOUT;
+        }
+    }
+
+    if (read_reg32(GEMM_REG_CTRL) & GEMM_STATUS_RING_ERROR) {
+        gemm_ring_reset(r);  // Drained, so restarting at entry 0 loses nothing
+        return GEMM_ERR_AXI;
+    }
+    return GEMM_OK;
+}
+
+// ============================================================================
+// Strided GEMM on row-major operands
+// ============================================================================
+
+// Copy an nr x nc block into a zero-padded dense GEMM_TILE x GEMM_TILE tile
+static void gemm_stage_tile(int8_t *tile, const int8_t *src, int ld, int nr, int nc) {
+    if (nr < GEMM_TILE || nc < GEMM_TILE) {
+        memset(tile, 0, GEMM_TILE_BYTES);
+    }
+    for (int r = 0; r < nr; r++) {
+        memcpy(tile + r * GEMM_TILE, src + (size_t)r * ld, nc);
+    }
+}
+
+// A scratch tile result still to be copied (first K step) or summed into C
+typedef struct {
+    const int32_t *src;
+    int32_t       *dst;
+    int            ldc, nr, nc, accumulate;
+} gemm_pending_t;
+
+static void gemm_retire(const gemm_pending_t *p) {
+    for (int r = 0; r < p->nr; r++) {
+        int32_t *dst = p->dst + (size_t)r * p->ldc;
+        const int32_t *src = p->src + r * GEMM_TILE;
+        if (p->accumulate) {
+            for (int j = 0; j < p->nc; j++) dst[j] += src[j];
+        } else {
+            for (int j = 0; j < p->nc; j++) dst[j] = src[j];
+        }
+    }
+}
+
+static int gemm_int8_tiles(int trans_a, int trans_b, int m, int n, int k,
+                           const int8_t *a, int lda, size_t stride_a,
+                           const int8_t *b, int ldb, size_t stride_b,
+                           int32_t *c, int ldc, size_t stride_c,
+                           int batch, int reuse, int panel_rows, void *scratch, gemm_cfg_t *cfg) {
+    int8_t  *a_tile = (int8_t *)scratch;
+    int8_t  *b_tile = a_tile + GEMM_TILE_BYTES;
+    int32_t *c_tile[2];
+    c_tile[0] = (int32_t *)(b_tile + GEMM_TILE_BYTES);
+    c_tile[1] = c_tile[0] + GEMM_TILE * GEMM_TILE;
+
+    int a_direct = ((uintptr_t)a % GEMM_ALIGN) == 0 && (lda % GEMM_ALIGN) == 0 &&
+                   (stride_a % GEMM_ALIGN) == 0;
+    int b_direct = ((uintptr_t)b % GEMM_ALIGN) == 0 && (ldb % GEMM_ALIGN) == 0 &&
+                   (stride_b % GEMM_ALIGN) == 0;
+    int c_direct = ((uintptr_t)c % GEMM_C_ROW_ALIGN) == 0 &&
+                   ((ldc * sizeof(int32_t)) % GEMM_C_ROW_ALIGN) == 0 &&
+                   ((stride_c * sizeof(int32_t)) % GEMM_C_ROW_ALIGN) == 0;
+    uint32_t ctrl = GEMM_CTRL_START | (trans_a ? GEMM_CTRL_TRANS_A : 0) |
+                    (trans_b ? GEMM_CTRL_TRANS_B : 0);
+
+    // Stored shapes: a transposed operand's tile is simply fetched as stored
+    int a_rows = trans_a ? k : m, a_cols = trans_a ? m : k;
+    int b_rows = trans_b ? n : k, b_cols = trans_b ? k : n;
+
+    // One pass over each operand instead of per-tile maintenance. C and the
+    // scratch C tiles are flushed so no dirty line can later be evicted over
+    // accelerator output (the caller may have written the scratch).
+    for (int h = 0; h < batch; h++) {
+        cache_clean_range((uintptr_t)(a + h * stride_a), (size_t)(a_rows - 1) * lda + a_cols);
+        cache_clean_range((uintptr_t)(b + h * stride_b), (size_t)(b_rows - 1) * ldb + b_cols);
+        cache_flush_range((uintptr_t)(c + h * stride_c), ((size_t)(m - 1) * ldc + n) * sizeof(int32_t));
+    }
+    cache_flush_range((uintptr_t)c_tile[0], 2 * GEMM_TILE_C_BYTES);
+
+    // Cached tiles from earlier calls may be stale (B or scratch rewritten);
+    // only pinned tiles are kept, under the gemm_pin_weights() contract
+    if (reuse) {
+        write_reg32(GEMM_REG_WCACHE_CTRL, GEMM_WCACHE_DROP_UNPINNED);
+    }
+
+    gemm_pending_t pending = { 0, 0, 0, 0, 0, 0 };
+    int have_pending = 0, sel = 0;
+
+    // The weight block most recently fetched by the accelerator (source
+    // address, before any staging) and the pitch it was fetched with
+    const int8_t *b_resident = 0;
+    uint32_t b_resident_pitch = 0;
+
+    // Rows are swept in panels of panel_rows. Inside a panel the order is
+    // weight-stationary: row blocks are innermost, so each weight tile is
+    // fetched once per panel and reused against the panel's A row blocks
+    // (a broadcast B, stride_b = 0, also stays resident across batch
+    // entries). Shorter panels keep the C blocks being summed in the CPU
+    // cache; gemm_plan() picks the height.
+    for (int p0 = 0; p0 < m; p0 += panel_rows) {
+        int p_end = m - p0 < panel_rows ? m : p0 + panel_rows;
+        for (int c0 = 0; c0 < n; c0 += GEMM_TILE) {
+            int nc = n - c0 < GEMM_TILE ? n - c0 : GEMM_TILE;
+            for (int k0 = 0; k0 < k; k0 += GEMM_TILE) {
+                int nk = k - k0 < GEMM_TILE ? k - k0 : GEMM_TILE;
+                for (int h = 0; h < batch; h++) {
+                    const int8_t *a_h = a + h * stride_a;
+                    const int8_t *b_h = b + h * stride_b;
+                    const int8_t *b_src = trans_b ? b_h + (size_t)c0 * ldb + k0 : b_h + (size_t)k0 * ldb + c0;
+                    for (int r0 = p0; r0 < p_end; r0 += GEMM_TILE) {
+                        int nr = m - r0 < GEMM_TILE ? m - r0 : GEMM_TILE;
+                        int32_t *c_blk = c + h * stride_c + (size_t)r0 * ldc + c0;
+                        const int8_t *a_blk = trans_a ? a_h + (size_t)k0 * lda + r0 : a_h + (size_t)r0 * lda + k0;
+                        const int8_t *b_blk = b_src;
+                        uint32_t a_pitch = lda, b_pitch = ldb;
+
+                        // Short row blocks need no staging: ROWS limits the A fetch.
+                        // A transposed A is stored by K and is fetched whole.
+                        if (!a_direct || nk < GEMM_TILE || (trans_a && nr < GEMM_TILE)) {
+                            if (trans_a) gemm_stage_tile(a_tile, a_blk, lda, nk, nr);
+                            else         gemm_stage_tile(a_tile, a_blk, lda, nr, nk);
+                            cache_clean_range((uintptr_t)a_tile, GEMM_TILE_BYTES);
+                            a_blk = a_tile;
+                            a_pitch = 0;
+                        }
+                        // Direct blocks are looked up by address in the weight
+                        // cache. Staged blocks all share b_tile's address, so they
+                        // may only reuse the resident tile (and skip restaging).
+                        int b_reuse = reuse;
+                        if (!b_direct || nk < GEMM_TILE || nc < GEMM_TILE) {
+                            b_reuse = b_reuse && b_src == b_resident && b_resident_pitch == 0;
+                            if (!b_reuse) {
+                                if (trans_b) gemm_stage_tile(b_tile, b_blk, ldb, nc, nk);
+                                else         gemm_stage_tile(b_tile, b_blk, ldb, nk, nc);
+                                cache_clean_range((uintptr_t)b_tile, GEMM_TILE_BYTES);
+                            }
+                            b_blk = b_tile;
+                            b_pitch = 0;
+                        }
+                        b_resident = b_src;
+                        b_resident_pitch = b_pitch;
+
+                        // The first K step lands in C directly (only nr rows are
+                        // written); later steps and ragged N edges go through
+                        // scratch and are summed.
+                        int in_place = (k0 == 0) && c_direct && nc == GEMM_TILE;
+                        gemm_set_cfg(cfg, a_pitch, b_pitch,
+                                     in_place ? (uint32_t)(ldc * sizeof(int32_t)) : 0,
+                                     nr == GEMM_TILE ? 0 : (uint32_t)nr);
+
+                        // Sum the previous scratch result while this tile runs;
+                        // the two scratch C tiles alternate between launches
+                        gemm_start(a_blk, b_blk, in_place ? c_blk : c_tile[sel],
+                                   ctrl | (b_reuse ? GEMM_CTRL_REUSE_B : 0));
+                        if (have_pending) {
+                            gemm_retire(&pending);
+                            have_pending = 0;
+                        }
+                        int rc = gemm_wait();
+                        if (rc != GEMM_OK) return rc;
+
+                        if (in_place) {
+                            // Flush, not invalidate: the span also covers finished
+                            // neighbouring tiles the CPU may hold dirty
+                            cache_flush_range((uintptr_t)c_blk,
+                                              ((size_t)(nr - 1) * ldc + GEMM_TILE) * sizeof(int32_t));
+                            continue;
+                        }
+
+                        cache_invalidate_range((uintptr_t)c_tile[sel], (size_t)nr * GEMM_TILE * sizeof(int32_t));
+                        pending.src = c_tile[sel];
+                        pending.dst = c_blk;
+                        pending.ldc = ldc;
+                        pending.nr = nr;
+                        pending.nc = nc;
+                        pending.accumulate = (k0 != 0);
+                        have_pending = 1;
+                        sel ^= 1;
+                    }
+                }
+            }
+        }
+    }
+    if (have_pending) {
+        gemm_retire(&pending);
+    }
+    return GEMM_OK;
+}
+
+// ============================================================================
+// Traversal planning
+// ============================================================================
+// DDR traffic of a panel height (in row blocks), from the tile counts:
+//   A: no on-chip reuse, every launch fetches its rows (GEMM_TILE for a transposed A)
+//   B: one fetch per (panel, column, K) block with reuse on; only one in
+//      total when there is a single panel or every B tile fits in the cache
+//   C: the accelerator writes every launch's rows; the CPU reads each later
+//      K step back from scratch and sums it into C. The panel's C blocks
+//      stay in the D-cache between K steps if they fit in half of it,
+//      otherwise every K step reads and writes C in DDR again.
+// K-outer orders are not candidates: with accumulation on the CPU they make
+// every K step a full pass over C.
+
+static size_t      gemm_cpu_cache = GEMM_CPU_CACHE_BYTES;
+static int         gemm_forced_panel;
+static gemm_plan_t gemm_plan_used;
+
+void gemm_set_cpu_cache_bytes(size_t bytes) {
+    gemm_cpu_cache = bytes;
+}
+
+void gemm_force_panel(int panel) {
+    gemm_forced_panel = panel > 0 ? panel : 0;
+}
+
+void gemm_last_plan(gemm_plan_t *plan) {
+    *plan = gemm_plan_used;
+}
+
+static void gemm_predict(gemm_plan_t *p, int trans_a, int m, int n, int k,
+                         int batch, int shared_b, int slots, int reuse) {
+    uint64_t mt = gemm_tiles(m), nt = gemm_tiles(n), kt = gemm_tiles(k);
+    uint64_t panels = (mt + p->panel - 1) / p->panel;
+    uint64_t b_tiles = nt * kt * (shared_b ? 1 : batch);
+    uint64_t a_rows = trans_a ? mt * GEMM_TILE : (uint64_t)m;
+
+    p->a_read = batch * nt * kt * a_rows * GEMM_TILE;         // One tile row per A row
+    p->c_write = batch * nt * kt * m * GEMM_C_ROW_ALIGN;      // One C tile row per C row
+    if (!reuse) {
+        p->b_read = batch * mt * nt * kt * GEMM_TILE_BYTES;
+    } else if (panels == 1 || b_tiles <= (uint64_t)slots) {
+        p->b_read = b_tiles * GEMM_TILE_BYTES;
+    } else {
+        p->b_read = panels * b_tiles * GEMM_TILE_BYTES;
+    }
+
+    p->c_cpu = 0;
+    if (kt > 1) {
+        uint64_t c_bytes = (uint64_t)batch * m * n * sizeof(int32_t);
+        size_t working = (size_t)(p->panel * batch + 2) * GEMM_TILE_C_BYTES;
+        p->c_cpu = batch * nt * (kt - 1) * m * GEMM_C_ROW_ALIGN +
+                   (working <= gemm_cpu_cache / 2 ? 2 : 2 * (kt - 1)) * c_bytes;
+    }
+}
+
+static void gemm_plan_for(int trans_a, int m, int n, int k, int batch, int shared_b,
+                          int forced, int reuse, gemm_plan_t *plan) {
+    int mt = gemm_tiles(m);
+    int slots = gemm_caps_cur.wc_slots;
+
+    if (forced) {
+        plan->panel = forced < mt ? forced : mt;
+        gemm_predict(plan, trans_a, m, n, k, batch, shared_b, slots, reuse);
+        return;
+    }
+
+    // Full height first, then powers of two; ties keep the taller panel
+    gemm_plan_t cand;
+    plan->panel = mt;
+    gemm_predict(plan, trans_a, m, n, k, batch, shared_b, slots, reuse);
+    for (int panel = 1; panel < mt; panel *= 2) {
+        cand.panel = panel;
+        gemm_predict(&cand, trans_a, m, n, k, batch, shared_b, slots, reuse);
+        if (gemm_plan_bytes(&cand) < gemm_plan_bytes(plan)) {
+            *plan = cand;
+        }
+    }
+}
+
+int gemm_plan(int trans_a, int m, int n, int k, int batch, int shared_b, gemm_plan_t *plan) {
+    if (m <= 0 || n <= 0 || k <= 0 || batch <= 0 || !plan) {
+        return GEMM_ERR_ARG;
+    }
+    gemm_plan_for(trans_a, m, n, k, batch, shared_b, gemm_forced_panel, gemm_reuse_weights, plan);
+    return GEMM_OK;
+}
+
+// ============================================================================
+// Result verification
+// ============================================================================
+// Freivalds' check projected on both sides: with random vectors s (M) and
+// r (N), C = A * B implies s^T C r == (s^T A) (B r). Each side costs
+// O(MN + MK + KN) instead of the O(MNK) of recomputing C. Arithmetic is
+// mod the prime 2^31 - 1, so by Schwartz-Zippel a wrong C passes one round
+// with probability below 2^-29 (an error that is itself a multiple of the
+// prime would pass, which no bit flip or dropped tile is). s and r are
+// regenerated from their seeds on each pass rather than stored, so the only
+// workspace is the two K chunks of s^T A and B r held in scratch.
+
+#define GEMM_VERIFY_P      0x7FFFFFFFu  // 2^31 - 1
+#define GEMM_VERIFY_CHUNK  (GEMM_SCRATCH_BYTES / (2 * sizeof(uint64_t)))
+
+static int      gemm_verify_rounds;
+static uint32_t gemm_verify_state = 0x2545F491u;
+
+static inline uint32_t gemm_xorshift(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Partial reduction: keeps a sum of a few 62-bit products from overflowing
+static inline uint64_t gemm_fold(uint64_t x) {
+    return (x & GEMM_VERIFY_P) + (x >> 31);
+}
+
+static inline uint64_t gemm_mod_p(uint64_t x) {
+    x = gemm_fold(gemm_fold(x));
+    return x >= GEMM_VERIFY_P ? x - GEMM_VERIFY_P : x;
+}
+
+// Next random coefficient in [0, 2^31)
+static inline uint32_t gemm_coef(uint32_t *state) {
+    *state = gemm_xorshift(*state);
+    return *state >> 1;
+}
+
+// s^T C r, one row of C at a time (INT32 lifted to [0, 3p))
+static uint64_t gemm_verify_lhs(int m, int n, const int32_t *c, int ldc,
+                                uint32_t seed_s, uint32_t seed_r) {
+    uint64_t lhs = 0;
+    uint32_t s_state = seed_s;
+    for (int i = 0; i < m; i++) {
+        const int32_t *row = c + (size_t)i * ldc;
+        uint64_t dot = 0;
+        uint32_t r_state = seed_r;
+        for (int j = 0; j < n; j++) {
+            uint64_t x = (uint64_t)((int64_t)row[j] + 2 * (int64_t)GEMM_VERIFY_P);
+            dot = gemm_fold(dot + gemm_fold(x) * gemm_coef(&r_state));
+        }
+        lhs = gemm_fold(lhs + gemm_mod_p(dot) * gemm_coef(&s_state));
+    }
+    return lhs;
+}
+
+static int gemm_verify_one(int trans_a, int trans_b, int m, int n, int k,
+                           const int8_t *a, int lda, const int8_t *b, int ldb,
+                           const int32_t *c, int ldc, int rounds, uint64_t *work) {
+    uint64_t *sa = work, *br = work + GEMM_VERIFY_CHUNK;
+
+    for (int round = 0; round < rounds; round++) {
+        uint32_t seed_s = gemm_verify_state = gemm_xorshift(gemm_verify_state);
+        uint32_t seed_r = gemm_verify_state = gemm_xorshift(gemm_verify_state);
+        uint64_t lhs = gemm_verify_lhs(m, n, c, ldc, seed_s, seed_r);
+        uint32_t s_state;
+
+        // (s^T A) . (B r), one K chunk at a time (INT8 lifted by p)
+        uint64_t rhs = 0;
+        for (int k0 = 0; k0 < k; k0 += GEMM_VERIFY_CHUNK) {
+            int kc = k - k0 < (int)GEMM_VERIFY_CHUNK ? k - k0 : (int)GEMM_VERIFY_CHUNK;
+            memset(work, 0, 2 * GEMM_VERIFY_CHUNK * sizeof(uint64_t));
+
+            s_state = seed_s;
+            for (int i = 0; i < m; i++) {
+                uint64_t s = gemm_coef(&s_state);
+                for (int q = 0; q < kc; q++) {
+                    int8_t x = trans_a ? a[(size_t)(k0 + q) * lda + i] : a[(size_t)i * lda + k0 + q];
+                    sa[q] = gemm_fold(sa[q] + s * (uint64_t)(x + (int64_t)GEMM_VERIFY_P));
+                }
+            }
+            uint32_t r_state = seed_r;
+            for (int j = 0; j < n; j++) {
+                uint64_t r = gemm_coef(&r_state);
+                for (int q = 0; q < kc; q++) {
+                    int8_t y = trans_b ? b[(size_t)j * ldb + k0 + q] : b[(size_t)(k0 + q) * ldb + j];
+                    br[q] = gemm_fold(br[q] + r * (uint64_t)(y + (int64_t)GEMM_VERIFY_P));
+                }
+            }
+            for (int q = 0; q < kc; q++) {
+                rhs = gemm_fold(rhs + gemm_mod_p(sa[q]) * gemm_mod_p(br[q]));
+            }
+        }
+
+        if (gemm_mod_p(lhs) != gemm_mod_p(rhs)) {
+            return GEMM_ERR_VERIFY;
+        }
+    }
+    return GEMM_OK;
+}
+
+int gemm_verify(int trans_a, int trans_b, int m, int n, int k,
+                const int8_t *a, int lda, size_t stride_a,
+                const int8_t *b, int ldb, size_t stride_b,
+                const int32_t *c, int ldc, size_t stride_c,
+                int batch, int rounds, void *scratch) {
+    if (m <= 0 || n <= 0 || k <= 0 || batch <= 0 || rounds <= 0 || !a || !b || !c || !scratch ||
+        lda < (trans_a ? m : k) || ldb < (trans_b ? k : n) || ldc < n ||
+        ((uintptr_t)scratch % sizeof(uint64_t)) != 0) {
+        return GEMM_ERR_ARG;
+    }
+    for (int h = 0; h < batch; h++) {
+        int rc = gemm_verify_one(trans_a, trans_b, m, n, k, a + h * stride_a, lda,
+                                 b + h * stride_b, ldb, c + h * stride_c, ldc,
+                                 rounds, (uint64_t *)scratch);
+        if (rc != GEMM_OK) {
+            return rc;
+        }
+    }
+    return GEMM_OK;
+}
+
+void gemm_set_verify(int rounds) {
+    gemm_verify_rounds = rounds > 0 ? rounds : 0;
+}
+
+// With the weights fixed, B r is the expensive half of every round (K * N
+// products) and does not depend on the activations, so it is computed once
+// per weight matrix. r stays fixed for the key's lifetime while s is drawn
+// fresh on every check: a fault does not depend on r, so E r is nonzero
+// with the same probability as before and s catches it as before. The
+// check is then s^T C r against sum_i s_i (A_i . B r), or M * (N + K)
+// products per round.
+int gemm_verify_weights(int trans_b, int n, int k, const int8_t *b, int ldb,
+                        int rounds, uint32_t *br, gemm_verify_key_t *key) {
+    if (n <= 0 || k <= 0 || !b || !br || !key || ldb < (trans_b ? k : n) ||
+        rounds <= 0 || rounds > GEMM_VERIFY_MAX_ROUNDS) {
+        return GEMM_ERR_ARG;
+    }
+    key->n = n;
+    key->k = k;
+    key->rounds = rounds;
+    key->br = br;
+    for (int round = 0; round < rounds; round++) {
+        uint32_t seed_r = key->seed_r[round] = gemm_verify_state = gemm_xorshift(gemm_verify_state);
+        uint32_t *out = br + (size_t)round * k;
+        for (int q = 0; q < k; q++) {
+            out[q] = 0;
+        }
+        uint32_t r_state = seed_r;
+        for (int j = 0; j < n; j++) {
+            uint64_t r = gemm_coef(&r_state);
+            for (int q = 0; q < k; q++) {
+                int8_t y = trans_b ? b[(size_t)j * ldb + q] : b[(size_t)q * ldb + j];
+                out[q] = (uint32_t)gemm_mod_p(out[q] + r * (uint64_t)(y + (int64_t)GEMM_VERIFY_P));
+            }
+        }
+    }
+    return GEMM_OK;
+}
+
+int gemm_verify_check(int trans_a, int m, const int8_t *a, int lda,
+                      const gemm_verify_key_t *key, const int32_t *c, int ldc) {
+    if (m <= 0 || !a || !key || !key->br || !c ||
+        lda < (trans_a ? m : key->k) || ldc < key->n) {
+        return GEMM_ERR_ARG;
+    }
+    int n = key->n, k = key->k;
+    for (int round = 0; round < key->rounds; round++) {
+        uint32_t seed_s = gemm_verify_state = gemm_xorshift(gemm_verify_state);
+        uint64_t lhs = gemm_verify_lhs(m, n, c, ldc, seed_s, key->seed_r[round]);
+        const uint32_t *br = key->br + (size_t)round * k;
+
+        uint64_t rhs = 0;
+        uint32_t s_state = seed_s;
+        for (int i = 0; i < m; i++) {
+            uint64_t dot = 0;
+            for (int q = 0; q < k; q++) {
+                int8_t x = trans_a ? a[(size_t)q * lda + i] : a[(size_t)i * lda + q];
+                dot = gemm_fold(dot + (uint64_t)(x + (int64_t)GEMM_VERIFY_P) * br[q]);
+            }
+            rhs = gemm_fold(rhs + gemm_mod_p(dot) * gemm_coef(&s_state));
+        }
+
+        if (gemm_mod_p(lhs) != gemm_mod_p(rhs)) {
+            return GEMM_ERR_VERIFY;
+        }
+    }
+    return GEMM_OK;
+}
+
+// ============================================================================
+// Checksum-row fault tolerance (ABFT)
+// ============================================================================
+// B augmented with its row-sum column (b_sums = op(B) e) gives every row of
+// C an expected sum: sum_j C[i][j] == A_i . b_sums. The row check costs
+// M * K MACs and M * N adds, i.e. 1/N + 1/K of the GEMM. A row that fails
+// is recomputed on the CPU; comparing it with C both locates and corrects
+// the corrupted outputs (the column check of full ABFT, run only for the
+// failing row). Sums are mod 2^32 like C itself, so any single corrupted
+// element always fails its row.
+
+int gemm_abft_weight_sums(int trans_b, int n, int k, const int8_t *b, int ldb, int32_t *b_sums) {
+    if (n <= 0 || k <= 0 || !b || !b_sums || ldb < (trans_b ? k : n)) {
+        return GEMM_ERR_ARG;
+    }
+    for (int q = 0; q < k; q++) {
+        b_sums[q] = 0;
+    }
+    for (int j = 0; j < n; j++) {
+        for (int q = 0; q < k; q++) {
+            b_sums[q] += trans_b ? b[(size_t)j * ldb + q] : b[(size_t)q * ldb + j];
+        }
+    }
+    return GEMM_OK;
+}
+
+int gemm_abft_check(int trans_a, int trans_b, int m, int n, int k,
+                    const int8_t *a, int lda, const int8_t *b, int ldb,
+                    const int32_t *b_sums, int32_t *c, int ldc, gemm_abft_t *report) {
+    if (m <= 0 || n <= 0 || k <= 0 || !a || !b || !b_sums || !c ||
+        lda < (trans_a ? m : k) || ldb < (trans_b ? k : n) || ldc < n) {
+        return GEMM_ERR_ARG;
+    }
+    gemm_abft_t r = { 0, 0, -1, -1 };
+
+    for (int i = 0; i < m; i++) {
+        int32_t *row = c + (size_t)i * ldc;
+        uint32_t expect = 0, sum = 0;
+        for (int q = 0; q < k; q++) {
+            int8_t x = trans_a ? a[(size_t)q * lda + i] : a[(size_t)i * lda + q];
+            expect += (uint32_t)(int32_t)x * (uint32_t)b_sums[q];
+        }
+        for (int j = 0; j < n; j++) {
+            sum += (uint32_t)row[j];
+        }
+        if (sum == expect) {
+            continue;
+        }
+
+        // Past the limit the fault is systemic: count it, leave C to the caller
+        if (++r.bad_rows > GEMM_ABFT_MAX_ROWS) {
+            continue;
+        }
+        for (int j = 0; j < n; j++) {
+            int32_t v = 0;
+            for (int q = 0; q < k; q++) {
+                int8_t x = trans_a ? a[(size_t)q * lda + i] : a[(size_t)i * lda + q];
+                int8_t y = trans_b ? b[(size_t)j * ldb + q] : b[(size_t)q * ldb + j];
+                v += (int32_t)x * y;
+            }
+            if (row[j] != v) {
+                if (r.fixed++ == 0) {
+                    r.row = i;
+                    r.col = j;
+                }
+                row[j] = v;
+            }
+        }
+    }
+
+    if (report) {
+        *report = r;
+    }
+    return r.bad_rows > GEMM_ABFT_MAX_ROWS ? GEMM_ERR_VERIFY : GEMM_OK;
+}
+
+int gemm_int8_abft(int trans_a, int trans_b, int m, int n, int k,
+                   const int8_t *a, int lda, const int8_t *b, int ldb, const int32_t *b_sums,
+                   int32_t *c, int ldc, void *scratch, gemm_abft_t *report) {
+    if (!b_sums) {
+        return GEMM_ERR_ARG;
+    }
+    int rc = gemm_int8(trans_a, trans_b, m, n, k, a, lda, b, ldb, c, ldc, scratch);
+    if (rc != GEMM_OK) {
+        return rc;
+    }
+    return gemm_abft_check(trans_a, trans_b, m, n, k, a, lda, b, ldb, b_sums, c, ldc, report);
+}
+
+// ============================================================================
+// Strategy table
+// ============================================================================
+// Shapes found by gemm_autotune() run with their measured best strategy;
+// everything else uses the accelerator with the planner and the global
+// knobs. Lookup is a linear scan of at most GEMM_TUNE_MAX entries.
+
+static gemm_tune_entry_t gemm_tune_table[GEMM_TUNE_MAX];
+static int               gemm_tune_count;
+
+static uint32_t gemm_tune_checksum(const uint32_t *words, size_t n) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum = (sum << 1 | sum >> 31) ^ words[i];
+    }
+    return sum;
+}
+
+static int gemm_tune_flags(int trans_a, int trans_b, int shared_b) {
+    return (trans_a ? GEMM_TUNE_TRANS_A : 0) | (trans_b ? GEMM_TUNE_TRANS_B : 0) |
+           (shared_b ? GEMM_TUNE_SHARED_B : 0);
+}
+
+static gemm_tune_entry_t *gemm_tune_find(int flags, int m, int n, int k, int batch) {
+    for (int i = 0; i < gemm_tune_count; i++) {
+        gemm_tune_entry_t *e = &gemm_tune_table[i];
+        if (e->m == m && e->n == n && e->k == k && e->batch == batch && e->flags == flags) {
+            return e;
+        }
+    }
+    return 0;
+}
+
+int gemm_tune_load(const uint32_t *words, size_t n_words) {
+    if (!words || n_words < 3 || words[0] != GEMM_TUNE_MAGIC ||
+        (words[1] & 0xFF) != GEMM_TUNE_VERSION) {
+        return GEMM_ERR_ARG;
+    }
+    // Tile size in bits 8..15, 0 for tables saved before it was recorded (16)
+    int tile = (int)(words[1] >> 8 & 0xFF);
+    if ((tile ? tile : 16) != GEMM_TILE) {
+        return GEMM_ERR_ARG;
+    }
+    size_t count = words[1] >> 16;
+    size_t entry_words = sizeof(gemm_tune_entry_t) / sizeof(uint32_t);
+    if (count > GEMM_TUNE_MAX || n_words < 3 + count * entry_words ||
+        words[2 + count * entry_words] != gemm_tune_checksum(words + 2, count * entry_words)) {
+        return GEMM_ERR_ARG;
+    }
+    memcpy(gemm_tune_table, words + 2, count * sizeof(gemm_tune_entry_t));
+    gemm_tune_count = (int)count;
+    return (int)count;
+}
+
+size_t gemm_tune_save(uint32_t *words, size_t max_words) {
+    size_t entry_words = sizeof(gemm_tune_entry_t) / sizeof(uint32_t);
+    size_t n_words = 3 + gemm_tune_count * entry_words;
+    if (!words || max_words < n_words) {
+        return 0;
+    }
+    words[0] = GEMM_TUNE_MAGIC;
+    words[1] = GEMM_TUNE_VERSION | (uint32_t)GEMM_TILE << 8 | (uint32_t)gemm_tune_count << 16;
+    memcpy(words + 2, gemm_tune_table, gemm_tune_count * sizeof(gemm_tune_entry_t));
+    words[n_words - 1] = gemm_tune_checksum(words + 2, gemm_tune_count * entry_words);
+    return n_words;
+}
+
+void gemm_tune_clear(void) {
+    gemm_tune_count = 0;
+}
+
+// Plain CPU GEMM: wins for shapes too small to amortize launch overhead
+static void gemm_int8_cpu(int trans_a, int trans_b, int m, int n, int k,
+                          const int8_t *a, int lda, size_t stride_a,
+                          const int8_t *b, int ldb, size_t stride_b,
+                          int32_t *c, int ldc, size_t stride_c, int batch) {
+    for (int h = 0; h < batch; h++) {
+        const int8_t *a_h = a + h * stride_a, *b_h = b + h * stride_b;
+        int32_t *c_h = c + h * stride_c;
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                int32_t sum = 0;
+                for (int q = 0; q < k; q++) {
+                    int8_t x = trans_a ? a_h[(size_t)q * lda + i] : a_h[(size_t)i * lda + q];
+                    int8_t y = trans_b ? b_h[(size_t)j * ldb + q] : b_h[(size_t)q * ldb + j];
+                    sum += (int32_t)x * y;
+                }
+                c_h[(size_t)i * ldc + j] = sum;
+            }
+        }
+    }
+}
+
+// Run one call with an explicit strategy (arguments already validated)
+static int gemm_execute(const gemm_tune_entry_t *how, int trans_a, int trans_b, int m, int n, int k,
+                        const int8_t *a, int lda, size_t stride_a,
+                        const int8_t *b, int ldb, size_t stride_b,
+                        int32_t *c, int ldc, size_t stride_c,
+                        int batch, void *scratch) {
+    if (how->backend == GEMM_BACKEND_CPU) {
+        gemm_int8_cpu(trans_a, trans_b, m, n, k, a, lda, stride_a, b, ldb, stride_b,
+                      c, ldc, stride_c, batch);
+        return GEMM_OK;
+    }
+
+    gemm_plan_for(trans_a, m, n, k, batch, stride_b == 0 && batch > 1,
+                  how->panel, how->reuse, &gemm_plan_used);
+
+    // Registers reset to dense (0); force the first launch to program them
+    gemm_cfg_t cfg = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+    int rc = gemm_int8_tiles(trans_a, trans_b, m, n, k, a, lda, stride_a, b, ldb, stride_b,
+                             c, ldc, stride_c, batch, how->reuse, gemm_plan_used.panel * GEMM_TILE,
+                             scratch, &cfg);
+
+    // Leave the accelerator dense for gemm_run_tile() and the firmware tests
+    gemm_set_cfg(&cfg, 0, 0, 0, 0);
+    return rc;
+}
+
+int gemm_int8_batched(int trans_a, int trans_b, int m, int n, int k,
+                      const int8_t *a, int lda, size_t stride_a,
+                      const int8_t *b, int ldb, size_t stride_b,
+                      int32_t *c, int ldc, size_t stride_c,
+                      int batch, void *scratch) {
+    if (m <= 0 || n <= 0 || k <= 0 || batch <= 0 || !a || !b || !c || !scratch ||
+        lda < (trans_a ? m : k) || ldb < (trans_b ? k : n) || ldc < n ||
+        ((uintptr_t)scratch % GEMM_ALIGN) != 0) {
+        return GEMM_ERR_ARG;
+    }
+
+    // A tuned shape runs its stored strategy; the global knobs apply otherwise
+    gemm_tune_entry_t how = { 0, 0, 0, 0, 0, GEMM_BACKEND_ACC, 0, 0, 0 };
+    const gemm_tune_entry_t *tuned =
+        gemm_tune_find(gemm_tune_flags(trans_a, trans_b, stride_b == 0 && batch > 1), m, n, k, batch);
+    if (tuned) {
+        how = *tuned;
+    } else {
+        how.panel = (uint8_t)(gemm_forced_panel < 255 ? gemm_forced_panel : 255);
+        how.reuse = (uint8_t)gemm_reuse_weights;
+    }
+    int rc = gemm_execute(&how, trans_a, trans_b, m, n, k, a, lda, stride_a, b, ldb, stride_b,
+                          c, ldc, stride_c, batch, scratch);
+
+    // Scratch is free again once the last tile is summed
+    if (rc == GEMM_OK && gemm_verify_rounds > 0 && how.backend == GEMM_BACKEND_ACC) {
+        rc = gemm_verify(trans_a, trans_b, m, n, k, a, lda, stride_a, b, ldb, stride_b,
+                         c, ldc, stride_c, batch, gemm_verify_rounds, scratch);
+    }
+    return rc;
+}
+
+int gemm_int8(int trans_a, int trans_b, int m, int n, int k,
+              const int8_t *a, int lda, const int8_t *b, int ldb,
+              int32_t *c, int ldc, void *scratch) {
+    return gemm_int8_batched(trans_a, trans_b, m, n, k, a, lda, 0, b, ldb, 0,
+                             c, ldc, 0, 1, scratch);
+}
+
+int gemm_autotune(int trans_a, int trans_b, int m, int n, int k,
+                  const int8_t *a, int lda, size_t stride_a,
+                  const int8_t *b, int ldb, size_t stride_b,
+                  int32_t *c, int ldc, size_t stride_c,
+                  int batch, void *scratch, gemm_tune_result_t *result) {
+    if (m <= 0 || n <= 0 || k <= 0 || batch <= 0 || batch > 255 ||
+        m > 0xFFFF || n > 0xFFFF || k > 0xFFFF || !result ||
+        !a || !b || !c || !scratch ||
+        lda < (trans_a ? m : k) || ldb < (trans_b ? k : n) || ldc < n ||
+        ((uintptr_t)scratch % GEMM_ALIGN) != 0) {
+        return GEMM_ERR_ARG;
+    }
+
+    int shared_b = stride_b == 0 && batch > 1;
+    int flags = gemm_tune_flags(trans_a, trans_b, shared_b);
+    gemm_tune_entry_t *slot = gemm_tune_find(flags, m, n, k, batch);
+    if (!slot && gemm_tune_count == GEMM_TUNE_MAX) {
+        return GEMM_ERR_ARG;
+    }
+
+    // Candidates: the planner's choice (always first, the untuned default),
+    // panel heights 1 .. full, each with weight reuse on and off, and the
+    // CPU when the shape is small enough to be worth timing
+    gemm_tune_entry_t cand[2 * 9 + 1];
+    int n_cand = 0, mt = gemm_tiles(m);
+    for (int reuse = 1; reuse >= 0; reuse--) {
+        cand[n_cand++] = (gemm_tune_entry_t){ 0, 0, 0, 0, 0, GEMM_BACKEND_ACC, 0, (uint8_t)reuse, 0 };
+        for (int panel = 1; panel < mt && panel < 256; panel *= 2) {
+            cand[n_cand++] = (gemm_tune_entry_t){ 0, 0, 0, 0, 0, GEMM_BACKEND_ACC, (uint8_t)panel, (uint8_t)reuse, 0 };
+        }
+    }
+    if ((uint64_t)m * n * k * batch <= GEMM_TUNE_CPU_MAX_MACS) {
+        cand[n_cand++] = (gemm_tune_entry_t){ 0, 0, 0, 0, 0, GEMM_BACKEND_CPU, 0, 0, 0 };
+    }
+
+    // Each candidate runs once untimed, so none is measured with caches
+    // still holding the previous candidate's working set, then is timed
+    // GEMM_TUNE_REPEATS times and scored by the median
+    result->candidates = 0;
+    for (int i = 0; i < n_cand; i++) {
+        unsigned long samples[GEMM_TUNE_REPEATS];
+        for (int rep = -1; rep < GEMM_TUNE_REPEATS; rep++) {
+            unsigned long t = get_cycles();
+            int rc = gemm_execute(&cand[i], trans_a, trans_b, m, n, k, a, lda, stride_a, b, ldb, stride_b,
+                                  c, ldc, stride_c, batch, scratch);
+            t = get_cycles() - t;
+            if (rc != GEMM_OK) {
+                return rc;
+            }
+            if (rep >= 0) {
+                // Insertion keeps samples[0..rep] sorted
+                int j = rep;
+                while (j > 0 && samples[j - 1] > t) {
+                    samples[j] = samples[j - 1];
+                    j--;
+                }
+                samples[j] = t;
+            }
+        }
+        unsigned long t = samples[GEMM_TUNE_REPEATS / 2];
+        if (i == 0) {
+            result->default_cycles = t;
+        }
+        if (i == 0 || t < result->best_cycles) {
+            result->best = cand[i];
+            result->best_cycles = t;
+        }
+        result->candidates++;
+    }
+
+    // A planner win is stored as the panel it chose, so dispatch skips planning
+    if (result->best.backend == GEMM_BACKEND_ACC && result->best.panel == 0) {
+        gemm_plan_for(trans_a, m, n, k, batch, shared_b, 0, result->best.reuse, &gemm_plan_used);
+        result->best.panel = (uint8_t)(gemm_plan_used.panel < 255 ? gemm_plan_used.panel : 255);
+    }
+    result->best.m = (uint16_t)m;
+    result->best.n = (uint16_t)n;
+    result->best.k = (uint16_t)k;
+    result->best.batch = (uint8_t)batch;
+    result->best.flags = (uint8_t)flags;
+
+    if (!slot) {
+        slot = &gemm_tune_table[gemm_tune_count++];
+    }
+    *slot = result->best;
+    return GEMM_OK;
+}
+
+int gemm_int8_gemv(int trans_w, int batch, int n, int k,
+                   const int8_t *x, int ldx, const int8_t *w, int ldw,
+                   int32_t *y, int ldy, void *scratch) {
+    if (batch < 1 || batch > GEMM_TILE) {
+        return GEMM_ERR_ARG;
+    }
+    // One row block: every launch is a short tile of batch rows
+    return gemm_int8(0, trans_w, batch, n, k, x, ldx, w, ldw, y, ldy, scratch);
+}
@@ -0,0 +1,520 @@
+// gemm_offload.h - INT8 GEMM offload API for the Gemma accelerator
+//
+// Large row-major (or column-major) matrices are split into GEMM_TILE x
+// GEMM_TILE tiles (16x16 or 32x32, whichever array is loaded) and run
+// through the accelerator one tile product at a time. The accelerator
+// fetches each operand as contiguous 128-bit beats, so this API keeps
+// operands in a tile-major "panel" layout: every tile is one contiguous,
+// 16-byte aligned block (256 bytes at 16x16) that the accelerator can read
+// in a single burst without any per-call gather.
+//
+// The firmware linking this file provides the platform hooks declared at the
+// bottom (register access, cycle counter, cache maintenance); benchmark.c
+// implements them for the VEGA AT1051.
+
+#ifndef GEMM_OFFLOAD_H
+#define GEMM_OFFLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Accelerator tile geometry. The tile edge is ARRAY_SIZE of the loaded
+// bitstream, read from ACC_ID by gemm_open(); it is 16 until then.
+extern int gemm_tile_size;
+
+#define GEMM_TILE            gemm_tile_size
+#define GEMM_TILE_MAX        64                                         // Largest tile this library drives
+#define GEMM_TILE_BYTES      (GEMM_TILE * GEMM_TILE)                    // INT8 operand tile
+#define GEMM_TILE_C_BYTES    (GEMM_TILE * GEMM_TILE * sizeof(int32_t))  // INT32 result tile
+#define GEMM_ALIGN           16                                         // One AXI beat
+#define GEMM_C_ROW_ALIGN     (GEMM_TILE * 4)                            // One C tile row (64 bytes at 16x16)
+#define GEMM_SCRATCH_BYTES   (2 * GEMM_TILE_MAX * GEMM_TILE_MAX * (1 + sizeof(int32_t)))  // gemm_int8() workspace, any tile
+
+// Accelerator register map (see gemma_accelerator.v)
+#define GEMM_ACC_BASE        0x20060000
+#define GEMM_REG_CTRL        (GEMM_ACC_BASE + 0x00)  // W: bit0 start, bit1 preload, bit4/5 trans, bit6 reuse, bit7 pin
+                                                     // R: bit0 done, bit1 busy, bit2 axi_error,
+                                                     //    bit3 ring error, bit7 ring not empty
+#define GEMM_REG_INT_GIE     (GEMM_ACC_BASE + 0x04)  // Completion interrupt (ACC_ID version 3): bit0 global enable
+#define GEMM_REG_INT_ENABLE  (GEMM_ACC_BASE + 0x08)  // GEMM_INT_* sources driving the interrupt line
+#define GEMM_REG_INT_STATUS  (GEMM_ACC_BASE + 0x0C)  // R: GEMM_INT_* pending / W: 1 clears
+#define GEMM_REG_A_LSB       (GEMM_ACC_BASE + 0x10)
+#define GEMM_REG_A_MSB       (GEMM_ACC_BASE + 0x14)
+#define GEMM_REG_B_LSB       (GEMM_ACC_BASE + 0x1C)
+#define GEMM_REG_B_MSB       (GEMM_ACC_BASE + 0x20)
+#define GEMM_REG_C_LSB       (GEMM_ACC_BASE + 0x28)
+#define GEMM_REG_C_MSB       (GEMM_ACC_BASE + 0x2C)
+#define GEMM_REG_LDA         (GEMM_ACC_BASE + 0x54)  // Row pitches in bytes, 0 = dense
+#define GEMM_REG_LDB         (GEMM_ACC_BASE + 0x58)
+#define GEMM_REG_LDC         (GEMM_ACC_BASE + 0x5C)
+#define GEMM_REG_ROWS        (GEMM_ACC_BASE + 0x60)  // Valid A/C rows, 0 = full tile
+#define GEMM_REG_PERF_ACT_BEATS (GEMM_ACC_BASE + 0x64)  // Free-running AXI beat counters
+#define GEMM_REG_PERF_WGT_BEATS (GEMM_ACC_BASE + 0x68)
+#define GEMM_REG_PERF_OUT_BEATS (GEMM_ACC_BASE + 0x6C)
+#define GEMM_REG_PERF_WGT_REUSE (GEMM_ACC_BASE + 0x70)  // Launches that skipped the B fetch
+#define GEMM_REG_WCACHE_CTRL    (GEMM_ACC_BASE + 0x74)  // W: GEMM_WCACHE_* / R: number of cache slots
+#define GEMM_REG_WCACHE_HITS    (GEMM_ACC_BASE + 0x78)
+#define GEMM_REG_WCACHE_MISSES  (GEMM_ACC_BASE + 0x7C)
+#define GEMM_REG_ACC_ID         (GEMM_ACC_BASE + 0x80)  // R: GEMM_ID_* fields
+#define GEMM_REG_RING_BASE_LO   (GEMM_ACC_BASE + 0x84)  // Descriptor ring (ACC_ID version 2)
+#define GEMM_REG_RING_BASE_HI   (GEMM_ACC_BASE + 0x88)
+#define GEMM_REG_RING_SIZE      (GEMM_ACC_BASE + 0x8C)  // Entries; a write also resets HEAD and TAIL
+#define GEMM_REG_RING_TAIL      (GEMM_ACC_BASE + 0x90)  // Doorbell, accepted while busy
+#define GEMM_REG_RING_HEAD      (GEMM_ACC_BASE + 0x94)  // R: next entry to complete
+#define GEMM_REG_RING_WB_LO     (GEMM_ACC_BASE + 0x98)  // HEAD is written here after every entry
+#define GEMM_REG_RING_WB_HI     (GEMM_ACC_BASE + 0x9C)
+
+#define GEMM_CTRL_START      0x01
+#define GEMM_CTRL_PRELOAD_B  0x02  // Only fetch B into the weight cache (no A, compute or C)
+#define GEMM_CTRL_TRANS_A    0x10  // A tile is stored transposed (K x M)
+#define GEMM_CTRL_TRANS_B    0x20  // B tile is stored transposed (N x K)
+#define GEMM_CTRL_REUSE_B    0x40  // Take B from the resident tile or weight cache if address/pitch match
+#define GEMM_CTRL_PIN_B      0x80  // Pin this launch's B tile in the weight cache
+
+#define GEMM_INT_DONE        0x1  // A launch or ring entry completed
+#define GEMM_INT_RING        0x2  // The ring drained (HEAD reached TAIL, after the HEAD write-back)
+#define GEMM_INT_ERROR       0x4  // A launch saw a non-OKAY response
+
+#define GEMM_WCACHE_INVALIDATE     0x1  // Drop every cached tile, including pinned ones
+#define GEMM_WCACHE_UNPIN          0x2  // Make pinned tiles evictable again
+#define GEMM_WCACHE_DROP_UNPINNED  0x4  // Drop every tile that is not pinned
+
+// ACC_ID: {signature, ARRAY_SIZE, weight cache slots, version, 2'b0, ASYNC_COMPUTE, DUAL_MAC}.
+// Bitstreams older than the register read 0xDEADBEEF there (16x16, no ID);
+// gemm_open() rejects them, as they ignore the stride and cache registers.
+#define GEMM_ID_SIGNATURE(id)  ((id) >> 24)
+#define GEMM_ID_SIZE(id)       (((id) >> 16) & 0xFF)
+#define GEMM_ID_WC_SLOTS(id)   (((id) >> 8) & 0xFF)
+#define GEMM_ID_VERSION(id)    (((id) >> 4) & 0xF)
+#define GEMM_ID_DUAL_MAC       0x1
+#define GEMM_ID_ASYNC_COMPUTE  0x2   // Array on its own clock
+#define GEMM_ID_MAGIC          0x47  // 'G'
+#define GEMM_ID_LEGACY         0xDEADBEEFu  // Whole word of a pre-ACC_ID 16x16 build
+#define GEMM_ID_VERSION_RING   2     // First version with the descriptor ring
+#define GEMM_ID_VERSION_IRQ    3     // First version with the completion interrupt
+
+#define GEMM_STATUS_DONE     0x1
+#define GEMM_STATUS_BUSY     0x2
+#define GEMM_STATUS_ERROR    0x4
+#define GEMM_STATUS_RING_ERROR   0x8   // A ring entry saw an AXI error since RING_SIZE was written
+#define GEMM_STATUS_REUSED   0x40  // Last run used the resident weight tile
+#define GEMM_STATUS_RING_PENDING 0x80  // RING_HEAD != RING_TAIL
+
+#define GEMM_TIMEOUT_POLLS   100000
+
+#ifndef GEMM_CPU_CACHE_BYTES
+#define GEMM_CPU_CACHE_BYTES (32 * 1024)  // VEGA AT1051 L1 D-cache, for traversal planning
+#endif
+
+// Return codes
+#define GEMM_OK              0
+#define GEMM_ERR_TIMEOUT     -1
+#define GEMM_ERR_ARG         -2
+#define GEMM_ERR_AXI         -7   // Same value benchmark.c uses for STATUS.axi_error
+#define GEMM_ERR_VERIFY      -8   // Result failed gemm_verify()
+#define GEMM_ERR_NODEV       -9   // ACC_ID reports a geometry this library cannot drive
+
+// ---------------------------------------------------------------------------
+// Capability discovery
+// ---------------------------------------------------------------------------
+// gemm_open() reads ACC_ID once at startup and sizes GEMM_TILE, the planner
+// and the weight cache model to the loaded bitstream, so the same firmware
+// runs the 16x16 and 32x32 builds with full tiles. Call it before packing
+// panels or loading a tune table: panels and tables are laid out for one
+// tile size. Without gemm_open() the library assumes a 16x16 array with no
+// weight cache.
+typedef struct {
+    int      tile;        // Array edge = GEMM_TILE
+    int      wc_slots;    // Weight cache tiles
+    int      dual_mac;    // pe_int8x2 pairs (experimental)
+    int      async_compute;  // Array clocked apart from the AXI interface
+    int      version;     // ACC_ID layout version
+    uint32_t id;          // Raw ACC_ID
+} gemm_caps_t;
+
+int                gemm_open(void);  // GEMM_OK, or GEMM_ERR_NODEV for a legacy or foreign ID (GEMM_TILE stays 16)
+const gemm_caps_t *gemm_caps(void);
+
+// ---------------------------------------------------------------------------
+// Tile-major packed panels
+// ---------------------------------------------------------------------------
+// A rows x cols INT8 matrix is stored as tiles_r x tiles_c tiles, ordered
+// row of tiles by row of tiles (tile (tr, tc) at index tr * tiles_c + tc).
+// Each tile is row-major inside, which is the layout the accelerator expects
+// for both A (one activation row per beat) and B (one weight row per beat).
+// Edge tiles are zero padded, so a partial tile contributes nothing.
+//
+// A panel may carry a nonzero bitmap, bit tr * tiles_c + tc set when tile
+// (tr, tc) holds a nonzero element. gemm_int8_panels() skips every tile
+// product with an all-zero operand tile (ReLU activations, pruned weights):
+// no launch, no operand traffic, and a C block whose products are all zero
+// is written as zeros. Without a bitmap every tile counts as nonzero.
+typedef struct {
+    int8_t   *data;   // GEMM_ALIGN aligned, gemm_panel_bytes(rows, cols) long
+    int       rows;
+    int       cols;
+    int       tiles_r;
+    int       tiles_c;
+    uint32_t *nz;     // Nonzero bitmap, gemm_panel_nz_words() long, or NULL
+} gemm_panel_t;
+
+static inline int gemm_tiles(int n) {
+    return (n + GEMM_TILE - 1) / GEMM_TILE;
+}
+
+static inline size_t gemm_panel_bytes(int rows, int cols) {
+    return (size_t)gemm_tiles(rows) * gemm_tiles(cols) * GEMM_TILE_BYTES;
+}
+
+static inline int8_t *gemm_panel_tile(const gemm_panel_t *p, int tr, int tc) {
+    return p->data + ((size_t)tr * p->tiles_c + tc) * GEMM_TILE_BYTES;
+}
+
+static inline size_t gemm_panel_nz_words(int rows, int cols) {
+    return ((size_t)gemm_tiles(rows) * gemm_tiles(cols) + 31) / 32;
+}
+
+static inline int gemm_panel_tile_nz(const gemm_panel_t *p, int tr, int tc) {
+    size_t i = (size_t)tr * p->tiles_c + tc;
+    return !p->nz || ((p->nz[i / 32] >> (i % 32)) & 1);
+}
+
+// Bind caller-provided storage (gemm_panel_bytes() long, GEMM_ALIGN aligned)
+int gemm_panel_init(gemm_panel_t *p, int8_t *storage, int rows, int cols);
+
+// Bind a nonzero bitmap (NULL: none). The packers and gemm_quantize_rowmajor()
+// fill a bound bitmap as they write tiles, so weights get theirs once at pack
+// time and activations while they are quantized. After writing tiles any
+// other way, call gemm_panel_scan_nz().
+void gemm_panel_set_nz(gemm_panel_t *p, uint32_t *nz);
+void gemm_panel_scan_nz(gemm_panel_t *p);
+
+// Pack from / unpack to a plain matrix with leading dimension ld (elements).
+// Row-major: element (r, c) at src[r * ld + c]. Column-major: src[c * ld + r].
+void gemm_pack_rowmajor(gemm_panel_t *p, const int8_t *src, int ld);
+void gemm_pack_colmajor(gemm_panel_t *p, const int8_t *src, int ld);
+void gemm_unpack_rowmajor(const gemm_panel_t *p, int8_t *dst, int ld);
+void gemm_unpack_colmajor(const gemm_panel_t *p, int8_t *dst, int ld);
+
+// Quantize a row-major float matrix into the panel: round(src * inv_scale),
+// saturated to INT8. A value that rounds to zero is zero, so a ReLU output
+// yields its zero tiles here without a second pass.
+void gemm_quantize_rowmajor(gemm_panel_t *p, const float *src, int ld, float inv_scale);
+
+// ---------------------------------------------------------------------------
+// GEMM
+// ---------------------------------------------------------------------------
+// C (M x N, INT32, row-major, leading dimension ldc) = A (M x K) * B (K x N)
+// from packed panels. c_scratch is one GEMM_TILE_C_BYTES, GEMM_ALIGN aligned
+// buffer the accelerator writes each tile product into. Tile products with a
+// zero tile on either side (per the panels' bitmaps) are not launched.
+int gemm_int8_panels(const gemm_panel_t *a, const gemm_panel_t *b,
+                     int32_t *c, int ldc, int32_t *c_scratch);
+
+// C (M x N, INT32) = op(A) (M x K) * op(B) (K x N), all row-major with
+// leading dimensions in elements, BLAS style. op(X) is X, or X^T when the
+// trans flag is set: a transposed A is stored K x M (lda >= m) and a
+// transposed B is stored N x K (ldb >= k), e.g. Q * K^T passes K as stored.
+// The accelerator transposes while feeding the array, so the host never
+// does. Tile-sized sub-blocks are read and written in place through the
+// accelerator's row-pitch registers, so no gather or scatter copies are made
+// when:
+//   A, B: base 16-byte aligned and lda/ldb multiples of 16
+//   C:    base GEMM_C_ROW_ALIGN aligned and ldc a multiple of GEMM_TILE
+// A row block shorter than GEMM_TILE (including M = 1) is run as a short tile:
+// the accelerator fetches only those A rows and writes only those C rows.
+// Ragged K/N edges and operands that miss the alignment are staged through
+// scratch (GEMM_SCRATCH_BYTES, GEMM_ALIGN aligned).
+int gemm_int8(int trans_a, int trans_b, int m, int n, int k,
+              const int8_t *a, int lda, const int8_t *b, int ldb,
+              int32_t *c, int ldc, void *scratch);
+
+// Strided-batched GEMM: for h in [0, batch), C_h = op(A_h) * op(B_h) with
+// X_h = x + h * stride_x (strides in elements; 0 broadcasts one operand,
+// e.g. a shared K/V head under multi-query attention). All entries' tiles
+// go through one submission, weight-stationary: for each weight tile the
+// A row blocks are innermost, so the accelerator keeps the weight tile
+// resident (CTRL reuse bit) and fetches only A for every launch after the
+// first. The CPU sums one launch's partial result while the next runs.
+int gemm_int8_batched(int trans_a, int trans_b, int m, int n, int k,
+                      const int8_t *a, int lda, size_t stride_a,
+                      const int8_t *b, int ldb, size_t stride_b,
+                      int32_t *c, int ldc, size_t stride_c,
+                      int batch, void *scratch);
+
+// Decode-step projection: y (batch x N) = x (batch x K) * op(W), for
+// 1 <= batch <= GEMM_TILE concurrent sequences packed into A's rows.
+// Linear-layer weights stored [out][in] (N x K) use trans_w = 1.
+// Each weight tile is streamed once per K step against the resident
+// activation rows; only batch rows of A and y cross the bus.
+int gemm_int8_gemv(int trans_w, int batch, int n, int k,
+                   const int8_t *x, int ldx, const int8_t *w, int ldw,
+                   int32_t *y, int ldy, void *scratch);
+
+// ---------------------------------------------------------------------------
+// Result verification
+// ---------------------------------------------------------------------------
+// Randomized (Freivalds) check that C == op(A) * op(B) for every batch
+// entry, in O(MN + MK + KN) per round instead of a full O(MNK) recompute.
+// Arguments as gemm_int8_batched(); scratch is GEMM_SCRATCH_BYTES, 8-byte
+// aligned. A wrong result passes one round with probability below 2^-29;
+// each round draws fresh random vectors. Returns GEMM_OK or GEMM_ERR_VERIFY.
+#define GEMM_VERIFY_ROUNDS   2   // Suggested rounds for an always-on check
+
+int  gemm_verify(int trans_a, int trans_b, int m, int n, int k,
+                 const int8_t *a, int lda, size_t stride_a,
+                 const int8_t *b, int ldb, size_t stride_b,
+                 const int32_t *c, int ldc, size_t stride_c,
+                 int batch, int rounds, void *scratch);
+
+// Check every accelerator result of gemm_int8*() with this many rounds
+// (0 = off, the default); a failing call returns GEMM_ERR_VERIFY. This
+// recomputes B r on every call (K * N products per round), which at decode
+// (M = 1) costs as much as the GEMM itself; use a weight key there.
+void gemm_set_verify(int rounds);
+
+// Freivalds check with B r precomputed once per weight matrix, the way
+// gemm_abft_weight_sums() precomputes b_sums. br is caller storage of
+// rounds * K words and must stay valid with the key. A check then costs
+// M * (N + K) products per round, e.g. about 2.2K instead of 1.2M for a
+// decode step of a 1152 -> 1024 projection. Recompute the key when the
+// weights change.
+#define GEMM_VERIFY_MAX_ROUNDS  4
+
+typedef struct {
+    int       n, k, rounds;
+    uint32_t  seed_r[GEMM_VERIFY_MAX_ROUNDS];
+    uint32_t *br;        // rounds x K: (op(B) r) mod p
+} gemm_verify_key_t;
+
+int gemm_verify_weights(int trans_b, int n, int k, const int8_t *b, int ldb,
+                        int rounds, uint32_t *br, gemm_verify_key_t *key);
+
+// Check C = op(A) * B for the key's weights. Returns GEMM_OK or GEMM_ERR_VERIFY.
+int gemm_verify_check(int trans_a, int m, const int8_t *a, int lda,
+                      const gemm_verify_key_t *key, const int32_t *c, int ldc);
+
+// ---------------------------------------------------------------------------
+// Algorithm-based fault tolerance
+// ---------------------------------------------------------------------------
+// Always-on protection for production GEMMs. The weights' row-sum column
+// b_sums (K entries, op(B) * ones) is computed once per weight matrix with
+// gemm_abft_weight_sums(); every result row is then checked against it for
+// about 1/N + 1/K of the GEMM's work. Failing rows are recomputed on the
+// CPU, which locates and corrects the corrupted outputs. More than
+// GEMM_ABFT_MAX_ROWS failing rows is treated as a systemic fault:
+// GEMM_ERR_VERIFY is returned and C is left for the caller to rerun.
+#define GEMM_ABFT_MAX_ROWS   4
+
+typedef struct {
+    int bad_rows;    // Rows whose checksum failed
+    int fixed;       // Outputs corrected
+    int row, col;    // First corrected output, -1 if none
+} gemm_abft_t;
+
+int gemm_abft_weight_sums(int trans_b, int n, int k, const int8_t *b, int ldb, int32_t *b_sums);
+
+// Check (and correct) C = op(A) * op(B) computed by any gemm_int8*() call.
+// report may be NULL.
+int gemm_abft_check(int trans_a, int trans_b, int m, int n, int k,
+                    const int8_t *a, int lda, const int8_t *b, int ldb,
+                    const int32_t *b_sums, int32_t *c, int ldc, gemm_abft_t *report);
+
+// gemm_int8() followed by gemm_abft_check()
+int gemm_int8_abft(int trans_a, int trans_b, int m, int n, int k,
+                   const int8_t *a, int lda, const int8_t *b, int ldb, const int32_t *b_sums,
+                   int32_t *c, int ldc, void *scratch, gemm_abft_t *report);
+
+// ---------------------------------------------------------------------------
+// Traversal planning
+// ---------------------------------------------------------------------------
+// gemm_int8() sweeps M in panels of `panel` row blocks; inside a panel it is
+// weight-stationary (row blocks innermost). panel = 1 is output-stationary
+// (M, N, K loop order): C blocks stay hot in the CPU cache while K is
+// summed, but every row block refetches B. A full-height panel is N, K, M:
+// each B tile is fetched once, but C is revisited only after a sweep of all
+// of M. Each call plans the panel from a DDR traffic model that knows the
+// accelerator's weight reuse and cache size and the CPU cache size.
+typedef struct {
+    int      panel;     // Row blocks per panel
+    uint64_t a_read;    // Predicted accelerator bytes (compare with gemm_counters_t beats * 16)
+    uint64_t b_read;
+    uint64_t c_write;
+    uint64_t c_cpu;     // Predicted CPU DDR bytes summing K steps into C (model only)
+} gemm_plan_t;
+
+static inline uint64_t gemm_plan_bytes(const gemm_plan_t *p) {
+    return p->a_read + p->b_read + p->c_write + p->c_cpu;
+}
+
+// Plan an M x N x K GEMM over batch entries (shared_b: one B for all).
+// Returns the lowest-traffic panel, or the forced one, with its prediction.
+int  gemm_plan(int trans_a, int m, int n, int k, int batch, int shared_b, gemm_plan_t *plan);
+void gemm_last_plan(gemm_plan_t *plan);      // Plan used by the last gemm_int8*() call
+void gemm_force_panel(int panel);            // Override the planner (0 = plan per call)
+void gemm_set_cpu_cache_bytes(size_t bytes); // Default GEMM_CPU_CACHE_BYTES
+
+// ---------------------------------------------------------------------------
+// Autotuning
+// ---------------------------------------------------------------------------
+// gemm_autotune() times every strategy for one call shape (accelerator at
+// each panel height with weight reuse on and off, and the CPU for small
+// shapes), each after one warm-up run and scored by the median of
+// GEMM_TUNE_REPEATS runs, keeps the fastest in a table, and later gemm_int8*() calls of
+// exactly that shape dispatch with a table lookup. The table is saved as a
+// compact checksummed word array (e.g. printed once and compiled into the
+// firmware, see gemm_tune_table.h) and loaded with gemm_tune_load() at
+// startup. Panel heights are in row blocks of the tuned array, so a table
+// records GEMM_TILE and is rejected on a bitstream with another size.
+#define GEMM_TUNE_MAX           32
+#define GEMM_TUNE_MAGIC         0x4E555447u  // "GTUN"
+#define GEMM_TUNE_VERSION       1
+#define GEMM_TUNE_CPU_MAX_MACS  (4UL * 1024 * 1024)  // Larger shapes never time the CPU
+#define GEMM_TUNE_REPEATS       5    // Timed runs per candidate (odd: the median is a sample)
+
+#define GEMM_TUNE_TRANS_A       0x1
+#define GEMM_TUNE_TRANS_B       0x2
+#define GEMM_TUNE_SHARED_B      0x4  // stride_b = 0 with batch > 1
+
+#define GEMM_BACKEND_ACC        0
+#define GEMM_BACKEND_CPU        1
+
+typedef struct {
+    uint16_t m, n, k;
+    uint8_t  batch;
+    uint8_t  flags;      // GEMM_TUNE_*
+    uint8_t  backend;    // GEMM_BACKEND_*
+    uint8_t  panel;      // Row blocks per panel, 0 = planner (255 = full height)
+    uint8_t  reuse;      // Weight reuse bit
+    uint8_t  reserved;
+} gemm_tune_entry_t;     // 12 bytes, 3 words in a saved table
+
+typedef struct {
+    gemm_tune_entry_t best;
+    unsigned long     best_cycles;     // Median of GEMM_TUNE_REPEATS runs
+    unsigned long     default_cycles;  // Untuned dispatch (planner, reuse on), median
+    int               candidates;
+} gemm_tune_result_t;
+
+// Same arguments as gemm_int8_batched(); C holds the last candidate's result.
+// Returns GEMM_ERR_ARG when the table is full.
+int    gemm_autotune(int trans_a, int trans_b, int m, int n, int k,
+                     const int8_t *a, int lda, size_t stride_a,
+                     const int8_t *b, int ldb, size_t stride_b,
+                     int32_t *c, int ldc, size_t stride_c,
+                     int batch, void *scratch, gemm_tune_result_t *result);
+int    gemm_tune_load(const uint32_t *words, size_t n_words);  // Entries loaded, or < 0
+size_t gemm_tune_save(uint32_t *words, size_t max_words);      // Words written, 0 if too small
+void   gemm_tune_clear(void);
+
+// Weight reuse is on by default; disabling it forces every launch to fetch
+// B (for A/B traffic comparisons with gemm_read_counters()). With reuse on,
+// a weight tile repeated within one call is taken from the accelerator's
+// on-chip weight cache instead of DDR.
+void gemm_set_weight_reuse(int enable);
+
+// Pin the GEMM_TILE tiles of op(B) (K x N, same arguments as gemm_int8()) in
+// the weight cache so later calls with these weights skip their DDR fetch,
+// e.g. one layer's weights across decode steps. B must be 16-byte aligned
+// with ldb a multiple of 16; ragged edge tiles are not pinned. Tiles are
+// pinned in gemm_int8()'s traversal order until the cache is full; returns
+// the number pinned or a negative error code.
+// Pinned tiles are trusted until unpinned: call gemm_invalidate_weights()
+// (or unpin and re-pin) before rewriting pinned weights in memory.
+int  gemm_pin_weights(int trans_b, int n, int k, const int8_t *b, int ldb);
+void gemm_unpin_weights(void);
+void gemm_invalidate_weights(void);
+
+// Snapshot of the accelerator's AXI beat counters. They are free-running
+// and wrap, so measure a region by subtracting two snapshots.
+typedef struct {
+    uint32_t act_beats;   // A read beats (16 bytes each)
+    uint32_t wgt_beats;   // B read beats
+    uint32_t out_beats;   // C write beats
+    uint32_t wgt_reuse;   // Launches that skipped the B fetch
+    uint32_t wc_hits;     // Reuse launches whose B tile was on chip
+    uint32_t wc_misses;   // Reuse launches that fetched B from memory
+} gemm_counters_t;
+
+void gemm_read_counters(gemm_counters_t *cnt);
+
+// Single GEMM_TILE^3 tile product on the accelerator: c = a * b.
+// a, b: GEMM_TILE_BYTES row-major tiles; c: GEMM_TILE_C_BYTES row-major INT32 tile.
+// Assumes dense pitches (the state gemm_int8() leaves the registers in).
+int gemm_run_tile(const int8_t *a, const int8_t *b, int32_t *c);
+
+// ---------------------------------------------------------------------------
+// Descriptor ring
+// ---------------------------------------------------------------------------
+// Launches queued in DDR instead of programmed over AXI-Lite: each entry
+// carries what a register launch would write, and the accelerator runs
+// entries back to back from one doorbell write. Entries are independent
+// launches (the array does not accumulate across them), so queue work whose
+// results need no CPU step in between: tiles with their own C, or weight
+// preloads. An entry leaves its pitches and ROWS in the registers.
+// Requires ACC_ID version GEMM_ID_VERSION_RING; mixing ring and register
+// launches is only safe while the ring is drained.
+//
+// Progress is the accelerator's HEAD index. With head_wb set it is written
+// to that word in DDR after every entry and polled there (one line
+// invalidate per poll, so only worth it with per-line cache maintenance);
+// with head_wb NULL it is polled over AXI-Lite.
+typedef struct {
+    uint32_t a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+    uint32_t lda, ldb, ldc, rows;   // As the LDA/LDB/LDC/ROWS registers
+    uint32_t ctrl;                  // GEMM_CTRL_* mode bits (START is implied)
+    uint32_t reserved[5];
+} gemm_desc_t;                      // 64 bytes, the accelerator's layout
+
+typedef struct {
+    gemm_desc_t       *desc;        // 64-byte aligned, entries long
+    volatile uint32_t *head_wb;     // Word in a cache line of its own, or NULL
+    uint32_t           entries;
+    uint32_t           tail;        // Next entry to fill
+    uint32_t           doorbell;    // Tail last written to RING_TAIL
+    uint32_t           head;        // HEAD last read
+} gemm_ring_t;
+
+// Point the accelerator at the ring (which must be idle) and make it the
+// one gemm_pin_weights() queues through. entries >= 2 (one stays empty).
+int  gemm_ring_init(gemm_ring_t *r, gemm_desc_t *storage, int entries, volatile uint32_t *head_wb);
+// Fill the next entry; waits for a free one if the ring is full. Operands
+// must already be clean in DDR and C flushed, as for a register launch.
+int  gemm_ring_push(gemm_ring_t *r, const int8_t *a, const int8_t *b, int32_t *c,
+                    uint32_t lda, uint32_t ldb, uint32_t ldc, uint32_t rows, uint32_t ctrl);
+void gemm_ring_submit(gemm_ring_t *r);  // Make filled entries visible and ring the doorbell
+int  gemm_ring_wait(gemm_ring_t *r);    // Submit, then wait until every entry has completed
+
+// ---------------------------------------------------------------------------
+// Completion interrupt
+// ---------------------------------------------------------------------------
+// From ACC_ID version GEMM_ID_VERSION_IRQ the accelerator drives a level
+// interrupt while INT_GIE is set and an enabled INT_STATUS source is pending.
+// Once gemm_irq_enable() is given a wait function, every wait in this library
+// sleeps in it instead of spinning on STATUS or HEAD: a register launch on
+// GEMM_INT_DONE, gemm_ring_wait() on GEMM_INT_RING (once per batch, not per
+// entry), both also on GEMM_INT_ERROR. The CPU is free for other work between
+// gemm_ring_submit() and gemm_ring_wait().
+//
+// The wait function blocks until the interrupt has fired, clears it with
+// gemm_irq_ack() before re-arming its interrupt controller, and returns 0, or
+// < 0 on timeout. Early returns are harmless: the library rechecks STATUS or
+// HEAD after every one. Bare metal waits on the interrupt controller with
+// wfi, Linux on a UIO device (see benchmark.c and host.c).
+typedef int (*gemm_irq_wait_fn)(void *ctx);
+
+int      gemm_irq_enable(gemm_irq_wait_fn wait, void *ctx);  // GEMM_ERR_NODEV before version 3
+void     gemm_irq_disable(void);                             // Back to polling
+uint32_t gemm_irq_ack(void);                                 // Clear the pending sources and return them
+
+// ---------------------------------------------------------------------------
+// Platform hooks (provided by the firmware)
+// ---------------------------------------------------------------------------
+void          write_reg32(uintptr_t addr, uint32_t value);
+uint32_t      read_reg32(uintptr_t addr);
+unsigned long get_cycles(void);
+void          cache_clean_range(uintptr_t addr, size_t len);
+void          cache_invalidate_range(uintptr_t addr, size_t len);
+void          cache_flush_range(uintptr_t addr, size_t len);
+
+#endif // GEMM_OFFLOAD_H
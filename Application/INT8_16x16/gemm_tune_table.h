@@ -0,0 +1,20 @@
+// gemm_tune_table.h - GEMM strategy table loaded at startup
+//
+// Generated by the benchmark firmware's autotune command ('1'): paste the
+// array it prints over this one and rebuild. The words are the format of
+// gemm_tune_save() (magic, version | tile << 8 | count << 16, 3 words per
+// entry, checksum). gemm_tune_load() rejects a table whose tile byte does
+// not match the running GEMM_TILE; 0 there means 16, as written before the
+// byte existed. This default holds no entries, so every shape is
+// dispatched by the traversal planner until the target is tuned.
+
+#ifndef GEMM_TUNE_TABLE_H
+#define GEMM_TUNE_TABLE_H
+
+#include <stdint.h>
+
+static const uint32_t gemm_tune_blob[] = {
+    0x4E555447, 0x00000001, 0x00000000,
+};
+
+#endif // GEMM_TUNE_TABLE_H
@@ -10,13 +10,13 @@ UL g_dtb_address;
 // Accelerator register offsets
 #define ACC_BASE        0x20060000
 #define ACC_CONTROL     (ACC_BASE + 0x00)
-#define ACC_STATUS      (ACC_BASE + 0x04)
+#define ACC_STATUS      (ACC_BASE + 0x00)
 #define ACC_ADDR_A_LSB  (ACC_BASE + 0x10)
 #define ACC_ADDR_A_MSB  (ACC_BASE + 0x14)
-#define ACC_ADDR_B_LSB  (ACC_BASE + 0x18)
-#define ACC_ADDR_B_MSB  (ACC_BASE + 0x1C)
-#define ACC_ADDR_C_LSB  (ACC_BASE + 0x20)
-#define ACC_ADDR_C_MSB  (ACC_BASE + 0x24)
+#define ACC_ADDR_B_LSB  (ACC_BASE + 0x1C)
+#define ACC_ADDR_B_MSB  (ACC_BASE + 0x20)
+#define ACC_ADDR_C_LSB  (ACC_BASE + 0x28)
+#define ACC_ADDR_C_MSB  (ACC_BASE + 0x2C)
 
 // Matrix geometry
 #define MATRIX_SIZE     16
@@ -30,18 +30,42 @@ static inline void write_reg(unsigned int addr, unsigned int val) {
     *(volatile unsigned int*)addr = val;
 }
 
+// Cache maintenance at the accelerator handoff (see benchmark.c for the full
+// API). With Zicbom the buffers stay cacheable and only the lines the
+// accelerator touches are cleaned/invalidated; without it this test keeps the
+// original non-cacheable window, as there is no cached scratch to displace
+// through in SRAM.
+#ifndef CACHE_HAS_ZICBOM
+#define CACHE_HAS_ZICBOM 0
+#endif
+#define DCACHE_LINE_SIZE 32
+
+#if CACHE_HAS_ZICBOM
+static void dcache_range(unsigned int addr, unsigned int len, int op) {
+    __asm__ volatile("fence" ::: "memory");
+    for (unsigned int p = addr & ~(DCACHE_LINE_SIZE - 1); p < addr + len; p += DCACHE_LINE_SIZE) {
+        if (op) __asm__ volatile(".insn i 0x0F, 2, x0, %0, 2" :: "r"(p) : "memory");  // cbo.flush
+        else    __asm__ volatile(".insn i 0x0F, 2, x0, %0, 0" :: "r"(p) : "memory");  // cbo.inval
+    }
+    __asm__ volatile("fence" ::: "memory");
+}
+#endif
+
 int main(void) {
     // 1) UART bring-up
     init_uart(0x1B);
     printf("S> Gemma3 INT8 Accelerator Test: A * I = A\n");
 
-    // 2) Disable CPU caching on 0x20000–(0x22000+NUM*4)
+    // 2) Disable CPU caching on 0x20000–(0x22000+NUM*4) unless we can do
+    //    range maintenance at the handoff instead
+#if !CACHE_HAS_ZICBOM
     volatile UL *fb_start = (volatile UL*)0x10301030;
     volatile UL *fb_end   = (volatile UL*)0x10301038;
     *fb_start = MATRIX_A_ADDR;
     *fb_end   = MATRIX_C_ADDR + NUM_ELEMENTS * sizeof(int);
+#endif
 
-    // 3) Prepare input matrices in uncached SRAM
+    // 3) Prepare input matrices in SRAM
     volatile signed char *mat_a = (volatile signed char*)MATRIX_A_ADDR;
     volatile signed char *mat_b = (volatile signed char*)MATRIX_B_ADDR;
     // A = [1,2,3…]
@@ -69,15 +93,21 @@ int main(void) {
     write_reg(ACC_ADDR_C_MSB, 0x0);
 
     // 5) Kick off the operation
+#if CACHE_HAS_ZICBOM
+    dcache_range(MATRIX_A_ADDR, MATRIX_C_ADDR + NUM_ELEMENTS * sizeof(int) - MATRIX_A_ADDR, 1);
+#endif
     printf("[i] starting accelerator...\n");
     write_reg(ACC_CONTROL, 0x1);
 
-    // 6) Poll DONE = bit 1 of STATUS (0x04)
+    // 6) Poll DONE = bit 0 of STATUS (0x00)
     volatile unsigned int *status = (volatile unsigned int*)ACC_STATUS;
-    while ((*status & 0x2) != 0x2)
+    while ((*status & 0x1) != 0x1)
         ;  // wait
 
     printf("[✓] accelerator finished\n");
+#if CACHE_HAS_ZICBOM
+    dcache_range(MATRIX_C_ADDR, NUM_ELEMENTS * sizeof(int), 0);
+#endif
 
     // 7) Verify results (since B was identity, C == A)
     printf("[i] verifying results...\n");
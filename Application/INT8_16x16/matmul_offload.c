@@ -40,6 +40,12 @@ int rand(void) {
 #define LOG_PERF(fmt, ...) printf("[PERF] " fmt "\n\r", ##__VA_ARGS__)
 #define LOG_VERIFY(fmt, ...) printf("[VERIFY] " fmt "\n\r", ##__VA_ARGS__)
 
+// Structured benchmark records: one "[REC]" line per timed sample so that
+// UART captures of two runs can be compared offline with perf_compare.c
+#define LOG_REC(fmt, ...) printf("[REC] " fmt "\n\r", ##__VA_ARGS__)
+#define REC_FORMAT_VERSION 1
+#define BENCH_SAMPLES 8  // Timed samples per test case (first one is verified)
+
 // Memory configuration
 #define MATRIX_SIZE 16
 #define MATRIX_ELEMENTS (MATRIX_SIZE * MATRIX_SIZE)
@@ -69,6 +75,8 @@ int rand(void) {
 #define ACC_START_BIT   0x1
 #define ACC_DONE_BIT    0x1  
 #define ACC_BUSY_BIT    0x2  // Busy might be bit 1, not bit 0
+#define ACC_ERROR_BIT   0x4  // Sticky AXI error (non-OKAY RRESP/BRESP), valid with DONE
+#define ACC_RESULT_UNWRITTEN ((int32_t)0xDEADBEEF)  // C fill before a run; outside the INT8 product range
 
 // Performance tracking
 typedef struct {
@@ -91,6 +99,8 @@ uint32_t read_reg32(uintptr_t addr) {
     return *((volatile uint32_t*)addr);
 }
 
+// DONE is raised only after the final write response (S_WAIT_WRITE_END in the
+// RTL), so one fence between the STATUS load and the result loads is enough
 void force_memory_sync(void) {
     asm volatile("fence" ::: "memory");
 }
@@ -223,9 +233,10 @@ int accelerator_matrix_multiply(int8_t* a, int8_t* b, int32_t* c) {
     
     force_memory_sync();
     
-    // Clear result matrix first to ensure clean state
+    // Fill C with a value no 16x16 INT8 product can produce (|c| <= 2^18), so
+    // the check below only sees this run's writes and zero stays a valid result
     for (int i = 0; i < MATRIX_ELEMENTS; i++) {
-        c[i] = 0;
+        c[i] = ACC_RESULT_UNWRITTEN;
     }
     force_memory_sync();
     
@@ -246,13 +257,6 @@ int accelerator_matrix_multiply(int8_t* a, int8_t* b, int32_t* c) {
         LOG_DEBUG("Accelerator idle (checking correct busy bit)");
     }
     
-    // Clear result matrix before computation to detect new writes
-    LOG_DEBUG("Clearing result matrix before computation");
-    for (int i = 0; i < MATRIX_ELEMENTS; i++) {
-        c[i] = 0;  // Use 0 instead of -999 to avoid confusion
-    }
-    force_memory_sync();
-    
     // Configure accelerator with debug info - try original main area first
     LOG_DEBUG("Setting matrix addresses: A=0x%08lx, B=0x%08lx, C=0x%08lx (main area)", 
              (unsigned long)a, (unsigned long)b, (unsigned long)c);
@@ -277,12 +281,6 @@ int accelerator_matrix_multiply(int8_t* a, int8_t* b, int32_t* c) {
     LOG_DEBUG("Verified addresses: A=0x%08lx, B=0x%08lx, C=0x%08lx (main area)", 
              (unsigned long)read_a, (unsigned long)read_b, (unsigned long)read_c);
     
-    // Clear main result area
-    for (int i = 0; i < MATRIX_ELEMENTS; i++) {
-        c[i] = 0;
-    }
-    force_memory_sync();
-    
     // Start computation
     LOG_DEBUG("Starting computation with start bit");
     write_reg32(ACC_CTRL_STATUS, ACC_START_BIT);  // Start bit
@@ -358,94 +356,32 @@ int accelerator_matrix_multiply(int8_t* a, int8_t* b, int32_t* c) {
         }
     }
     
-    // Force memory sync to ensure results are visible
+    // Results are in memory once DONE reads back set; order the loads after it
     force_memory_sync();
     
-    // Give extra time for memory writes to complete
-    for (volatile int i = 0; i < 10000; i++);
-    force_memory_sync();
-    
-    // Check if we got any results by examining multiple areas
-    LOG_DEBUG("Checking for accelerator results...");
-    
-    int non_zero_count = 0;
-    int valid_results = 0;
-    
-    // First check main result area
-    LOG_DEBUG("Checking main result area first...");
-    
-    for (int i = 0; i < MATRIX_ELEMENTS && non_zero_count < 20; i++) {
-        if (c[i] != 0) {
-            non_zero_count++;
-            // Check if this could be a valid matrix multiplication result
-            if (abs(c[i]) < 100000) {  // Reasonable range for our test data
-                valid_results++;
-            }
-            if (non_zero_count <= 10) {
-                LOG_DEBUG("Result found in main area[%d]: %ld", i, (long)c[i]);
-            }
-        }
+    if (status & ACC_ERROR_BIT) {
+        LOG_ERROR("Accelerator reported an AXI error response (status 0x%08lx)", (unsigned long)status);
+        return -1;  // Results of a faulted run are not trusted
     }
     
-    // If no results in main area, check CPU area as backup
-    if (non_zero_count == 0) {
-        LOG_DEBUG("No results in main area, checking CPU area as backup...");
-        int32_t* alt_c = get_matrix_c_cpu(0);
-        
-        for (int i = 0; i < MATRIX_ELEMENTS && non_zero_count < 20; i++) {
-            if (alt_c[i] != 0) {
-                non_zero_count++;
-                if (abs(alt_c[i]) < 100000) {
-                    valid_results++;
-                }
-                if (non_zero_count <= 10) {
-                    LOG_DEBUG("Result found in CPU area[%d]: %ld", i, (long)alt_c[i]);
-                }
-            }
-        }
-        
-        // If found results in CPU area, copy them to main result area for verification
-        if (non_zero_count > 0) {
-            LOG_DEBUG("Copying %d results from CPU area to main area for verification", non_zero_count);
-            for (int i = 0; i < MATRIX_ELEMENTS; i++) {
-                c[i] = alt_c[i];
+    // Every element must have been written; its value is checked against the
+    // CPU reference by the caller
+    int unwritten = 0;
+    for (int i = 0; i < MATRIX_ELEMENTS; i++) {
+        if (c[i] == ACC_RESULT_UNWRITTEN) {
+            if (unwritten < 5) {
+                LOG_DEBUG("Result [%d,%d] not written", i / MATRIX_SIZE, i % MATRIX_SIZE);
             }
-            force_memory_sync();
-            LOG_DEBUG("Accelerator computed results successfully in CPU area");
-            return 0;  // Success
+            unwritten++;
         }
-    } else {
-        LOG_DEBUG("Accelerator computed results successfully in main area");
-        return 0;  // Success
     }
-    
-    LOG_DEBUG("Found %d non-zero results, %d appear valid", non_zero_count, valid_results);
-    
-    if (non_zero_count > 0) {
-        LOG_DEBUG("Accelerator computed some results - operation successful");
-        return 0;
-    } else {
-        LOG_DEBUG("No results detected - checking if accelerator wrote anything at all...");
-        
-        // Check entire memory region for any changes
-        int total_checked = 0;
-        for (int i = 0; i < MATRIX_ELEMENTS * 4 && total_checked < 1000; i++) {
-            int8_t* check_ptr = (int8_t*)c + i;
-            if (*check_ptr != 0) {
-                LOG_DEBUG("Found non-zero byte at offset %d: 0x%02x", i, (unsigned char)*check_ptr);
-                total_checked++;
-                if (total_checked >= 5) break;
-            }
-        }
-        
-        if (total_checked > 0) {
-            LOG_DEBUG("Accelerator wrote some data but not in expected format");
-        } else {
-            LOG_DEBUG("Accelerator did not write any data to result matrix");
-        }
-        
-        return 0;  // Still return success to allow verification to catch issues
+    if (unwritten > 0) {
+        LOG_ERROR("Accelerator left %d of %d results unwritten", unwritten, MATRIX_ELEMENTS);
+        return -1;
     }
+
+    LOG_DEBUG("Accelerator wrote all %d results", MATRIX_ELEMENTS);
+    return 0;
 }
 
 // Verification function with improved matrix layout handling
@@ -464,33 +400,8 @@ int verify_results(int32_t* cpu_result, int32_t* acc_result, int* max_error, dou
         return 0;
     }
     
-    // Sanity check: detect if both matrices are all zeros (likely indicates computation failure)
-    int cpu_nonzero = 0, acc_nonzero = 0;
-    for (int i = 0; i < MATRIX_ELEMENTS && (cpu_nonzero < 5 || acc_nonzero < 5); i++) {
-        if (cpu_result[i] != 0) cpu_nonzero++;
-        if (acc_result[i] != 0) acc_nonzero++;
-    }
-    
-    if (cpu_nonzero == 0 && acc_nonzero == 0) {
-        LOG_VERIFY("⚠️ WARNING: Both CPU and accelerator results are all zeros - likely computation failure");
-        *max_error = 0;
-        *avg_error = 0.0;
-        return 0;  // Fail verification for all-zero case
-    } else if (cpu_nonzero == 0) {
-        LOG_VERIFY("⚠️ WARNING: CPU result is all zeros - CPU computation issue");
-        *max_error = -1;
-        *avg_error = -1.0;
-        return 0;
-    } else if (acc_nonzero == 0) {
-        LOG_VERIFY("⚠️ WARNING: Accelerator result is all zeros - accelerator not computing");
-        *max_error = -1;
-        *avg_error = -1.0;
-        return 0;
-    }
-    
-    LOG_DEBUG("Sanity check passed: CPU has %d non-zero elements, ACC has %d non-zero elements", 
-             cpu_nonzero, acc_nonzero);
-    
+    // No all-zero rejection: zero operands give an all-zero product, and an
+    // accelerator that wrote nothing is caught by accelerator_matrix_multiply()
     // First, try to detect if accelerator is using different matrix layout
     LOG_DEBUG("Analyzing accelerator result pattern...");
     
@@ -647,6 +558,47 @@ performance_result_t benchmark_matrix_multiply(int test_id, int pattern_a, int p
     return result;
 }
 
+// Emit the timed samples for one test case as [REC] lines.
+// Sample 0 is the run from benchmark_matrix_multiply(), whose results are
+// still in the C buffers; the remaining samples re-time CPU and accelerator on
+// the same operands. Every sample is checked with the same exact element
+// compare, not the lenient verify_results() acceptance, so a record only says
+// PASS when the accelerator result is bit-exact.
+void record_benchmark_samples(int test_id, const char* description, const performance_result_t* first) {
+    int8_t* matrix_a = get_matrix_a(0);
+    int8_t* matrix_b = get_matrix_b(0);
+    int32_t* matrix_c_acc = get_matrix_c(0);
+    int32_t* matrix_c_cpu = get_matrix_c_cpu(0);
+
+    int first_pass = first->verification_passed &&
+                     (memcmp(matrix_c_cpu, matrix_c_acc, MATRIX_ELEMENTS * sizeof(int32_t)) == 0);
+
+    LOG_REC("v%d,gemm,%d,%s,%d,%d,%d,%d,%lu,%lu,%s", REC_FORMAT_VERSION,
+            test_id, description, MATRIX_SIZE, MATRIX_SIZE, MATRIX_SIZE, 0,
+            first->cpu_cycles, first->acc_cycles, first_pass ? "PASS" : "FAIL");
+
+    if (!first_pass) {
+        return;  // No point re-timing a broken configuration
+    }
+
+    for (int s = 1; s < BENCH_SAMPLES; s++) {
+        unsigned long cpu_start = get_cycles();
+        cpu_matrix_multiply(matrix_a, matrix_b, matrix_c_cpu);
+        unsigned long cpu_cycles = get_cycles() - cpu_start;
+
+        unsigned long acc_start = get_cycles();
+        int acc_status = accelerator_matrix_multiply(matrix_a, matrix_b, matrix_c_acc);
+        unsigned long acc_cycles = get_cycles() - acc_start;
+
+        int pass = (acc_status == 0) &&
+                   (memcmp(matrix_c_cpu, matrix_c_acc, MATRIX_ELEMENTS * sizeof(int32_t)) == 0);
+
+        LOG_REC("v%d,gemm,%d,%s,%d,%d,%d,%d,%lu,%lu,%s", REC_FORMAT_VERSION,
+                test_id, description, MATRIX_SIZE, MATRIX_SIZE, MATRIX_SIZE, s,
+                cpu_cycles, acc_cycles, pass ? "PASS" : "FAIL");
+    }
+}
+
 // Matrix content display (for debugging)
 void print_matrix_sample(int32_t* matrix, const char* name) {
     LOG_DEBUG("%s matrix sample (top-left 4x4):", name);
@@ -685,6 +637,8 @@ void run_comprehensive_tests(void) {
         {3, 2, "Incremental x Small Random"}   // Incremental × Small Random
     };
     
+    LOG_REC("v%d,kind,id,case,m,n,k,sample,cpu_cycles,acc_cycles,verify", REC_FORMAT_VERSION);
+    
     // Run all tests with proper error handling
     for (int i = 0; i < total_tests; i++) {
         LOG_INFO("Starting test %d...", i + 1);
@@ -701,6 +655,8 @@ void run_comprehensive_tests(void) {
                                              test_cases[i].pattern_a, 
                                              test_cases[i].pattern_b);
         
+        record_benchmark_samples(i + 1, test_cases[i].description, &results[i]);
+        
         if (results[i].verification_passed) {
             passed_tests++;
         }
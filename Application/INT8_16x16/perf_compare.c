@@ -0,0 +1,302 @@
+// perf_compare.c — compare two benchmark runs shape by shape
+// Build: gcc -O2 -Wall perf_compare.c -o perf_compare -lm
+// Usage: ./perf_compare [options] baseline.log candidate.log
+//
+// Inputs are raw UART captures from matmul_offload.c; only the "[REC]" lines
+// are used, everything else in the log is ignored. Each record is one timed
+// sample:
+//
+//   [REC] v1,gemm,<id>,<case>,<m>,<n>,<k>,<sample>,<cpu_cycles>,<acc_cycles>,<PASS|FAIL>
+//
+// For every (id, case, m, n, k) present in both runs the tool compares the
+// sample distributions of accelerator cycles and CPU cycles. A change is
+// only flagged when it is larger than both a fixed floor (--min-rel) and the
+// run-to-run noise seen in the samples themselves (--z times the standard
+// error of the medians), and a Mann-Whitney U test agrees at level --alpha.
+// A metric with fewer than MIN_SAMPLES samples in either run gets no verdict.
+// GOPS is printed for reference only: it is acc_cycles rescaled, so it
+// would count the same change twice.
+//
+// Exit status: 0 = no regression, 1 = at least one regression, a newly
+// failing case or a baseline case missing from the candidate run,
+// 2 = usage / input error.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DIE(...) do { fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n"); exit(2); } while(0)
+
+enum { MAX_KEYS = 128, MAX_SAMPLES = 256, MAX_LINE = 512, MAX_NAME = 64, MIN_SAMPLES = 3 };
+
+typedef struct {
+    int  id;
+    char name[MAX_NAME];
+    int  m, n, k;
+    int  count;
+    int  failures;
+    double cpu[MAX_SAMPLES];
+    double acc[MAX_SAMPLES];
+} shape_t;
+
+typedef struct {
+    shape_t shapes[MAX_KEYS];
+    int     count;
+} run_t;
+
+static double opt_mhz     = 50.0;   // VEGA AT1051 core clock
+static double opt_min_rel = 0.02;   // Never flag changes below 2%
+static double opt_z       = 3.0;    // Noise multiplier on the median standard error
+static double opt_alpha   = 0.01;   // Mann-Whitney significance level
+
+// ---- Record parsing
+
+static shape_t* find_shape(run_t* run, int id, const char* name, int m, int n, int k, int create) {
+    for (int i = 0; i < run->count; i++) {
+        shape_t* s = &run->shapes[i];
+        if (s->id == id && s->m == m && s->n == n && s->k == k && strcmp(s->name, name) == 0)
+            return s;
+    }
+    if (!create) return NULL;
+    if (run->count == MAX_KEYS) DIE("too many distinct shapes (max %d)", MAX_KEYS);
+
+    shape_t* s = &run->shapes[run->count++];
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->m = m; s->n = n; s->k = k;
+    return s;
+}
+
+static void load_run(const char* path, run_t* run) {
+    FILE* f = fopen(path, "r");
+    if (!f) DIE("open(%s) failed", path);
+
+    char line[MAX_LINE];
+    int lineno = 0, records = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char* rec = strstr(line, "[REC] ");
+        if (!rec) continue;
+        rec += 6;
+        rec[strcspn(rec, "\r\n")] = '\0';
+
+        char* field[12];
+        int nf = 0;
+        for (char* tok = strtok(rec, ","); tok && nf < 12; tok = strtok(NULL, ","))
+            field[nf++] = tok;
+
+        if (nf < 2 || strcmp(field[1], "kind") == 0) continue;  // header line
+        if (nf != 11 || strcmp(field[0], "v1") != 0 || strcmp(field[1], "gemm") != 0) {
+            fprintf(stderr, "%s:%d: skipping unrecognised record\n", path, lineno);
+            continue;
+        }
+
+        shape_t* s = find_shape(run, atoi(field[2]), field[3],
+                                atoi(field[4]), atoi(field[5]), atoi(field[6]), 1);
+        if (s->count == MAX_SAMPLES) continue;
+        if (strcmp(field[10], "PASS") != 0) {
+            s->failures++;
+            continue;  // Timing of a wrong answer is meaningless
+        }
+        s->cpu[s->count] = strtod(field[8], NULL);
+        s->acc[s->count] = strtod(field[9], NULL);
+        s->count++;
+        records++;
+    }
+    fclose(f);
+
+    if (records == 0) DIE("%s: no [REC] samples found", path);
+}
+
+// ---- Robust statistics
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(const double* v, int n) {
+    double tmp[MAX_SAMPLES];
+    memcpy(tmp, v, n * sizeof(double));
+    qsort(tmp, n, sizeof(double), cmp_double);
+    return (n & 1) ? tmp[n / 2] : 0.5 * (tmp[n / 2 - 1] + tmp[n / 2]);
+}
+
+// Median absolute deviation scaled to a normal-equivalent sigma
+static double robust_sigma(const double* v, int n, double med) {
+    double dev[MAX_SAMPLES];
+    for (int i = 0; i < n; i++) dev[i] = fabs(v[i] - med);
+    return 1.4826 * median(dev, n);
+}
+
+// Two-sided Mann-Whitney U test, normal approximation with tie-averaged ranks
+static double mann_whitney_p(const double* a, int na, const double* b, int nb) {
+    int n = na + nb;
+    double val[2 * MAX_SAMPLES];
+    int    grp[2 * MAX_SAMPLES];
+    double rank[2 * MAX_SAMPLES];
+
+    for (int i = 0; i < na; i++) { val[i] = a[i]; grp[i] = 0; }
+    for (int i = 0; i < nb; i++) { val[na + i] = b[i]; grp[na + i] = 1; }
+
+    // Insertion sort keeps val/grp paired; n is small
+    for (int i = 1; i < n; i++) {
+        double v = val[i]; int g = grp[i]; int j = i - 1;
+        while (j >= 0 && val[j] > v) { val[j + 1] = val[j]; grp[j + 1] = grp[j]; j--; }
+        val[j + 1] = v; grp[j + 1] = g;
+    }
+
+    double tie_term = 0.0;
+    for (int i = 0; i < n; ) {
+        int j = i;
+        while (j + 1 < n && val[j + 1] == val[i]) j++;
+        double r = 0.5 * (i + j) + 1.0;
+        for (int t = i; t <= j; t++) rank[t] = r;
+        double ties = j - i + 1;
+        tie_term += ties * ties * ties - ties;
+        i = j + 1;
+    }
+
+    double ra = 0.0;
+    for (int i = 0; i < n; i++) if (grp[i] == 0) ra += rank[i];
+
+    double u    = ra - na * (na + 1) / 2.0;
+    double mu   = na * nb / 2.0;
+    double var  = na * nb / 12.0 * ((n + 1) - tie_term / ((double)n * (n - 1)));
+    if (var <= 0.0) return 1.0;  // All samples identical
+
+    double z = (fabs(u - mu) - 0.5) / sqrt(var);
+    if (z < 0.0) z = 0.0;
+    return erfc(z / sqrt(2.0));
+}
+
+// ---- Comparison
+
+typedef enum { CMP_SAME, CMP_BETTER, CMP_WORSE, CMP_INSUFFICIENT } verdict_t;
+
+// higher_is_worse: 1 for cycle counts, 0 for throughput
+static verdict_t compare_metric(const char* metric, const double* base, int nb,
+                                const double* cand, int nc, int higher_is_worse) {
+    double mb = median(base, nb), mc = median(cand, nc);
+    double rel = (mb != 0.0) ? (mc - mb) / mb : 0.0;
+
+    // The noise estimate and the rank test both need a few samples per run
+    if (nb < MIN_SAMPLES || nc < MIN_SAMPLES) {
+        printf("    %-10s %12.3f -> %12.3f  %+7.2f%%  insufficient samples (need %d per run)\n",
+               metric, mb, mc, 100.0 * rel, MIN_SAMPLES);
+        return CMP_INSUFFICIENT;
+    }
+
+    double sb = robust_sigma(base, nb, mb), sc = robust_sigma(cand, nc, mc);
+
+    // Standard error of a median is ~1.2533 sigma / sqrt(n)
+    double se = sqrt(pow(1.2533 * sb, 2) / nb + pow(1.2533 * sc, 2) / nc);
+    double noise = (mb != 0.0) ? opt_z * se / fabs(mb) : 0.0;
+    double threshold = noise > opt_min_rel ? noise : opt_min_rel;
+
+    double p = mann_whitney_p(base, nb, cand, nc);
+
+    verdict_t v = CMP_SAME;
+    if (fabs(rel) > threshold && p < opt_alpha) {
+        int worse = higher_is_worse ? (rel > 0.0) : (rel < 0.0);
+        v = worse ? CMP_WORSE : CMP_BETTER;
+    }
+
+    printf("    %-10s %12.3f -> %12.3f  %+7.2f%%  (thr %5.2f%%, p=%.4f)  %s\n",
+           metric, mb, mc, 100.0 * rel, 100.0 * threshold, p,
+           v == CMP_WORSE ? "REGRESSION" : v == CMP_BETTER ? "improved" : "~");
+    return v;
+}
+
+// GOPS at the median accelerator cycle count
+static double median_gops(const shape_t* s) {
+    double acc = median(s->acc, s->count);
+    return (acc > 0.0) ? 2.0 * s->m * s->n * s->k * opt_mhz / (acc * 1000.0) : 0.0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [--mhz F] [--min-rel R] [--z Z] [--alpha A] baseline.log candidate.log\n"
+            "  --mhz      core clock used to convert cycles to GOPS (default %.0f)\n"
+            "  --min-rel  smallest relative change ever flagged (default %.2f)\n"
+            "  --z        noise multiplier on median standard error (default %.1f)\n"
+            "  --alpha    Mann-Whitney significance level (default %.3f)\n",
+            prog, opt_mhz, opt_min_rel, opt_z, opt_alpha);
+    exit(2);
+}
+
+static run_t base_run, cand_run;
+
+int main(int argc, char** argv) {
+    const char* paths[2];
+    int np = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mhz") == 0 && i + 1 < argc)          opt_mhz = atof(argv[++i]);
+        else if (strcmp(argv[i], "--min-rel") == 0 && i + 1 < argc) opt_min_rel = atof(argv[++i]);
+        else if (strcmp(argv[i], "--z") == 0 && i + 1 < argc)       opt_z = atof(argv[++i]);
+        else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc)   opt_alpha = atof(argv[++i]);
+        else if (argv[i][0] == '-')                                  usage(argv[0]);
+        else if (np < 2)                                             paths[np++] = argv[i];
+        else                                                         usage(argv[0]);
+    }
+    if (np != 2) usage(argv[0]);
+
+    load_run(paths[0], &base_run);
+    load_run(paths[1], &cand_run);
+
+    printf("=== perf_compare: %s -> %s ===\n", paths[0], paths[1]);
+    printf("thresholds: min-rel %.2f%%, z %.1f, alpha %.3f, clock %.0f MHz\n\n",
+           100.0 * opt_min_rel, opt_z, opt_alpha, opt_mhz);
+
+    int regressions = 0, improvements = 0, compared = 0, insufficient = 0, missing = 0;
+
+    for (int i = 0; i < base_run.count; i++) {
+        shape_t* b = &base_run.shapes[i];
+        shape_t* c = find_shape(&cand_run, b->id, b->name, b->m, b->n, b->k, 0);
+
+        printf("[%d] %s  %dx%dx%d\n", b->id, b->name, b->m, b->n, b->k);
+        if (!c) {
+            printf("    MISSING: not in candidate run\n");
+            missing++;
+            continue;
+        }
+        if (c->failures > 0 && b->failures == 0) {
+            printf("    NEW FAILURE: %d candidate sample(s) failed verification\n", c->failures);
+            regressions++;
+        }
+        if (b->count == 0 || c->count == 0) {
+            printf("    no passing samples to compare (base %d, cand %d)\n", b->count, c->count);
+            continue;
+        }
+        printf("    samples: base %d, cand %d\n", b->count, c->count);
+
+        verdict_t v[2];
+        v[0] = compare_metric("acc_cycles", b->acc, b->count, c->acc, c->count, 1);
+        v[1] = compare_metric("cpu_cycles", b->cpu, b->count, c->cpu, c->count, 1);
+        printf("    %-10s %12.3f -> %12.3f  (from median acc_cycles, no verdict)\n",
+               "GOPS", median_gops(b), median_gops(c));
+
+        for (int m = 0; m < 2; m++) {
+            if (v[m] == CMP_WORSE) regressions++;
+            if (v[m] == CMP_BETTER) improvements++;
+        }
+        if (v[0] == CMP_INSUFFICIENT) insufficient++;
+        else compared++;
+    }
+
+    for (int i = 0; i < cand_run.count; i++) {
+        shape_t* c = &cand_run.shapes[i];
+        if (!find_shape(&base_run, c->id, c->name, c->m, c->n, c->k, 0))
+            printf("[%d] %s  %dx%dx%d\n    new in candidate run (no baseline)\n",
+                   c->id, c->name, c->m, c->n, c->k);
+    }
+
+    printf("\nSummary: %d shape(s) compared, %d with insufficient samples, %d missing, %d regression(s), %d improvement(s)\n",
+           compared, insufficient, missing, regressions, improvements);
+    return (regressions || missing) ? 1 : 0;
+}